@@ -0,0 +1,92 @@
+// Barnes-Hut layout benchmark against the igraph 3D force-directed layouts on a
+// Barabasi-Albert graph.
+// Usage: barnes-hut-bench [node_count] [skip_igraph]
+// Quality is the mean edge length over the mean distance of random node pairs (lower
+// keeps neighbors closer relative to the layout's spread).
+#include <math.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "graph/layout_barnes_hut.h"
+
+static double edge_ratio(const igraph_t *graph, const igraph_matrix_t *layout)
+{
+	igraph_integer_t n = igraph_vcount(graph);
+	igraph_integer_t m = igraph_ecount(graph);
+	double edge_sum = 0.0, pair_sum = 0.0;
+	for (igraph_integer_t e = 0; e < m; e++) {
+		igraph_integer_t a = IGRAPH_FROM(graph, e), b = IGRAPH_TO(graph, e);
+		double dx = MATRIX(*layout, a, 0) - MATRIX(*layout, b, 0);
+		double dy = MATRIX(*layout, a, 1) - MATRIX(*layout, b, 1);
+		double dz = MATRIX(*layout, a, 2) - MATRIX(*layout, b, 2);
+		edge_sum += sqrt(dx * dx + dy * dy + dz * dz);
+	}
+	srand(7);
+	const int pairs = 100000;
+	for (int p = 0; p < pairs; p++) {
+		igraph_integer_t a = rand() % n, b = rand() % n;
+		double dx = MATRIX(*layout, a, 0) - MATRIX(*layout, b, 0);
+		double dy = MATRIX(*layout, a, 1) - MATRIX(*layout, b, 1);
+		double dz = MATRIX(*layout, a, 2) - MATRIX(*layout, b, 2);
+		pair_sum += sqrt(dx * dx + dy * dy + dz * dz);
+	}
+	return pair_sum > 0.0 ? (edge_sum / (double)m) / (pair_sum / pairs) : 0.0;
+}
+
+static void run_barnes_hut(const igraph_t *graph, igraph_matrix_t *layout)
+{
+	igraph_integer_t n = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	igraph_vector_int_init(&edges, 0);
+	igraph_get_edgelist(graph, &edges, 0);
+
+	double t0 = omp_get_wtime();
+	BarnesHutContext ctx;
+	barnes_hut_init_edges(&ctx, (uint32_t)n, &edges, NULL);
+	double t1 = omp_get_wtime();
+	while (barnes_hut_iterate(&ctx))
+		;
+	double t2 = omp_get_wtime();
+
+	for (igraph_integer_t i = 0; i < n; i++) {
+		MATRIX(*layout, i, 0) = ctx.x[i];
+		MATRIX(*layout, i, 1) = ctx.y[i];
+		MATRIX(*layout, i, 2) = ctx.z[i];
+	}
+	printf("barnes-hut: threads=%d init=%.3fs %d iterations in %.3fs = %.2f it/s cells=%d ratio=%.4f\n", ctx.num_threads, t1 - t0, ctx.iteration, t2 - t1, ctx.iteration / (t2 - t1), ctx.cell_count, edge_ratio(graph, layout));
+	barnes_hut_cleanup(&ctx);
+	igraph_vector_int_destroy(&edges);
+}
+
+int main(int argc, char **argv)
+{
+	igraph_integer_t node_count = bench_arg(argc, argv, 1, 100000);
+	int skip_igraph = (int)bench_arg(argc, argv, 2, 0);
+
+	igraph_t graph;
+	bench_barabasi_graph(&graph, node_count);
+
+	igraph_matrix_t layout;
+	igraph_matrix_init(&layout, node_count, 3);
+	run_barnes_hut(&graph, &layout);
+
+	if (!skip_igraph) {
+		// Same iteration count and settings as compute_igraph_layout_fruchterman_reingold_3d
+		double t0 = omp_get_wtime();
+		igraph_layout_fruchterman_reingold_3d(&graph, &layout, 0, BARNES_HUT_ITERATIONS, (igraph_real_t)node_count, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+		double t1 = omp_get_wtime();
+		printf("igraph fruchterman-reingold 3d: %d iterations in %.3fs ratio=%.4f\n", BARNES_HUT_ITERATIONS, t1 - t0, edge_ratio(&graph, &layout));
+
+		// Same settings as compute_igraph_layout_yifan_hu_3d
+		t0 = omp_get_wtime();
+		igraph_layout_yifan_hu_3d(&graph, &layout, 0, 500, -1.0, -1.0, 0.1, 1, 0.001, IGRAPH_QUADTREE_NORMAL, 10, 0, NULL);
+		t1 = omp_get_wtime();
+		printf("igraph yifan-hu 3d: %.3fs ratio=%.4f\n", t1 - t0, edge_ratio(&graph, &layout));
+	}
+
+	igraph_matrix_destroy(&layout);
+	igraph_destroy(&graph);
+	return 0;
+}
@@ -0,0 +1,21 @@
+#include "bench_common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+long bench_arg(int argc, char **argv, int index, long fallback)
+{
+	return argc > index ? strtol(argv[index], NULL, 10) : fallback;
+}
+
+void bench_barabasi_graph(igraph_t *graph, igraph_integer_t node_count)
+{
+	igraph_rng_seed(igraph_rng_default(), 1);
+	igraph_barabasi_game(graph, node_count, 1.0, 2, NULL, 1, 1.0, 0, IGRAPH_BARABASI_PSUMTREE, NULL);
+	bench_print_size((long long)igraph_vcount(graph), (long long)igraph_ecount(graph));
+}
+
+void bench_print_size(long long nodes, long long edges)
+{
+	printf("nodes=%lld edges=%lld\n", nodes, edges);
+}
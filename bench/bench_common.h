@@ -0,0 +1,26 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <igraph.h>
+
+// Setup shared by the layout benchmarks
+
+/**
+ * Read a positional integer argument.
+ * @param index Position in argv (1 is the first argument)
+ * @param fallback Value when the argument is missing
+ */
+long bench_arg(int argc, char **argv, int index, long fallback);
+
+/**
+ * Build the Barabasi-Albert graph the igraph comparisons run on (two edges per new node, fixed
+ * seed) and print its size.
+ * @param graph Uninitialized graph to create
+ * @param node_count Number of nodes
+ */
+void bench_barabasi_graph(igraph_t *graph, igraph_integer_t node_count);
+
+// Print the size line every benchmark starts with
+void bench_print_size(long long nodes, long long edges);
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,165 @@
+// OpenOrd throughput benchmark: iterations/sec on a synthetic sparse graph.
+// Usage: openord-bench [node_count] [iterations] [max_threads]
+// iterations 0 runs the whole schedule. With max_threads, runs once per power-of-two
+// thread count up to it. Times openord_iterate, as the layout thread runs it; the per-frame
+// projection onto the graph is timed separately. Also compares a neighbor lookup through
+// igraph_neighbors, as OpenOrd did before it cached the adjacency, with a CSR row walk.
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_common.h"
+#include "graph/layout_openord.h"
+
+// Preferential-attachment-like graph: each node links to two earlier endpoints. Built directly as
+// GraphData, since OpenOrd runs on the app's node and edge arrays rather than an igraph graph.
+static void build_graph(GraphData *data, uint32_t node_count)
+{
+	memset(data, 0, sizeof(GraphData));
+	data->node_count = node_count;
+	data->edge_count = node_count > 1 ? (node_count - 1) * 2 : 0;
+	data->nodes = calloc(node_count, sizeof(Node));
+	data->edges = calloc(data->edge_count + 1, sizeof(Edge));
+
+	srand(1);
+	uint32_t e = 0;
+	for (uint32_t i = 1; i < node_count; i++) {
+		for (int k = 0; k < 2; k++) {
+			// Picking an endpoint of an existing edge biases towards high degree
+			uint32_t target = (e > 0 && (rand() & 1)) ? data->edges[rand() % e].from : (uint32_t)(rand() % i);
+			data->edges[e].from = i;
+			data->edges[e].to = target;
+			data->edges[e].size = 1.0f;
+			e++;
+		}
+	}
+	for (uint32_t i = 0; i < node_count; i++) {
+		for (int d = 0; d < 3; d++)
+			data->nodes[i].position[d] = ((float)rand() / RAND_MAX - 0.5f) * 1000.0f;
+		data->nodes[i].size = 1.0f;
+	}
+	igraph_matrix_init(&data->current_layout, node_count, 3);
+}
+
+// Neighbor lookups over every node: igraph_neighbors into a fresh vector per call, as the
+// energy and centroid functions did, against the level-0 rows of OpenOrd's CSR
+static void compare_neighbor_lookups(GraphData *data)
+{
+	igraph_t graph;
+	igraph_vector_int_t edges;
+	igraph_vector_int_init(&edges, 2 * (igraph_integer_t)data->edge_count);
+	for (uint32_t e = 0; e < data->edge_count; e++) {
+		VECTOR(edges)[2 * e] = data->edges[e].from;
+		VECTOR(edges)[2 * e + 1] = data->edges[e].to;
+	}
+	igraph_create(&graph, &edges, data->node_count, IGRAPH_UNDIRECTED);
+	igraph_vector_int_destroy(&edges);
+
+	OpenOrdContext ctx;
+	openord_init(&ctx, data, 0);
+	const OpenOrdLevel *level = &ctx.levels[0];
+
+	long long igraph_sum = 0, csr_sum = 0;
+	double t0 = omp_get_wtime();
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		igraph_vector_int_t neighbors;
+		igraph_vector_int_init(&neighbors, 0);
+		igraph_neighbors(&graph, &neighbors, i, IGRAPH_ALL, IGRAPH_NO_LOOPS, 1);
+		for (igraph_integer_t k = 0; k < igraph_vector_int_size(&neighbors); k++)
+			igraph_sum += VECTOR(neighbors)[k];
+		igraph_vector_int_destroy(&neighbors);
+	}
+	double t1 = omp_get_wtime();
+	for (uint32_t i = 0; i < level->node_count; i++)
+		for (int k = level->adj_offsets[i]; k < level->adj_offsets[i + 1]; k++)
+			csr_sum += level->adj_neighbors[k];
+	double t2 = omp_get_wtime();
+
+	// Both skip self-loops, so the sums agree
+	printf("neighbor lookup: igraph_neighbors %.1f ns/node, CSR %.1f ns/node%s\n", (t1 - t0) * 1e9 / data->node_count, (t2 - t1) * 1e9 / data->node_count, igraph_sum == csr_sum ? "" : " (neighbor sets differ)");
+	openord_cleanup(&ctx);
+	igraph_destroy(&graph);
+}
+
+static void run(GraphData *data, int iterations)
+{
+	OpenOrdContext ctx;
+	double t0 = omp_get_wtime();
+	openord_init(&ctx, data, 0);
+	double t1 = omp_get_wtime();
+
+	printf("levels=%d:", ctx.level_count);
+	for (int l = 0; l < ctx.level_count; l++)
+		printf(" %u", ctx.levels[l].node_count);
+	printf("\n");
+
+	// What openord_step adds to each iteration: projecting the coarsest level onto the input graph
+	vec3 *positions = malloc(sizeof(vec3) * data->node_count);
+	openord_get_positions(&ctx, positions);
+	free(positions);
+	double t2 = omp_get_wtime();
+
+	int done = 0;
+	for (; iterations <= 0 || done < iterations; done++)
+		if (!openord_iterate(&ctx))
+			break;
+	double t3 = omp_get_wtime();
+
+	// Positions don't depend on the thread count, so every run should print the same checksum
+	positions = malloc(sizeof(vec3) * data->node_count);
+	openord_get_positions(&ctx, positions);
+	double checksum = 0.0;
+	for (uint32_t i = 0; i < data->node_count; i++)
+		checksum += positions[i][0] + 2.0 * positions[i][1] + 3.0 * positions[i][2];
+
+	// Layout quality: mean edge length over the mean distance between node pairs (lower is tighter)
+	double edge_length = 0.0, pair_distance = 0.0;
+	for (uint32_t e = 0; e < data->edge_count; e++)
+		edge_length += glm_vec3_distance(positions[data->edges[e].from], positions[data->edges[e].to]);
+	for (uint32_t s = 0; s < data->edge_count; s++)
+		pair_distance += glm_vec3_distance(positions[(s * 2654435761u) % data->node_count], positions[(s * 40503u + 1) % data->node_count]);
+	free(positions);
+
+	printf("threads=%d grid=%d bricks=%d init=%.3fs iterate: %d iterations in %.3fs = %.2f it/s\n", ctx.num_threads, ctx.grid_size, ctx.brick_count, t1 - t0, done, t3 - t2, done / (t3 - t2));
+	printf("projection to input: %.1f ms, layout checksum %.6e\n", (t2 - t1) * 1000.0, checksum);
+	// Single-level OpenOrd moves every node in each of its 750 iterations
+	printf("node updates=%llu (single-level schedule: %llu)\n", (unsigned long long)ctx.node_updates, 750ull * data->node_count);
+	printf("working edges=%d of %u\n", ctx.levels[0].adj_offsets[ctx.levels[0].node_count] / 2, data->edge_count);
+	printf("edge length / pair distance=%.4f\n", pair_distance > 0.0 ? edge_length / pair_distance : 0.0);
+	openord_cleanup(&ctx);
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t node_count = (uint32_t)bench_arg(argc, argv, 1, 500000);
+	int iterations = (int)bench_arg(argc, argv, 2, 20);
+	int max_threads = (int)bench_arg(argc, argv, 3, 0);
+
+	GraphData data;
+	build_graph(&data, node_count);
+	bench_print_size(data.node_count, data.edge_count);
+	compare_neighbor_lookups(&data);
+
+	if (max_threads <= 0) {
+		run(&data, iterations);
+	} else {
+		// Thread counts above the core count time oversubscription, not speedup
+		if (max_threads > omp_get_num_procs())
+			printf("note: %d cores, counts above that do not measure scaling\n", omp_get_num_procs());
+		// Same starting layout for every thread count
+		Node *start = malloc(sizeof(Node) * node_count);
+		memcpy(start, data.nodes, sizeof(Node) * node_count);
+		for (int t = 1; t <= max_threads; t *= 2) {
+			memcpy(data.nodes, start, sizeof(Node) * node_count);
+			omp_set_num_threads(t);
+			run(&data, iterations);
+		}
+		free(start);
+	}
+
+	igraph_matrix_destroy(&data.current_layout);
+	free(data.nodes);
+	free(data.edges);
+	return 0;
+}
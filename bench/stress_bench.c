@@ -0,0 +1,104 @@
+// Sparse stress layout benchmark against the igraph 3D Kamada-Kawai layout on a
+// Barabasi-Albert graph.
+// Usage: stress-bench [node_count] [skip_igraph]
+// Quality is the normalized stress sum((s |x_i - x_j| - d_ij)^2 / d_ij^2) / pairs over the BFS
+// distances from sampled sources, with the layout scaled by the s that minimizes it (lower is
+// better; 0 reproduces the graph distances exactly).
+#include <math.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bench_common.h"
+#include "graph/layout_pivot_mds.h"
+#include "graph/layout_stress.h"
+
+#define SAMPLE_SOURCES 64
+
+static double sampled_stress(uint32_t n, const int *offsets, const int *neighbors, const igraph_matrix_t *layout)
+{
+	int k = SAMPLE_SOURCES < (int)n ? SAMPLE_SOURCES : (int)n;
+	int *sources = malloc(sizeof(int) * k);
+	float *distances = malloc(sizeof(float) * (size_t)n * k);
+	srand(7);
+	for (int s = 0; s < k; s++)
+		sources[s] = rand() % n;
+	pivot_mds_distances(n, offsets, neighbors, sources, k, distances);
+
+	// Stress is quadratic in the scale s: a s^2 - 2 b s + pairs
+	double a = 0.0, b = 0.0;
+	long pairs = 0;
+	for (int s = 0; s < k; s++) {
+		for (uint32_t i = 0; i < n; i++) {
+			double d = distances[(size_t)s * n + i];
+			if (d <= 0.0)
+				continue;
+			double dx = MATRIX(*layout, sources[s], 0) - MATRIX(*layout, i, 0);
+			double dy = MATRIX(*layout, sources[s], 1) - MATRIX(*layout, i, 1);
+			double dz = MATRIX(*layout, sources[s], 2) - MATRIX(*layout, i, 2);
+			double len = sqrt(dx * dx + dy * dy + dz * dz);
+			a += len * len / (d * d);
+			b += len / d;
+			pairs++;
+		}
+	}
+	free(sources);
+	free(distances);
+	if (pairs == 0 || a <= 0.0)
+		return 0.0;
+	return (pairs - b * b / a) / pairs;
+}
+
+int main(int argc, char **argv)
+{
+	igraph_integer_t node_count = bench_arg(argc, argv, 1, 2000);
+	int skip_igraph = (int)bench_arg(argc, argv, 2, 0);
+
+	igraph_t graph;
+	bench_barabasi_graph(&graph, node_count);
+
+	igraph_vector_int_t edges;
+	igraph_vector_int_init(&edges, 0);
+	igraph_get_edgelist(&graph, &edges, 0);
+	int *offsets = NULL, *neighbors = NULL;
+	pivot_mds_adjacency((uint32_t)node_count, &edges, &offsets, &neighbors);
+
+	igraph_matrix_t layout;
+	igraph_matrix_init(&layout, node_count, 3);
+
+	double t0 = omp_get_wtime();
+	StressContext ctx;
+	stress_init_edges(&ctx, (uint32_t)node_count, &edges, NULL);
+	double t1 = omp_get_wtime();
+	for (igraph_integer_t i = 0; i < node_count; i++) {
+		MATRIX(layout, i, 0) = ctx.x[i];
+		MATRIX(layout, i, 1) = ctx.y[i];
+		MATRIX(layout, i, 2) = ctx.z[i];
+	}
+	printf("pivot mds: %.3fs stress=%.4f\n", t1 - t0, sampled_stress((uint32_t)node_count, offsets, neighbors, &layout));
+	while (stress_iterate(&ctx))
+		;
+	double t2 = omp_get_wtime();
+	for (igraph_integer_t i = 0; i < node_count; i++) {
+		MATRIX(layout, i, 0) = ctx.x[i];
+		MATRIX(layout, i, 1) = ctx.y[i];
+		MATRIX(layout, i, 2) = ctx.z[i];
+	}
+	printf("sparse stress: threads=%d %d iterations in %.3fs (%.3fs total) stress=%.4f\n", ctx.num_threads, ctx.iteration, t2 - t1, t2 - t0, sampled_stress((uint32_t)node_count, offsets, neighbors, &layout));
+	stress_cleanup(&ctx);
+
+	if (!skip_igraph) {
+		// Same settings as compute_igraph_layout_kamada_kawai_3d
+		t0 = omp_get_wtime();
+		igraph_layout_kamada_kawai_3d(&graph, &layout, 0, node_count * 10, 0.0, (igraph_real_t)node_count, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+		t1 = omp_get_wtime();
+		printf("igraph kamada-kawai 3d: %.3fs stress=%.4f\n", t1 - t0, sampled_stress((uint32_t)node_count, offsets, neighbors, &layout));
+	}
+
+	free(offsets);
+	free(neighbors);
+	igraph_vector_int_destroy(&edges);
+	igraph_matrix_destroy(&layout);
+	igraph_destroy(&graph);
+	return 0;
+}
@@ -8,6 +8,8 @@
 
 #include "graph/graph_core.h"
 #include "graph/graph_types.h"
+#include "graph/layout_scheduler.h"
+#include "graph/layout_thread.h"
 #include "graph/worker_thread.h"
 #include "interaction/camera.h"
 #include "interaction/state.h"
@@ -34,10 +36,12 @@ typedef struct AppState
 	/* Application Logic State */
 	char *current_filename;
 	LayoutType current_layout;
+	InitialLayout initial_layout;
 	ClusterType current_cluster;
 	CommunityArrangementMode current_comm_arrangement;
 	char *node_attr;
 	char *edge_attr;
+	bool remove_overlaps; // Remove node overlaps after every layout
 
 	/* Interaction State */
 	int last_picked_node;
@@ -56,6 +60,10 @@ typedef struct AppState
 	/* Worker thread for long-running operations */
 	WorkerThreadContext worker_ctx;
 
+	/* Background thread for iterative layouts (OpenOrd, FR, UMAP) */
+	LayoutThread layout_thread;
+	LayoutScheduler layout_scheduler; // Inline iterations per frame vs. handing off to the thread
+
 	/* Job tracking */
 	WorkerJob *current_worker_job;
 	bool job_in_progress;
@@ -23,6 +23,7 @@ typedef struct CommandDef
 	IgraphWorkerFunc worker_func;
 	IgraphApplyFunc apply_func;
 	IgraphFreeFunc free_func;
+	bool seedable; // Worker starts from the current layout (see worker_thread_seed_layout) unless cold-started
 } CommandDef;
 
 extern const CommandDef g_command_registry[];
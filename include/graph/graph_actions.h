@@ -3,12 +3,40 @@
 #include "app_state.h"
 #include <stdbool.h>
 
+/**
+ * Stop the background layouts (layout thread, GPU layout) and bring their latest
+ * positions into the graph. Call before anything reads or replaces the graph's layout.
+ * @param state Pointer to the application state
+ */
+void graph_action_stop_layout(AppState *state);
+
 /**
  * Run one iteration of the current layout algorithm.
  * @param state Pointer to the application state
  */
 void graph_action_update_layout(AppState *state);
 
+/**
+ * Push overlapping nodes apart until none overlaps (or OVERLAP_MAX_PASSES ran).
+ * @param state Pointer to the application state
+ */
+void graph_action_remove_overlaps(AppState *state);
+
+/**
+ * Post-process a finished layout: removes overlaps within OVERLAP_POST_PROCESS_BUDGET_MS when
+ * state->remove_overlaps is set and regenerates the routing hubs. Doesn't update the renderer.
+ * @param state Pointer to the application state
+ */
+void graph_action_post_process_layout(AppState *state);
+
+/**
+ * Regenerate the hubs of hub-spoke edge routing (sqrt(edge_count) of them, at most
+ * HUB_MAX_COUNT) from the current positions. Does nothing in other routing modes. Called once
+ * positions or edges settle, never per frame. Doesn't update the renderer.
+ * @param state Pointer to the application state
+ */
+void graph_action_update_hubs(AppState *state);
+
 /**
  * Run clustering on the current graph.
  * @param state Pointer to the application state
@@ -54,8 +82,9 @@ void graph_action_highlight_infrastructure(AppState *state);
 void graph_action_reset(AppState *state);
 
 /**
- * Step the background layout (OpenOrd / Layered Sphere).
- * Called each frame for incremental layout computation.
+ * Advance the background layout (OpenOrd / Barnes-Hut / FR / UMAP on the layout thread).
+ * Called each frame: (re)starts an unfinished OpenOrd or Barnes-Hut run and takes the latest
+ * positions the layout thread has published.
  * @param state Pointer to the application state
  * @return true if layout was updated, false otherwise
  */
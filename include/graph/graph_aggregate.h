@@ -0,0 +1,68 @@
+#ifndef GRAPH_AGGREGATE_H
+#define GRAPH_AGGREGATE_H
+
+#include "graph/graph_types.h"
+
+/**
+ * One weighted edge of the community quotient graph.
+ */
+typedef struct
+{
+	int from;
+	int to;
+	int weight; // Number of original edges between the two communities
+} MetaEdge;
+
+/**
+ * Community quotient graph used for semantic zoom.
+ * Built once per membership result; only the centroids follow the layout.
+ */
+typedef struct CommunityAggregate
+{
+	uint32_t node_count; // Node count the membership was built for
+	int *membership;	 // Community id per node
+	int community_count;
+	int *population; // Nodes per community
+	vec3 *centroids; // Mean node position per community
+	vec3 *colors;	 // Mean node color per community
+	float *spread;	 // RMS distance of members from the centroid
+	MetaEdge *meta_edges;
+	int meta_edge_count;
+	int max_meta_weight;
+} CommunityAggregate;
+
+/**
+ * Build the quotient graph of a membership vector.
+ * Meta-edges merge all original edges between two communities; intra-community
+ * edges are dropped.
+ *
+ * @param data Graph with nodes, edges and colors already assigned
+ * @param membership Community id per node (size must equal data->node_count)
+ * @return Newly allocated aggregate, or NULL if the membership doesn't match
+ */
+CommunityAggregate *graph_aggregate_build(const GraphData *data, const igraph_vector_int_t *membership);
+
+/**
+ * Recompute centroids, spread and colors from the current node positions.
+ *
+ * @param agg Aggregate to update
+ * @param data Graph it was built from
+ * @return false if the graph no longer matches the aggregate (e.g. after filtering)
+ */
+bool graph_aggregate_update(CommunityAggregate *agg, const GraphData *data);
+
+/**
+ * Replace the graph's cached aggregate with one built from a new membership.
+ *
+ * @param data Graph data owning the cache
+ * @param membership Community id per node
+ */
+void graph_aggregate_set(GraphData *data, const igraph_vector_int_t *membership);
+
+/**
+ * Free an aggregate and all its arrays.
+ * @param agg Aggregate to free (may be NULL)
+ */
+void graph_aggregate_free(CommunityAggregate *agg);
+
+#endif // GRAPH_AGGREGATE_H
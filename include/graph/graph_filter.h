@@ -3,6 +3,13 @@
 
 #include "graph_types.h"
 
+// Upper bound on Lloyd iterations per hub generation
+#define HUB_KMEANS_ITERATIONS 10
+// Edge midpoints sampled per hub for the k-means++ seeding
+#define HUB_SEED_SAMPLE 32
+// Hub-spoke routing uses sqrt(edge_count) hubs, at most this many
+#define HUB_MAX_COUNT 4096
+
 /**
  * Filter nodes by degree - removes nodes with degree less than min_degree.
  * @param data Pointer to GraphData
@@ -24,7 +31,10 @@ void graph_filter_coreness(GraphData *data, int min_coreness);
 void graph_highlight_infrastructure(GraphData *data);
 
 /**
- * Generate hub positions using k-means clustering on edge midpoints.
+ * Generate hub positions using k-means clustering on edge midpoints, and the nearest hub of
+ * every edge (data->edge_hubs). Seeded by k-means++ on a sample of the midpoints, or warm
+ * started from the previous hubs when their number is unchanged. The assignment queries a
+ * kd-tree over the hubs, so it costs O(E log H) per iteration.
  * @param data Pointer to GraphData
  * @param num_hubs Number of hubs to generate
  */
@@ -8,10 +8,12 @@
  * @param filename Path to the GraphML file
  * @param data Pointer to GraphData to populate
  * @param layout_type Initial layout type to use
+ * @param initial_layout Starting positions: INITIAL_LAYOUT_DEFAULT for random (force layouts) or
+ *                       grid, HDE or spectral for a structured start that force layouts refine
  * @param node_attr Name of the node attribute to use for sizing (or NULL for default)
  * @param edge_attr Name of the edge attribute to use for sizing (or NULL for default)
  * @return 0 on success, -1 on failure
  */
-int graph_load_graphml(const char *filename, GraphData *data, LayoutType layout_type, const char *node_attr, const char *edge_attr);
+int graph_load_graphml(const char *filename, GraphData *data, LayoutType layout_type, InitialLayout initial_layout, const char *node_attr, const char *edge_attr);
 
 #endif // GRAPH_IO_H
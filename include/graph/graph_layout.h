@@ -2,6 +2,13 @@
 
 #include "graph_types.h"
 
+// Overlap removal stops once no pair overlaps by more than this fraction of its minimum distance
+#define OVERLAP_TOLERANCE 0.01f
+// Upper bound on overlap removal passes
+#define OVERLAP_MAX_PASSES 200
+// Time budget of overlap removal as a layout post-process, in milliseconds
+#define OVERLAP_POST_PROCESS_BUDGET_MS 250.0
+
 /**
  * Step the layout algorithm for the given number of iterations.
  *
@@ -13,8 +20,13 @@ void graph_layout_step(GraphData *data, LayoutType type, int iterations);
 
 /**
  * Remove overlaps between nodes in the current layout.
+ * Every pass computes all displacements from a snapshot of the positions (Jacobi, in parallel)
+ * over a hashed sparse grid. Passes repeat until the largest overlap is within
+ * OVERLAP_TOLERANCE, OVERLAP_MAX_PASSES have run or the time budget is spent.
  *
  * @param data The graph data structure
- * @param layoutScale Scale factor for the layout
+ * @param layoutScale Scale factor the renderer applies to positions (node sizes are unscaled)
+ * @param budget_ms Time budget in milliseconds, 0 for none
+ * @return Number of passes run
  */
-void graph_remove_overlaps(GraphData *data, float layoutScale);
+int graph_remove_overlaps(GraphData *data, float layoutScale, double budget_ms);
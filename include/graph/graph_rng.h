@@ -0,0 +1,59 @@
+#ifndef GRAPH_RNG_H
+#define GRAPH_RNG_H
+
+#include <stdint.h>
+
+/**
+ * Counter-based RNG: every draw is a pure hash of (seed, stream, a, b), so
+ * results don't depend on call order, thread count or OpenMP scheduling, and
+ * no state is shared between threads.
+ */
+
+/* Independent streams so unrelated consumers never reuse a key */
+typedef enum { GRAPH_RNG_STREAM_OPENORD = 1, GRAPH_RNG_STREAM_NODE_COLOR, GRAPH_RNG_STREAM_CLUSTER_COLOR, GRAPH_RNG_STREAM_HUBS, GRAPH_RNG_STREAM_OPENORD_PROJECT, GRAPH_RNG_STREAM_BARNES_HUT, GRAPH_RNG_STREAM_PIVOT_MDS, GRAPH_RNG_STREAM_SPECTRAL, GRAPH_RNG_STREAM_OVERLAP } GraphRngStream;
+
+/**
+ * Set the global seed (from the --seed command line option).
+ * Also seeds igraph's default RNG so igraph layouts are reproducible too.
+ * @param seed Seed value
+ */
+void graph_rng_set_seed(uint64_t seed);
+
+/**
+ * @return The global seed
+ */
+uint64_t graph_rng_get_seed(void);
+
+// SplitMix64 finalizer
+static inline uint64_t graph_rng_mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+/**
+ * 64 random bits for a key.
+ * @param stream Consumer stream (GraphRngStream)
+ * @param a First counter (e.g. iteration)
+ * @param b Second counter (e.g. node id)
+ */
+static inline uint64_t graph_rng_u64(uint64_t stream, uint64_t a, uint64_t b)
+{
+	uint64_t h = graph_rng_mix(graph_rng_get_seed() + stream * 0x9e3779b97f4a7c15ULL);
+	h = graph_rng_mix(h ^ (a + 0x9e3779b97f4a7c15ULL));
+	return graph_rng_mix(h ^ (b + 0x632be59bd9b4e019ULL));
+}
+
+/**
+ * Uniform float in [0, 1) for a key.
+ */
+static inline float graph_rng_float(uint64_t stream, uint64_t a, uint64_t b)
+{
+	return (float)(graph_rng_u64(stream, a, b) >> 40) * (1.0f / 16777216.0f);
+}
+
+#endif // GRAPH_RNG_H
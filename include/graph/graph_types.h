@@ -8,13 +8,19 @@
 
 // Forward declare complex contexts from layout engines
 typedef struct OpenOrdContext OpenOrdContext;
+typedef struct BarnesHutContext BarnesHutContext;
+typedef struct CommunityAggregate CommunityAggregate;
+typedef struct LayeredSphereContext LayeredSphereContext;
 
 /* ============================================================================
  * Enums (defined first as they're used by GraphData)
  * ============================================================================ */
 
 /* Layout Type Enum */
-typedef enum { LAYOUT_FR_3D, LAYOUT_KK_3D, LAYOUT_RANDOM_3D, LAYOUT_SPHERE, LAYOUT_GRID_3D, LAYOUT_UMAP_3D, LAYOUT_DRL_3D, LAYOUT_OPENORD_3D, LAYOUT_COUNT } LayoutType;
+typedef enum { LAYOUT_FR_3D, LAYOUT_KK_3D, LAYOUT_RANDOM_3D, LAYOUT_SPHERE, LAYOUT_GRID_3D, LAYOUT_UMAP_3D, LAYOUT_DRL_3D, LAYOUT_OPENORD_3D, LAYOUT_BARNES_HUT_3D, LAYOUT_GPU_FORCE_3D, LAYOUT_LAYERED_SPHERE_3D, LAYOUT_COUNT } LayoutType;
+
+/* Initial Layout Enum (positions a graph starts from when loaded) */
+typedef enum { INITIAL_LAYOUT_DEFAULT, INITIAL_LAYOUT_HDE, INITIAL_LAYOUT_SPECTRAL, INITIAL_LAYOUT_COUNT } InitialLayout;
 
 /* Cluster Type Enum */
 typedef enum { CLUSTER_FASTGREEDY, CLUSTER_WALKTRAP, CLUSTER_LABEL_PROP, CLUSTER_MULTILEVEL, CLUSTER_LEIDEN, CLUSTER_COUNT } ClusterType;
@@ -78,8 +84,14 @@ typedef struct
 	GraphProperties props;
 	LayoutType active_layout;
 	OpenOrdContext *openord;
+	BarnesHutContext *barnes_hut;
+	LayeredSphereContext *layered_sphere; // State kept by the last layered sphere run, NULL while one runs
+	int layered_sphere_epoch;			  // Bumped by graph changes; a run keeps its state only if unchanged
+	LayeredSphereContext *layered_sphere_run; // Stepped LAYOUT_LAYERED_SPHERE_3D run, owned like openord
 	Hub *hubs;
 	int hub_count;
+	int *edge_hubs; // Nearest hub per edge, from the last graph_generate_hubs; NULL once the edges change
+	CommunityAggregate *aggregate; // Quotient graph of the last community result (semantic zoom)
 } GraphData;
 
 #endif // GRAPH_TYPES_H
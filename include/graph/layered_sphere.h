@@ -1,8 +1,72 @@
 #ifndef LAYERED_SPHERE_H
 #define LAYERED_SPHERE_H
 
+#include "graph/graph_types.h"
+#include "interaction/state.h"
 #include <igraph.h>
 
+// Result of a layered sphere run: the positions and the radius of every occupied sphere
+typedef struct
+{
+	igraph_matrix_t layout;
+	float *shell_radii;
+	uint32_t shell_count;
+} LayeredSphereResult;
+
+// Keeps its state after a run: the next run on the same graph only re-detects the communities
+// of nodes whose edges changed and re-optimizes the spheres they leave or join
 void *compute_layout_layered_sphere(igraph_t *graph);
 
+// Applies the layout and uploads one transparent shell per sphere layer
+void apply_layout_layered_sphere(ExecutionContext *ctx, void *result_data);
+
+void free_layout_layered_sphere(void *result_data);
+
+/**
+ * Set up a stepped run (LAYOUT_LAYERED_SPHERE_3D) from the retained state, unless an unfinished
+ * one is in progress; a finished one is retained first. Main thread, layout thread idle.
+ * @param data Graph to lay out
+ * @return false if no run could be set up
+ */
+bool layered_sphere_start(GraphData *data);
+
+// Whether the stepped run has passes left
+bool layered_sphere_unfinished(const GraphData *data);
+
+// One pass of the stepped run (community detection and placement first); false once it's done
+bool layered_sphere_iterate_run(GraphData *data);
+
+// Passes done by the stepped run, for the HUD
+int layered_sphere_run_iteration(const GraphData *data);
+
+// Positions of the stepped run, one per node of the graph it was started on
+void layered_sphere_get_positions(const GraphData *data, vec3 *out);
+
+// Copy the stepped run's positions into a layout matrix (resized to n x 3)
+void layered_sphere_copy_layout(const GraphData *data, igraph_matrix_t *out);
+
+/**
+ * Radii of the occupied spheres of the stepped run.
+ * @param data Graph with a stepped run
+ * @param count Set to the number of radii
+ * @return Array to free, NULL if the run hasn't placed any node yet
+ */
+float *layered_sphere_shell_radii(const GraphData *data, uint32_t *count);
+
+// Hand the finished stepped run's state to the retained state, so the next run is incremental
+void layered_sphere_finish(GraphData *data);
+
+/**
+ * Carry the retained layered sphere state over a vertex deletion, so the next run stays
+ * incremental. Call before igraph_delete_vertices; an unfinished stepped run is dropped. Never
+ * waits for a layered sphere job on the worker: the state it holds is discarded when it ends.
+ * @param data Graph whose retained state to update
+ * @param vids Vertex ids about to be deleted
+ */
+void layered_sphere_delete_vertices(GraphData *data, const igraph_vector_int_t *vids);
+
+// Drop the retained layered sphere state and the stepped run, e.g. when the graph is replaced;
+// never waits for a worker run
+void layered_sphere_forget(GraphData *data);
+
 #endif
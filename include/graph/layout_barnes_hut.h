@@ -0,0 +1,103 @@
+#ifndef LAYOUT_BARNES_HUT_H
+#define LAYOUT_BARNES_HUT_H
+
+#include <stdbool.h>
+
+#include "cglm/vec3.h"
+#include "graph/graph_types.h"
+
+// Iterations of one run (the temperature cools linearly to zero over them)
+#define BARNES_HUT_ITERATIONS 300
+// Opening angle: a cell is approximated when its size / distance is below this
+#define BARNES_HUT_THETA 0.8f
+// Bodies per octree leaf; leaves are evaluated exactly with a SIMD loop
+#define BARNES_HUT_LEAF_SIZE 16
+
+// Octree cell. Children are allocated as one contiguous block.
+typedef struct
+{
+	float com[3]; // Center of mass
+	float mass;
+	float size;		 // Edge length of the cell's cube
+	int first_child; // -1 for leaves
+	int child_count;
+	int begin; // Bodies [begin, end) in Morton order
+	int end;
+} BarnesHutCell;
+
+typedef struct BarnesHutContext
+{
+	int iteration;
+	int max_iterations;
+	float start_temperature;
+	float ideal_length; // Spring length k: repulsion k^2/d, attraction d^2/k
+
+	// Input sizes the adjacency was built for
+	uint32_t node_count;
+	uint32_t edge_count;
+
+	// Node state as SoA, indexed by node id
+	float *x, *y, *z;
+	float *fx, *fy, *fz;
+
+	// Adjacency as CSR (both directions, self-loops dropped)
+	int *adj_offsets;
+	int *adj_neighbors;
+
+	// Octree, rebuilt every iteration over the bodies sorted by Morton code
+	uint32_t *codes;
+	int *order;		   // Morton position -> node id
+	float *sx, *sy, *sz; // Positions in Morton order (contiguous leaf bodies)
+	uint32_t *sort_keys; // Radix sort scratch
+	int *sort_values;
+	BarnesHutCell *cells;
+	int cell_capacity;
+	int cell_count;
+
+	int num_threads;
+} BarnesHutContext;
+
+/**
+ * Initialize the engine for a graph, starting from the graph's node positions.
+ * @param ctx Context to initialize
+ * @param graph Graph whose nodes and edges are laid out
+ */
+void barnes_hut_init(BarnesHutContext *ctx, const GraphData *graph);
+
+/**
+ * Initialize the engine from an igraph edge list.
+ * @param ctx Context to initialize
+ * @param node_count Number of nodes
+ * @param edges Edge list as consecutive (from, to) pairs
+ * @param seed Starting node_count x 3 layout, or NULL for a seeded random layout
+ */
+void barnes_hut_init_edges(BarnesHutContext *ctx, uint32_t node_count, const igraph_vector_int_t *edges, const igraph_matrix_t *seed);
+
+void barnes_hut_cleanup(BarnesHutContext *ctx);
+
+/**
+ * Pick up changes to the graph: rebuild the adjacency if its size changed and take the
+ * graph's node positions.
+ * @param ctx Context to update
+ * @param graph Graph the context lays out
+ */
+void barnes_hut_sync(BarnesHutContext *ctx, const GraphData *graph);
+
+/**
+ * Run one iteration on the context's own positions.
+ * @param ctx Context to advance
+ * @return true if an iteration ran, false once the run is done
+ */
+bool barnes_hut_iterate(BarnesHutContext *ctx);
+
+/**
+ * Copy the current positions into out.
+ * @param ctx Context to read
+ * @param out One position per node
+ */
+void barnes_hut_get_positions(const BarnesHutContext *ctx, vec3 *out);
+
+bool barnes_hut_step(BarnesHutContext *ctx,
+					 GraphData *graph); // Returns true if running, false if done
+
+#endif
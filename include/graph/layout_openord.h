@@ -21,6 +21,28 @@ typedef struct
 	float min_edges;
 } OpenOrdStage;
 
+typedef struct OpenOrdBrick OpenOrdBrick;
+
+// Coarsening stops once a level has at most this many nodes
+#define OPENORD_COARSEST_NODES 4000
+#define OPENORD_MAX_LEVELS 16
+// Coarse nodes keep at most this many neighbors (the heaviest); merging otherwise leaves
+// the coarse levels of scale-free graphs nearly as many edges as the input
+#define OPENORD_COARSE_MAX_DEGREE 16
+
+// One level of the multilevel hierarchy
+typedef struct
+{
+	uint32_t node_count;
+	int *adj_offsets;	// CSR [node_count + 1], both directions, self-loops dropped; shrinks as edges are cut
+	int *adj_neighbors; // Neighbor ids, grouped by node
+	float *adj_weights; // Edge weight aligned with adj_neighbors (summed when coarsened)
+	uint32_t *mass;		// Input nodes merged into each node (NULL on level 0: all 1)
+	int *parent;		// Node of the next coarser level (NULL on the coarsest)
+	vec3 *positions;
+	vec3 *next_positions; // Written during a step (Jacobi update)
+} OpenOrdLevel;
+
 typedef struct OpenOrdContext
 {
 	int stage_id; // 0:Liquid, 1:Expansion, 2:Cooldown, 3:Crunch, 4:Simmer,
@@ -28,15 +50,32 @@ typedef struct OpenOrdContext
 	int current_iter;
 	int total_iters;
 
-	// Grid settings
-	int grid_size;
-	float view_size;
+	// Grid settings (resolution and view chosen at init, see openord_init)
+	int grid_size;	  // Cells per axis, a multiple of the brick size
+	float view_size;  // World extent covered by the grid
+	float grid_scale; // grid_size / view_size
 	float radius;
-	float *density_grid; // Flattened 3D array [grid_size^3]
+	bool auto_grid;   // Grid sized from the node count, re-derived when the graph changes size
 
-	// Node state
-	vec3 *positions; // Current positions
-	float *energies; // Node energies
+	// Sparse density grid: 8^3-cell bricks allocated on demand, rebuilt each step
+	int bricks_per_axis;
+	OpenOrdBrick *bricks; // Brick pool
+	int brick_count;
+	int brick_capacity;
+	int *brick_table; // Brick directory [bricks_per_axis^3]: pool index, -1 if unallocated
+	int *occupied_cells; // Non-empty cells grouped by z-plane
+	int occupied_capacity;
+	int *plane_offsets; // [grid_size + 1] start of each plane in occupied_cells
+
+	// Multilevel hierarchy: level 0 is the input graph, each further level a
+	// heavy-edge matching of the one below. Laid out coarsest first.
+	OpenOrdLevel levels[OPENORD_MAX_LEVELS];
+	int level_count;
+	int level;				 // Level currently being laid out (counts down to 0)
+	uint32_t input_node_count; // Input graph size the hierarchy was built for
+	uint32_t input_edge_count;
+	uint64_t node_updates; // Node moves evaluated so far (work measure for benchmarks)
+	int *cut_targets;	   // Per node: neighbor whose edge is cut this iteration, or -1
 
 	// Schedule
 	OpenOrdStage stages[5];
@@ -52,10 +91,39 @@ typedef struct OpenOrdContext
 	int num_threads;
 } OpenOrdContext;
 
-void openord_init(OpenOrdContext *ctx, int node_count, int grid_size);
+/**
+ * Initialize the OpenOrd schedule and cache the graph's adjacency as CSR.
+ * @param ctx Context to initialize
+ * @param graph Graph whose nodes and edges are laid out
+ * @param grid_size Density grid resolution per axis, or <= 0 to derive it from the node count
+ */
+void openord_init(OpenOrdContext *ctx, const GraphData *graph, int grid_size);
 void openord_cleanup(OpenOrdContext *ctx);
 bool openord_step(OpenOrdContext *ctx,
 				  GraphData *graph); // Returns true if running, false if done
+
+/**
+ * Pick up changes to the graph: rebuild the hierarchy and resize an automatic grid if its
+ * size changed and, at full resolution, take the graph's node positions. openord_step does this every iteration;
+ * callers driving openord_iterate do it before handing the context to another thread.
+ * @param ctx Context to update
+ * @param graph Graph the context lays out
+ */
+void openord_sync(OpenOrdContext *ctx, const GraphData *graph);
+
+/**
+ * Run one iteration on the context's own positions without touching the graph.
+ * @param ctx Context to advance
+ * @return true if an iteration ran, false once the schedule is done
+ */
+bool openord_iterate(OpenOrdContext *ctx);
+
+/**
+ * Copy the current layout, projected to the input nodes, into out.
+ * @param ctx Context to read
+ * @param out One position per input node
+ */
+void openord_get_positions(OpenOrdContext *ctx, vec3 *out);
 const char *openord_get_stage_name(int stage_id);
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef LAYOUT_PIVOT_MDS_H
+#define LAYOUT_PIVOT_MDS_H
+
+#include <igraph.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pivots (landmarks) per layout; memory and time are O(n * pivots)
+#define PIVOT_MDS_PIVOTS 100
+// Orthogonal iterations for the top eigenvectors of the pivots x pivots matrix
+#define PIVOT_MDS_EIGEN_ITERATIONS 200
+
+/**
+ * Pivot MDS (Brandes & Pich): BFS hop distances from a seeded random set of pivots, run in
+ * parallel, double-centered into an n x pivots matrix C whose projection onto the top three
+ * eigenvectors of C^T C gives the layout. Approximates classical MDS on all-pairs distances.
+ * Nodes a pivot can't reach are put one hop beyond its farthest reachable node.
+ * @param node_count Number of nodes
+ * @param edges Edge list as consecutive (from, to) pairs, treated as undirected
+ * @param pivot_count Requested pivots (clamped to node_count)
+ * @param layout Initialized matrix, resized to node_count x 3
+ * @return false if memory ran out
+ */
+bool pivot_mds_layout(uint32_t node_count, const igraph_vector_int_t *edges, int pivot_count, igraph_matrix_t *layout);
+
+// Building blocks, shared with the sparse stress and HDE layouts
+
+/**
+ * Undirected CSR from an igraph edge list, self-loops dropped.
+ * @return false if memory ran out; otherwise the caller frees both arrays
+ */
+bool pivot_mds_adjacency(uint32_t n, const igraph_vector_int_t *edges, int **offsets_out, int **neighbors_out);
+
+/**
+ * Draw k distinct pivots from the seeded graph RNG.
+ */
+void pivot_mds_choose_pivots(uint32_t n, int k, int *pivots);
+
+/**
+ * Parallel BFS hop distances from each pivot: distances[p * n + i] (k x n floats).
+ */
+void pivot_mds_distances(uint32_t n, const int *offsets, const int *neighbors, const int *pivots, int k, float *distances);
+
+/**
+ * Top three eigenvectors of a symmetric positive semidefinite k x k matrix by orthogonal
+ * iteration, largest first.
+ * @param b Row-major k x k matrix
+ * @param vectors Receives the eigenvectors, k doubles each
+ * @param values Receives their eigenvalues (clamped to >= 0)
+ */
+void pivot_mds_top_eigenvectors(const double *b, int k, double *vectors, double *values);
+
+/**
+ * Project pivot distances (as from pivot_mds_distances) into 3D.
+ * @return false if memory ran out
+ */
+bool pivot_mds_project(uint32_t n, int k, const float *distances, float *x, float *y, float *z);
+
+#endif // LAYOUT_PIVOT_MDS_H
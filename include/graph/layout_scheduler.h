@@ -0,0 +1,40 @@
+#ifndef LAYOUT_SCHEDULER_H
+#define LAYOUT_SCHEDULER_H
+
+#include <stdbool.h>
+
+// Default main-thread time per frame for inline layout iterations
+#define LAYOUT_FRAME_BUDGET_MS 4.0f
+// Upper bound on inline iterations per frame (keeps the first frames responsive)
+#define LAYOUT_MAX_ITERATIONS_PER_FRAME 256
+
+typedef enum {
+	LAYOUT_SCHEDULE_INLINE,		// Iterations run on the main thread within the frame budget
+	LAYOUT_SCHEDULE_BACKGROUND, // One iteration exceeds the budget: the layout thread runs it
+} LayoutScheduleMode;
+
+// Chooses how many layout iterations fit into each frame, from the measured iteration cost
+typedef struct
+{
+	float budget_ms;		  // Configurable per-frame budget (--layout-budget)
+	float iteration_ms;		  // Smoothed cost of one iteration, 0 until measured
+	int samples;			  // Frames measured since the last reset
+	int iterations_per_frame; // Last planned count (shown in the HUD)
+	LayoutScheduleMode mode;
+} LayoutScheduler;
+
+void layout_scheduler_init(LayoutScheduler *s, float budget_ms);
+
+// Forget the measured cost (the graph or layout changed); the budget is kept
+void layout_scheduler_reset(LayoutScheduler *s);
+
+// Iterations to run inline this frame; 0 means hand the layout to the background thread
+int layout_scheduler_plan(LayoutScheduler *s);
+
+// Feed back the measured time of the iterations run this frame
+void layout_scheduler_record(LayoutScheduler *s, int iterations, double elapsed_ms);
+
+// Monotonic clock in milliseconds for the measurements above
+double layout_scheduler_now_ms(void);
+
+#endif // LAYOUT_SCHEDULER_H
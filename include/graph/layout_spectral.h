@@ -0,0 +1,46 @@
+#ifndef LAYOUT_SPECTRAL_H
+#define LAYOUT_SPECTRAL_H
+
+#include <igraph.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Pivots (dimensions) of the high-dimensional embedding
+#define SPECTRAL_HDE_PIVOTS 50
+// Lanczos basis size; the basis takes this many floats per node
+#define SPECTRAL_LANCZOS_STEPS 40
+// Ritz vectors kept across a thick restart
+#define SPECTRAL_LANCZOS_KEEP 10
+// Restarts per layout: each adds SPECTRAL_LANCZOS_STEPS - SPECTRAL_LANCZOS_KEEP sparse products
+#define SPECTRAL_LANCZOS_RESTARTS 8
+
+/**
+ * High-dimensional embedding (Harel & Koren): level-synchronous parallel BFS from pivots
+ * picked farthest-first (k-centers), so each node gets a pivot_count-dimensional vector of
+ * hop distances, projected to 3D by PCA. Linear in the graph size per pivot. Farthest-first
+ * picking also reaches every component, as unreachable nodes count as the farthest.
+ * Scaled to a mean edge length of one.
+ * @param node_count Number of nodes
+ * @param edges Edge list as consecutive (from, to) pairs, treated as undirected
+ * @param pivot_count Requested pivots (clamped to node_count)
+ * @param layout Initialized matrix, resized to node_count x 3
+ * @return false if memory ran out
+ */
+bool spectral_hde_layout(uint32_t node_count, const igraph_vector_int_t *edges, int pivot_count, igraph_matrix_t *layout);
+
+/**
+ * Laplacian spectral layout (Koren's degree-normalized eigenvectors): the three eigenvectors
+ * after the trivial one of D^-1/2 A D^-1/2, found by thick-restart Lanczos with full
+ * reorthogonalization on parallel sparse products and mapped back through D^-1/2. The trivial
+ * vectors of every connected component are deflated, so the layout spreads the largest
+ * component and isolated nodes sit at the origin. Slower than HDE and weaker on long, thin
+ * meshes, whose eigenvalues are too clustered for the restart budget. Scaled to a mean edge
+ * length of one.
+ * @param node_count Number of nodes
+ * @param edges Edge list as consecutive (from, to) pairs, treated as undirected
+ * @param layout Initialized matrix, resized to node_count x 3
+ * @return false if memory ran out
+ */
+bool spectral_laplacian_layout(uint32_t node_count, const igraph_vector_int_t *edges, igraph_matrix_t *layout);
+
+#endif // LAYOUT_SPECTRAL_H
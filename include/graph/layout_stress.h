@@ -0,0 +1,69 @@
+#ifndef LAYOUT_STRESS_H
+#define LAYOUT_STRESS_H
+
+#include <igraph.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Upper bound on majorization iterations of one run
+#define STRESS_ITERATIONS 200
+// A run ends once the mean node move drops below this, in hops (the target edge length)
+#define STRESS_TOLERANCE 5e-3f
+// Pivots for the sparse stress terms (and the Pivot MDS start)
+#define STRESS_PIVOTS 100
+
+/**
+ * Sparse stress model (Ortmann, Klimenta & Brandes): every node keeps exact stress terms to its
+ * neighbors and one term per pivot that stands in for the pivot's region of the graph, weighted
+ * by how many region nodes are at most half as far from the pivot. O(m + n * pivots) terms
+ * instead of n^2. Minimized by localized majorization as parallel Jacobi sweeps.
+ */
+typedef struct StressContext
+{
+	int iteration;
+	int max_iterations;
+	float last_move; // Mean node move of the last iteration, in hops
+
+	uint32_t node_count;
+
+	// Positions as SoA; the next_* arrays receive each Jacobi sweep
+	float *x, *y, *z;
+	float *next_x, *next_y, *next_z;
+
+	// Adjacency as CSR (both directions, self-loops dropped)
+	int *adj_offsets;
+	int *adj_neighbors;
+
+	// Pivot terms: hop distance and weight per node and pivot (node_count x pivot_count)
+	int pivot_count;
+	int *pivots;
+	float *pivot_dist;
+	float *pivot_weight;
+
+	int num_threads;
+} StressContext;
+
+/**
+ * Initialize the engine from an igraph edge list. Pivot distances are computed once here.
+ * @param ctx Context to initialize
+ * @param node_count Number of nodes
+ * @param edges Edge list as consecutive (from, to) pairs, treated as undirected
+ * @param seed Starting node_count x 3 layout (warm start), or NULL to start from Pivot MDS
+ * @return false if memory ran out (ctx is left empty)
+ */
+bool stress_init_edges(StressContext *ctx, uint32_t node_count, const igraph_vector_int_t *edges, const igraph_matrix_t *seed);
+
+void stress_cleanup(StressContext *ctx);
+
+/**
+ * One Jacobi sweep over all nodes.
+ * @return true while the run hasn't converged or hit max_iterations
+ */
+bool stress_iterate(StressContext *ctx);
+
+/**
+ * Copy the current positions into out.
+ */
+void stress_get_positions(const StressContext *ctx, float (*out)[3]);
+
+#endif // LAYOUT_STRESS_H
@@ -0,0 +1,70 @@
+#ifndef LAYOUT_THREAD_H
+#define LAYOUT_THREAD_H
+
+#include "graph/graph_types.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+
+// Iterations per call for layouts run in chunks (FR) and their total per run; UMAP runs the
+// total as its epochs in one call
+#define LAYOUT_THREAD_CHUNK 5
+#define LAYOUT_THREAD_ITERATIONS 50
+
+// Runs an iterative layout continuously on its own thread. The thread owns the layout's
+// working state while busy; the main thread only touches the GraphData after a stop.
+typedef struct
+{
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	bool running;
+	bool thread_running;
+	bool has_job;			  // Guarded by mutex
+	_Atomic bool busy;		  // A layout is being iterated
+	_Atomic bool stop_requested;
+	bool pending_final;		  // Main thread: final positions not yet copied into the graph
+
+	// Current job, written by the main thread only while idle
+	LayoutType layout;
+	GraphData *graph;		  // Only the igraph graph and the OpenOrd / Barnes-Hut / layered sphere runs are read while busy
+	igraph_matrix_t work;	  // Private layout matrix for the igraph layouts
+	bool work_initialized;
+	bool work_seeded;		  // The next igraph call may start from work (else random)
+	int iterations_done;
+
+	// Double-buffered positions: the thread fills the back buffer and publishes it by
+	// swapping the front index; the main thread copies the front at most once per frame
+	vec3 *positions[2];
+	uint32_t position_capacity;
+	uint32_t position_count;
+	_Atomic int front;
+	_Atomic bool fresh;		  // Front holds positions the main thread hasn't taken yet
+
+	// OpenOrd / Barnes-Hut / layered sphere progress for the HUD, published every iteration
+	_Atomic int stage_id;
+	_Atomic int current_iter;
+	_Atomic int level;
+} LayoutThread;
+
+// Start the (idle) layout thread
+int layout_thread_init(LayoutThread *lt);
+
+// Whether the layout can be run by the layout thread
+bool layout_thread_supports(LayoutType layout);
+
+// Start iterating the graph's layout in the background; stops any previous run first
+bool layout_thread_start(LayoutThread *lt, GraphData *graph, LayoutType layout);
+
+// Stop the current run (blocking) and copy its latest positions into the graph
+void layout_thread_stop(LayoutThread *lt, GraphData *graph);
+
+// Copy newly published positions into the graph; returns true if they changed
+bool layout_thread_consume(LayoutThread *lt, GraphData *graph);
+
+bool layout_thread_is_busy(LayoutThread *lt);
+
+// Stop the thread and free its buffers
+void layout_thread_cleanup(LayoutThread *lt);
+
+#endif // LAYOUT_THREAD_H
@@ -2,6 +2,7 @@
 #define WORKER_THREAD_H
 
 #include "graph/command_registry.h"
+#include "graph/graph_types.h"
 #include "interaction/state.h"
 #include <pthread.h>
 #include <stdatomic.h>
@@ -10,6 +11,25 @@
 // Job status
 typedef enum { JOB_STATUS_PENDING, JOB_STATUS_RUNNING, JOB_STATUS_COMPLETED, JOB_STATUS_FAILED, JOB_STATUS_CANCELLED, JOB_STATUS_NONE } WorkerJobStatus;
 
+// Minimum time between two intermediate layouts published by one job
+#define WORKER_SNAPSHOT_INTERVAL_MS 100.0
+
+// Bit set in WorkerSnapshots.middle while the middle slot holds an unread layout
+#define WORKER_SNAPSHOT_FRESH 4
+
+// Lock-free triple buffer of intermediate layouts: the worker fills back and swaps it with
+// middle, the main thread swaps a fresh middle with front. Slots hold count xyz triples.
+typedef struct
+{
+	float *slots[3];
+	uint32_t count;
+	_Atomic int middle; // Slot index | WORKER_SNAPSHOT_FRESH
+	int back;			// Worker-owned
+	int front;			// Main thread-owned
+	double last_publish_ms;
+	const igraph_matrix_t *watched; // Published from the igraph progress callback
+} WorkerSnapshots;
+
 // Job structure
 typedef struct
 {
@@ -24,6 +44,12 @@ typedef struct
 	IgraphWorkerFunc worker_func;
 	IgraphApplyFunc apply_func;
 	IgraphFreeFunc free_func;
+
+	// Copy of the current layout for seedable layouts to start from, NULL for a cold start
+	igraph_matrix_t *seed_layout;
+
+	// Intermediate layouts while the job runs
+	WorkerSnapshots snapshots;
 } WorkerJob;
 
 // Worker thread context
@@ -47,8 +73,41 @@ typedef struct
 // Initialize worker thread system
 int worker_thread_init(WorkerThreadContext *context, int max_queue_size);
 
-// Submit a job to worker thread
-WorkerJob *worker_thread_submit_job(WorkerThreadContext *context, CommandDef *cmd, ExecutionContext *ctx);
+// Submit a job to worker thread; seed_layout (may be NULL) is copied for the job
+WorkerJob *worker_thread_submit_job(WorkerThreadContext *context, CommandDef *cmd, ExecutionContext *ctx, const igraph_matrix_t *seed_layout);
+
+// Seed layout of the job running on the calling thread, NULL outside a job or on a cold start
+const igraph_matrix_t *worker_thread_seed_layout(void);
+
+// Graph data of the application that submitted the job running on the calling thread, NULL
+// outside a job. Workers may only touch fields shared under their own lock.
+GraphData *worker_thread_graph(void);
+
+// Worker side: publish an intermediate n x 2 or n x 3 layout of the running job. Rate-limited
+// to WORKER_SNAPSHOT_INTERVAL_MS, so chunked layouts can call it after every chunk.
+void worker_thread_publish_layout(const igraph_matrix_t *layout);
+
+// Worker side: back buffer for count xyz positions of the running job, or NULL while the last
+// snapshot is more recent than WORKER_SNAPSHOT_INTERVAL_MS. Native engines check it before
+// reading out their positions, straight into the buffer, and publish it with
+// worker_thread_snapshot_end.
+float *worker_thread_snapshot_begin(uint32_t count);
+
+// Worker side: publish the buffer filled after worker_thread_snapshot_begin
+void worker_thread_snapshot_end(void);
+
+// Worker side: publish this matrix whenever igraph reports progress, for igraph layouts that
+// iterate in place on their result matrix and call the progress handler while they do (of the
+// igraph 1.0 layouts only GraphOpt; FR, KK, Davidson-Harel, GEM and UMAP don't report progress).
+// Pass NULL once the call returns.
+void worker_thread_watch_layout(const igraph_matrix_t *layout);
+
+// Main thread: write the newest intermediate layout of a running job into the graph's nodes.
+// Returns true if there was a new one to display.
+bool worker_thread_consume_snapshot(WorkerJob *job, GraphData *graph);
+
+// Free a finished job and everything it owns except its result
+void worker_thread_destroy_job(WorkerJob *job);
 
 // Get job status and progress
 WorkerJobStatus worker_thread_get_job_status(WorkerJob *job, float *progress);
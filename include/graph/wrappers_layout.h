@@ -19,6 +19,8 @@ void *compute_igraph_layout_gem(igraph_t *graph);
 void *compute_igraph_layout_forceatlas2_3d(igraph_t *graph);
 void *compute_igraph_layout_yifan_hu(igraph_t *graph);
 void *compute_igraph_layout_yifan_hu_3d(igraph_t *graph);
+void *compute_layout_barnes_hut_3d(igraph_t *graph);
+void *compute_layout_stress_3d(igraph_t *graph);
 void *compute_igraph_layout_lgl(igraph_t *graph);
 
 // Tree layouts
@@ -37,20 +39,26 @@ void *compute_igraph_layout_random_3d(igraph_t *graph);
 void *compute_igraph_layout_random(igraph_t *graph);
 
 // Bipartite layouts
-void *compute_igraph_layout_mds(igraph_t *graph);
+void *compute_layout_pivot_mds_3d(igraph_t *graph);
 void *compute_igraph_layout_bipartite(igraph_t *graph);
 void *compute_igraph_layout_bipartite_simple(igraph_t *graph);
 
 // Dimensionality reduction / Embedding
 void *compute_igraph_layout_umap_3d(igraph_t *graph);
 void *compute_igraph_layout_umap(igraph_t *graph);
+void *compute_layout_hde_3d(igraph_t *graph);
+void *compute_layout_spectral_3d(igraph_t *graph);
 
 // Community-based layouts
 void *compute_layout_layered_sphere(igraph_t *graph);
+void apply_layout_layered_sphere(ExecutionContext *ctx, void *result_data);
+void free_layout_layered_sphere(void *result_data);
 
 // Standard apply and free functions
 void free_layout_matrix(void *result_data);
 void apply_layout_matrix(ExecutionContext *ctx, void *result_data);
 void apply_layout_matrix_centered(ExecutionContext *ctx, void *result_data);
+// For nodes on layered sphere shells: shows the shells and keeps the nodes on them
+void apply_layout_matrix_with_shells(ExecutionContext *ctx, void *result_data, const float *shell_radii, uint32_t shell_count);
 
 #endif // GRAPH_WRAPPERS_LAYOUT_H
@@ -15,4 +15,7 @@ typedef enum { PLATONIC_TETRAHEDRON = 0, PLATONIC_CUBE, PLATONIC_OCTAHEDRON, PLA
 
 void polyhedron_generate_platonic(PlatonicType type, Vertex **vertices, uint32_t *vertexCount, uint32_t **indices, uint32_t *indexCount);
 
+// Indexed unit icosphere; each subdivision level quadruples the triangle count
+void polyhedron_generate_icosphere(int subdivisions, Vertex **vertices, uint32_t *vertexCount, uint32_t **indices, uint32_t *indexCount);
+
 #endif
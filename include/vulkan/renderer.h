@@ -10,7 +10,40 @@
 
 struct AppContext;
 
-typedef enum { ROUTING_MODE_STRAIGHT = 0, ROUTING_MODE_SPHERICAL_PCB = 1 } EdgeRoutingMode;
+typedef enum { ROUTING_MODE_STRAIGHT = 0, ROUTING_MODE_SPHERICAL_PCB = 1, ROUTING_MODE_HUB_SPOKE = 2 } EdgeRoutingMode;
+
+typedef enum { DENSITY_MODE_AUTO = 0, DENSITY_MODE_OFF = 1, DENSITY_MODE_ON = 2, DENSITY_MODE_COUNT } DensityMode;
+
+// Node count above which DENSITY_MODE_AUTO replaces geometry with the density overview
+#define DENSITY_AUTO_NODE_THRESHOLD 2000000
+// Accumulation buffer resolution divisor relative to the swapchain
+#define DENSITY_DOWNSAMPLE 2
+
+// Edges are ordered into hashed buckets; drawing a bucket prefix draws a uniform random subset
+#define EDGE_LOD_BUCKETS 256
+// Below this many edges the edge LOD never subsamples
+#define EDGE_LOD_MIN_EDGES 100000
+// Alpha of an unselected edge when every edge is drawn
+#define EDGE_ALPHA 0.8f
+
+// GPU force layout: run length, iterations recorded per frame and grid cells per axis
+#define FORCE_LAYOUT_ITERATIONS 300
+#define FORCE_LAYOUT_ITERATIONS_PER_FRAME 2
+#define FORCE_GRID_DIM 64
+
+// Semantic zoom cross-fades detail -> community aggregate between these camera distances (in graph radii)
+#define SEMANTIC_ZOOM_NEAR 4.0f
+#define SEMANTIC_ZOOM_FAR 8.0f
+
+#define SPHERE_LOD_COUNT 3
+
+// Per-instance data for the layered sphere shells (unit mesh scaled in the shader)
+typedef struct
+{
+	vec3 center;
+	float radius;
+	float alpha;
+} SphereInstance;
 
 typedef struct
 {
@@ -89,6 +122,41 @@ typedef struct
 	uint32_t edgeCount;
 	uint32_t edgeVertexCount;
 
+	// Stochastic edge LOD: hashed subset while the camera moves, refined progressively at rest
+	bool edgeLod;
+	bool cameraMoving;
+	uint32_t edgeLodLevel;								 // Buckets currently drawn (1..EDGE_LOD_BUCKETS)
+	uint32_t edgeLodMovingLevel;						 // Buckets drawn while the camera moves
+	uint32_t edgeLodRefineStep;							 // Buckets added per frame while at rest
+	uint32_t edgeLodVertexOffsets[EDGE_LOD_BUCKETS + 1]; // First edge vertex of each bucket
+
+	// Edge LOD accumulation: drawn buckets persist in an offscreen premultiplied image that is
+	// composited every frame, so a still frame only draws the buckets the image lacks
+	uint32_t edgeAccumLevel; // Buckets in edgeAccumImage for the current view and geometry, 0 to clear
+	VkImage edgeAccumImage;
+	VkDeviceMemory edgeAccumImageMemory;
+	VkImageView edgeAccumImageView;
+	VkRenderPass edgeAccumRenderPass;
+	VkFramebuffer edgeAccumFramebuffer;
+	VkPipeline edgeAccumPipeline; // edgePipeline with premultiplied alpha output
+	VkDescriptorSetLayout edgeCompositeDescriptorSetLayout;
+	VkPipelineLayout edgeCompositePipelineLayout;
+	VkDescriptorPool edgeCompositeDescriptorPool;
+	VkDescriptorSet edgeCompositeDescriptorSet;
+	VkPipeline edgeCompositePipeline;
+
+	// Semantic zoom: community meta-nodes and meta-edges, faded in as the camera pulls back
+	bool semanticZoom;
+	VkBuffer aggregateNodeBuffer;
+	VkDeviceMemory aggregateNodeBufferMemory;
+	uint32_t aggregateNodeCount;
+	VkBuffer aggregateEdgeBuffer;
+	VkDeviceMemory aggregateEdgeBufferMemory;
+	uint32_t aggregateEdgeVertexCount;
+	vec3 graphCenter;  // Bounding sphere of the scaled layout, drives the cross-fade
+	float graphRadius;
+	float aggregateBlend; // 0 = detail only, 1 = aggregate only (last drawn frame)
+
 	VkBuffer labelVertexBuffer;
 	VkDeviceMemory labelVertexBufferMemory;
 	VkBuffer labelInstanceBuffer;
@@ -100,6 +168,7 @@ typedef struct
 	bool showNodes;
 	bool showEdges;
 	bool showUI;
+	bool singlePassNodes; // Shader wireframe in one pass instead of a second line-mode pass
 	float layoutScale;
 
 	// UI
@@ -152,14 +221,61 @@ typedef struct
 	struct AppContext *app_ctx_ptr;
 
 	// Layered Spheres (Transparent)
+	// One shared unit icosphere at SPHERE_LOD_COUNT levels, drawn instanced
 	VkBuffer sphereVertexBuffer;
 	VkDeviceMemory sphereVertexBufferMemory;
 	VkBuffer sphereIndexBuffer;
 	VkDeviceMemory sphereIndexBufferMemory;
-	uint32_t *sphereIndexCounts;  // Array of index counts per sphere
-	uint32_t *sphereIndexOffsets; // Array of offsets into the index buffer
-	uint32_t numSpheres;		  // Number of spheres to draw
-	bool showSpheres;			  // Toggle
+	uint32_t sphereLodIndexCounts[SPHERE_LOD_COUNT];  // Index count of each LOD mesh
+	uint32_t sphereLodFirstIndex[SPHERE_LOD_COUNT];	  // Offset of each LOD into the index buffer
+	int32_t sphereLodVertexOffset[SPHERE_LOD_COUNT];  // Base vertex of each LOD
+	VkBuffer sphereInstanceBuffer;
+	VkDeviceMemory sphereInstanceBufferMemory;
+	uint32_t sphereInstanceCapacity;
+	SphereInstance *sphereInstances; // CPU copy sorted by radius, used for LOD selection
+	uint32_t numSpheres;			 // Number of spheres to draw
+	bool showSpheres;				 // Toggle
+
+	// Density-splat overview (compute splat into an accumulation buffer, tone-mapped resolve)
+	DensityMode densityMode;
+	float densityExposure;
+	uint32_t densityWidth;
+	uint32_t densityHeight;
+	VkBuffer densityAccumBuffer;
+	VkDeviceMemory densityAccumBufferMemory;
+	VkDescriptorSetLayout densityDescriptorSetLayout;
+	VkPipelineLayout densityPipelineLayout;
+	VkDescriptorPool densityDescriptorPool;
+	VkDescriptorSet densityDescriptorSet;
+	VkPipeline densitySplatPipeline;
+	VkPipeline densityResolvePipeline;
+
+	// GPU force layout (compute iterations recorded before the render pass, writing node
+	// instances and straight edge vertices in place; GraphData is only updated on read-back)
+	bool forceRunning;		 // Record iterations this frame
+	bool forceDirty;		 // GPU positions are ahead of GraphData
+	int forceIteration;
+	float forceIdealLength;
+	float forceStartTemperature;
+	uint32_t forceNodeCount;
+	uint32_t forceEdgeVertexCount; // Edge vertices to follow their nodes (0 when edges are routed)
+	uint32_t *nodeInstanceSlots;   // Node id -> slot in instanceBuffer, filled by renderer_update_graph
+	uint32_t *edgeVertexNodes;	   // Edge vertex -> node id for straight edges, filled likewise
+	VkBuffer forceNodeBuffer;
+	VkDeviceMemory forceNodeBufferMemory;
+	VkBuffer forceAdjacencyBuffer;
+	VkDeviceMemory forceAdjacencyBufferMemory;
+	VkBuffer forceGridBuffer;
+	VkDeviceMemory forceGridBufferMemory;
+	VkBuffer forceBoundsBuffer;
+	VkDeviceMemory forceBoundsBufferMemory;
+	VkBuffer forceEdgeVertexNodeBuffer;
+	VkDeviceMemory forceEdgeVertexNodeBufferMemory;
+	VkDescriptorSetLayout forceDescriptorSetLayout;
+	VkPipelineLayout forcePipelineLayout;
+	VkDescriptorPool forceDescriptorPool;
+	VkDescriptorSet forceDescriptorSet;
+	VkPipeline forcePipeline;
 } Renderer;
 
 int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph);
@@ -167,6 +283,7 @@ void renderer_cleanup(Renderer *r);
 void renderer_draw_frame(Renderer *r);
 void renderer_update_view(Renderer *r, vec3 pos, vec3 front, vec3 up);
 void renderer_update_graph(Renderer *r, GraphData *graph);
+void renderer_update_spheres(Renderer *r, const vec3 center, const float *radii, uint32_t count);
 // renderer_update_ui is declared in renderer_ui.h
 
 #endif
@@ -24,7 +24,7 @@ typedef struct
 	float animation_progress;
 	int animation_direction;
 	int is_animating;
-	int pad;
+	int hubId; // Hub the edge bends through in hub-spoke routing, -1 for none
 } CompEdge;
 
 typedef struct
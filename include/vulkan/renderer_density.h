@@ -0,0 +1,54 @@
+#ifndef RENDERER_DENSITY_H
+#define RENDERER_DENSITY_H
+
+#include "renderer.h"
+
+/**
+ * Create the density-splat overview resources: the accumulation buffer,
+ * the splat compute pipeline and the tone-mapping resolve pipeline.
+ *
+ * @param r The renderer instance (device, render pass and extent must exist)
+ */
+void renderer_density_init(Renderer *r);
+
+/**
+ * Point the splat descriptor at the current node instance buffer.
+ * Must be called whenever renderer_update_graph recreates that buffer.
+ *
+ * @param r The renderer instance
+ */
+void renderer_density_bind_nodes(Renderer *r);
+
+/**
+ * Whether this frame should draw the density heatmap instead of geometry.
+ * In DENSITY_MODE_AUTO this switches on past DENSITY_AUTO_NODE_THRESHOLD nodes.
+ *
+ * @param r The renderer instance
+ * @return true if the density overview replaces nodes, edges and labels
+ */
+bool renderer_density_active(const Renderer *r);
+
+/**
+ * Record the clear and splat dispatch. Must be recorded outside a render pass.
+ *
+ * @param r   The renderer instance
+ * @param cmd Command buffer being recorded for this frame
+ */
+void renderer_density_record_splat(Renderer *r, VkCommandBuffer cmd);
+
+/**
+ * Record the full-screen tone-mapped heatmap draw inside the main render pass.
+ *
+ * @param r   The renderer instance
+ * @param cmd Command buffer being recorded for this frame
+ */
+void renderer_density_record_resolve(Renderer *r, VkCommandBuffer cmd);
+
+/**
+ * Destroy all density overview resources.
+ *
+ * @param r The renderer instance
+ */
+void renderer_density_cleanup(Renderer *r);
+
+#endif
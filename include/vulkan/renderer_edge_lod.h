@@ -0,0 +1,50 @@
+#ifndef RENDERER_EDGE_LOD_H
+#define RENDERER_EDGE_LOD_H
+
+#include "renderer.h"
+
+/**
+ * Create the edge LOD accumulation resources: the offscreen image, its render pass
+ * and framebuffer, and the compositing pipeline. edgeAccumPipeline is created with
+ * the main pipelines.
+ *
+ * @param r The renderer instance (device, main render pass and texture sampler must exist)
+ */
+void renderer_edge_lod_init(Renderer *r);
+
+/**
+ * Advance the LOD for this frame and draw the buckets the accumulation image lacks.
+ * Camera motion drops to the moving subset and restarts the image; each still frame
+ * adds a refinement step, and once every bucket is in the image nothing is drawn.
+ * Must be recorded outside a render pass.
+ *
+ * @param r        The renderer instance
+ * @param cmd      Command buffer being recorded for this frame
+ * @param frameSet Descriptor set holding this frame's uniform buffer
+ */
+void renderer_edge_lod_record_accumulate(Renderer *r, VkCommandBuffer cmd, VkDescriptorSet frameSet);
+
+/**
+ * Record the full-screen composite of the accumulation image inside the main render pass.
+ *
+ * @param r    The renderer instance
+ * @param cmd  Command buffer being recorded for this frame
+ * @param fade Opacity of the detail edges (semantic zoom cross-fade)
+ */
+void renderer_edge_lod_record_composite(Renderer *r, VkCommandBuffer cmd, float fade);
+
+/**
+ * Discard the accumulated edges, e.g. after the edge vertices changed.
+ *
+ * @param r The renderer instance
+ */
+void renderer_edge_lod_invalidate(Renderer *r);
+
+/**
+ * Destroy all edge LOD accumulation resources.
+ *
+ * @param r The renderer instance
+ */
+void renderer_edge_lod_cleanup(Renderer *r);
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef RENDERER_FORCE_H
+#define RENDERER_FORCE_H
+
+#include "renderer.h"
+
+/**
+ * Create the GPU force layout pipeline and its descriptor set. If any step fails,
+ * the partial objects are destroyed and renderer_force_start returns false.
+ *
+ * @param r The renderer instance (device must exist)
+ */
+void renderer_force_init(Renderer *r);
+
+/**
+ * Start a force layout run from the graph's current positions: upload the
+ * positions and the CSR adjacency, and record FORCE_LAYOUT_ITERATIONS_PER_FRAME
+ * iterations per frame from now on.
+ *
+ * @param r     The renderer instance
+ * @param graph Graph currently uploaded by renderer_update_graph
+ * @return true if the run started
+ */
+bool renderer_force_start(Renderer *r, GraphData *graph);
+
+/**
+ * Point the layout at the current node instance and edge vertex buffers.
+ * Must be called whenever renderer_update_graph recreates them.
+ *
+ * @param r The renderer instance
+ */
+void renderer_force_bind_geometry(Renderer *r);
+
+/**
+ * Record this frame's layout iterations. Must be recorded outside a render pass.
+ *
+ * @param r   The renderer instance
+ * @param cmd Command buffer being recorded for this frame
+ */
+void renderer_force_record(Renderer *r, VkCommandBuffer cmd);
+
+/**
+ * Copy the GPU positions into the graph's nodes and layout matrix if they are
+ * ahead of it (waits for the device). A graph of a different size ends the run.
+ *
+ * @param r     The renderer instance
+ * @param graph Graph the run lays out
+ */
+void renderer_force_read_back(Renderer *r, GraphData *graph);
+
+/**
+ * Read back and end the current run.
+ *
+ * @param r     The renderer instance
+ * @param graph Graph the run lays out
+ */
+void renderer_force_stop(Renderer *r, GraphData *graph);
+
+/**
+ * Destroy all GPU force layout resources.
+ *
+ * @param r The renderer instance
+ */
+void renderer_force_cleanup(Renderer *r);
+
+#endif
@@ -0,0 +1,47 @@
+#version 450
+
+layout(std430, binding = 1) readonly buffer AccumBuffer
+{
+	uint accum[];
+};
+
+layout(push_constant) uniform PushConstants
+{
+	mat4 viewProj;
+	uint width;
+	uint height;
+	uint nodeCount;
+	uint nodeStride;
+	float exposure;
+	float fixedPoint;
+}
+pc;
+
+layout(location = 0) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+// Black-body style ramp: dark blue -> magenta -> orange -> pale yellow
+vec3 heatmap(float t)
+{
+	vec3 c0 = vec3(0.05, 0.03, 0.25);
+	vec3 c1 = vec3(0.65, 0.10, 0.55);
+	vec3 c2 = vec3(0.98, 0.55, 0.10);
+	vec3 c3 = vec3(1.00, 0.98, 0.75);
+	if (t < 0.33)
+		return mix(c0, c1, t / 0.33);
+	if (t < 0.66)
+		return mix(c1, c2, (t - 0.33) / 0.33);
+	return mix(c2, c3, (t - 0.66) / 0.34);
+}
+
+void main()
+{
+	uvec2 p = min(uvec2(fragUV * vec2(pc.width, pc.height)), uvec2(pc.width - 1u, pc.height - 1u));
+	float density = float(accum[p.y * pc.width + p.x]) / pc.fixedPoint;
+	if (density <= 0.0)
+		discard;
+
+	// Exponential tone map keeps single nodes visible and saturates dense cores smoothly
+	float t = 1.0 - exp(-density * pc.exposure);
+	outColor = vec4(heatmap(t), clamp(0.25 + t, 0.0, 1.0));
+}
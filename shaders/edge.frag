@@ -1,5 +1,11 @@
 #version 450
 
+layout(push_constant) uniform Constants
+{
+	float alpha; // Base edge alpha (EDGE_ALPHA, faded by the semantic zoom)
+}
+pc;
+
 layout(location = 0) in vec3 fragColor;
 layout(location = 1) in float fragSelected;
 layout(location = 2) in float fragAnimationProgress;
@@ -11,7 +17,7 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
-	float alpha = 0.8;
+	float alpha = pc.alpha;
 	vec3 finalColor = fragColor;
 
 	if (fragSelected > 0.5) {
@@ -0,0 +1,25 @@
+#version 450
+
+// Edge LOD accumulation image: premultiplied color of the bucket prefix drawn so far
+layout(binding = 0) uniform sampler2D accumImage;
+
+layout(push_constant) uniform Constants
+{
+	float fraction; // Share of the edge buckets in the image
+	float fade;		// Semantic zoom fade of the detail edges
+}
+pc;
+
+layout(location = 0) in vec2 fragUV;
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+	vec4 accum = texelFetch(accumImage, ivec2(gl_FragCoord.xy), 0);
+	if (accum.a <= 0.0)
+		discard;
+
+	// A fraction f of the edges covers a pixel like the full set at coverage 1-(1-a)^(1/f)
+	float alpha = 1.0 - pow(1.0 - accum.a, 1.0 / pc.fraction);
+	outColor = vec4(accum.rgb * (alpha / accum.a), alpha) * pc.fade;
+}
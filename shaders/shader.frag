@@ -3,6 +3,7 @@
 layout(push_constant) uniform Constants
 {
 	float alpha;
+	float wireframe; // 1.0 draws triangle outlines in this pass (single-pass mode)
 }
 pc;
 
@@ -14,6 +15,7 @@ layout(location = 2) in vec3 fragColor;
 layout(location = 3) in float fragGlow;
 layout(location = 4) in flat int fragDegree;
 layout(location = 5) in float fragSelected;
+layout(location = 6) in vec3 fragBarycentric;
 
 layout(location = 0) out vec4 outColor;
 
@@ -44,6 +46,16 @@ void main()
 	}
 
 	float finalAlpha = pc.alpha;
+
+	// Shader wireframe: opaque ~1.5px lines along the triangle edges, replacing the
+	// separate polygon-mode line pass
+	if (pc.wireframe > 0.5) {
+		vec3 bw = fwidth(fragBarycentric) * 1.5;
+		vec3 edge = smoothstep(vec3(0.0), bw, fragBarycentric);
+		float line = 1.0 - min(min(edge.x, edge.y), edge.z);
+		finalAlpha = mix(finalAlpha, min(1.0, 2.0 * pc.alpha), line); // Outlines fade with the faces
+	}
+
 	if (fragSelected > 0.5) {
 		finalAlpha = 1.0;
 	}
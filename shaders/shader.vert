@@ -24,6 +24,7 @@ layout(location = 2) out vec3 fragColor;
 layout(location = 3) out float fragGlow;
 layout(location = 4) out flat int fragDegree;
 layout(location = 5) out float fragSelected;
+layout(location = 6) out vec3 fragBarycentric;
 
 void main()
 {
@@ -53,4 +54,7 @@ void main()
 	fragGlow = instanceGlow;
 	fragDegree = instanceDegree;
 	fragSelected = instanceSelected;
+	// Platonic meshes give each triangle three unique, consecutive vertices (polyhedron.c add_tri)
+	int corner = gl_VertexIndex % 3;
+	fragBarycentric = vec3(corner == 0, corner == 1, corner == 2);
 }
\ No newline at end of file
@@ -7,14 +7,28 @@ layout(binding = 0) uniform UniformBufferObject
 }
 ubo;
 
+layout(push_constant) uniform PushConstants
+{
+	float layoutScale;
+}
+pc;
+
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inNormal;
 layout(location = 2) in vec2 inTexCoord;
 
+// Per-instance shell (unit icosphere scaled and offset here)
+layout(location = 3) in vec3 inCenter;
+layout(location = 4) in float inRadius;
+layout(location = 5) in float inAlpha;
+
 layout(location = 0) out vec3 fragNormal;
+layout(location = 1) out float fragAlpha;
 
 void main()
 {
-	gl_Position = ubo.proj * ubo.view * ubo.model * vec4(inPosition, 1.0);
+	vec3 worldPos = (inCenter + inPosition * inRadius) * pc.layoutScale;
+	gl_Position = ubo.proj * ubo.view * ubo.model * vec4(worldPos, 1.0);
 	fragNormal = inNormal;
+	fragAlpha = inAlpha;
 }
@@ -51,19 +51,21 @@ const CommandDef g_command_registry[] = {
 	// =========================================================================
 	// Layout menu - Force-Directed
 	// =========================================================================
-	{"Layout/Force-Directed", "igraph_layout_fruchterman_reingold_3d", "Fruchterman-Reingold (3D)", compute_igraph_layout_fruchterman_reingold_3d, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_fruchterman_reingold", "Fruchterman-Reingold (2D)", compute_igraph_layout_fruchterman_reingold, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_kamada_kawai_3d", "Kamada-Kawai (3D)", compute_igraph_layout_kamada_kawai_3d, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_kamada_kawai", "Kamada-Kawai (2D)", compute_igraph_layout_kamada_kawai, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_drl_3d", "Distributed Recursive Layout (DrL) (3D)", compute_igraph_layout_drl_3d, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_drl", "Distributed Recursive Layout (DrL) (2D)", compute_igraph_layout_drl, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_davidson_harel", "Davidson-Harel", compute_igraph_layout_davidson_harel, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_graphopt", "GraphOpt", compute_igraph_layout_graphopt, apply_layout_matrix, free_layout_matrix},
+	{"Layout/Force-Directed", "igraph_layout_fruchterman_reingold_3d", "Fruchterman-Reingold (3D)", compute_igraph_layout_fruchterman_reingold_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_fruchterman_reingold", "Fruchterman-Reingold (2D)", compute_igraph_layout_fruchterman_reingold, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_kamada_kawai_3d", "Kamada-Kawai (3D)", compute_igraph_layout_kamada_kawai_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_kamada_kawai", "Kamada-Kawai (2D)", compute_igraph_layout_kamada_kawai, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_drl_3d", "Distributed Recursive Layout (DrL) (3D)", compute_igraph_layout_drl_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_drl", "Distributed Recursive Layout (DrL) (2D)", compute_igraph_layout_drl, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_davidson_harel", "Davidson-Harel", compute_igraph_layout_davidson_harel, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_graphopt", "GraphOpt", compute_igraph_layout_graphopt, apply_layout_matrix, free_layout_matrix, true},
 	{"Layout/Force-Directed", "igraph_layout_lgl", "Large Graph Layout (LGL)", compute_igraph_layout_lgl, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_gem", "GEM", compute_igraph_layout_gem, apply_layout_matrix_centered, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_forceatlas2_3d", "ForceAtlas2 (3D)", compute_igraph_layout_forceatlas2_3d, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_yifan_hu", "Yifan Hu", compute_igraph_layout_yifan_hu, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Force-Directed", "igraph_layout_yifan_hu_3d", "Yifan Hu (3D)", compute_igraph_layout_yifan_hu_3d, apply_layout_matrix, free_layout_matrix},
+	{"Layout/Force-Directed", "igraph_layout_gem", "GEM", compute_igraph_layout_gem, apply_layout_matrix_centered, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_forceatlas2_3d", "ForceAtlas2 (3D)", compute_igraph_layout_forceatlas2_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_yifan_hu", "Yifan Hu", compute_igraph_layout_yifan_hu, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "igraph_layout_yifan_hu_3d", "Yifan Hu (3D)", compute_igraph_layout_yifan_hu_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "layout_barnes_hut_3d", "Barnes-Hut (3D)", compute_layout_barnes_hut_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Force-Directed", "layout_stress_3d", "Sparse Stress (3D)", compute_layout_stress_3d, apply_layout_matrix, free_layout_matrix, true},
 
 	// =========================================================================
 	// Layout menu - Tree & Hierarchical
@@ -73,7 +75,7 @@ const CommandDef g_command_registry[] = {
 	{"Layout/Tree & Hierarchical", "igraph_layout_sugiyama_radial", "Radial Sugiyama", compute_igraph_layout_sugiyama_radial, apply_layout_matrix, free_layout_matrix},
 
 	// Non-Igraph
-	{"Layout", "lay_layered_sphere", "Layered Sphere", compute_layout_layered_sphere, apply_layout_matrix, free_layout_matrix},
+	{"Layout", "lay_layered_sphere", "Layered Sphere", compute_layout_layered_sphere, apply_layout_layered_sphere, free_layout_layered_sphere},
 	// =========================================================================
 	// Layout menu - Geometric
 	// =========================================================================
@@ -89,15 +91,17 @@ const CommandDef g_command_registry[] = {
 	// =========================================================================
 	// Layout menu - Bipartite Layouts
 	// =========================================================================
-	{"Layout/Bipartite", "igraph_layout_mds", "MDS", compute_igraph_layout_mds, apply_layout_matrix, free_layout_matrix},
+	{"Layout/Bipartite", "layout_pivot_mds_3d", "Pivot MDS (3D)", compute_layout_pivot_mds_3d, apply_layout_matrix, free_layout_matrix},
 	{"Layout/Bipartite", "igraph_layout_bipartite", "Sugiyama (Bipartite)", compute_igraph_layout_bipartite, apply_layout_matrix, free_layout_matrix},
 	{"Layout/Bipartite", "igraph_layout_bipartite_simple", "Bipartite (Simple)", compute_igraph_layout_bipartite_simple, apply_layout_matrix, free_layout_matrix},
 
 	// =========================================================================
 	// Layout menu - Graph Embedding
 	// =========================================================================
-	{"Layout/Dimension Reduction ", "igraph_layout_umap_2d", "UMAP (2D)", compute_igraph_layout_umap, apply_layout_matrix, free_layout_matrix},
-	{"Layout/Dimension Reduction ", "igraph_layout_umap_3d", "UMAP (3D)", compute_igraph_layout_umap_3d, apply_layout_matrix, free_layout_matrix},
+	{"Layout/Dimension Reduction ", "igraph_layout_umap_2d", "UMAP (2D)", compute_igraph_layout_umap, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Dimension Reduction ", "igraph_layout_umap_3d", "UMAP (3D)", compute_igraph_layout_umap_3d, apply_layout_matrix, free_layout_matrix, true},
+	{"Layout/Dimension Reduction ", "layout_hde_3d", "High-Dimensional Embedding (3D)", compute_layout_hde_3d, apply_layout_matrix, free_layout_matrix},
+	{"Layout/Dimension Reduction ", "layout_spectral_3d", "Spectral (3D)", compute_layout_spectral_3d, apply_layout_matrix, free_layout_matrix},
 
 	// =========================================================================
 	// Analysis menu - Centrality & Roles
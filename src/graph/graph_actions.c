@@ -4,18 +4,108 @@
 #include "graph/graph_filter.h"
 #include "graph/graph_io.h"
 #include "graph/graph_layout.h"
+#include "graph/layered_sphere.h"
+#include "graph/layout_barnes_hut.h"
 #include "graph/layout_openord.h"
+#include "graph/layout_scheduler.h"
+#include "graph/layout_thread.h"
 #include "vulkan/animation_manager.h"
 #include "vulkan/renderer.h"
+#include "vulkan/renderer_force.h"
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+void graph_action_stop_layout(AppState *state)
+{
+	layout_thread_stop(&state->layout_thread, &state->current_graph);
+	renderer_force_stop(&state->renderer, &state->current_graph);
+}
+
+// A finished layered sphere run: one shell per occupied sphere, then its state is kept so the
+// next run only re-optimizes what changed
+static void finish_layered_sphere(AppState *state)
+{
+	uint32_t count = 0;
+	float *radii = layered_sphere_shell_radii(&state->current_graph, &count);
+	renderer_update_spheres(&state->renderer, (vec3){0.0f, 0.0f, 0.0f}, radii, count);
+	free(radii);
+	layered_sphere_finish(&state->current_graph);
+}
+
 void graph_action_update_layout(AppState *state)
 {
-	graph_layout_step(&state->current_graph, state->current_layout, 50);
+	graph_action_stop_layout(state);
+	layout_scheduler_reset(&state->layout_scheduler);
+	// Without the compute pipeline the same force model runs on the CPU, as Barnes-Hut under the scheduler
+	if (state->current_layout == LAYOUT_GPU_FORCE_3D && !renderer_force_start(&state->renderer, &state->current_graph)) {
+		printf("[Layout] GPU force layout unavailable, running Barnes-Hut\n");
+		state->current_layout = LAYOUT_BARNES_HUT_3D;
+	}
+	// A finished Barnes-Hut run starts over from the current positions
+	BarnesHutContext *bh = state->current_graph.barnes_hut;
+	if (state->current_layout == LAYOUT_BARNES_HUT_3D && bh && bh->iteration >= bh->max_iterations) {
+		barnes_hut_cleanup(bh);
+		free(bh);
+		state->current_graph.barnes_hut = NULL;
+	}
+	renderer_update_spheres(&state->renderer, (vec3){0.0f, 0.0f, 0.0f}, NULL, 0);
+	// OpenOrd, Barnes-Hut and the layered sphere continue frame by frame under the scheduler
+	// (graph_action_step_background_layout), the GPU layout iterates inside the frame's command
+	// buffer, FR and UMAP converge on the layout thread, the rest run here in one go
+	if (state->current_layout == LAYOUT_OPENORD_3D || state->current_layout == LAYOUT_BARNES_HUT_3D)
+		graph_layout_step(&state->current_graph, state->current_layout, 1);
+	else if (state->current_layout == LAYOUT_LAYERED_SPHERE_3D) {
+		// Only sets the run up (a finished one starts over from its retained state): the first
+		// pass, community detection, is what the scheduler measures first
+		if (!layered_sphere_unfinished(&state->current_graph))
+			layered_sphere_finish(&state->current_graph);
+		graph_layout_step(&state->current_graph, state->current_layout, 0);
+		// Nothing changed since the retained run
+		if (state->current_graph.layered_sphere_run && !layered_sphere_unfinished(&state->current_graph)) {
+			finish_layered_sphere(state);
+			graph_action_post_process_layout(state);
+		}
+	} else if (state->current_layout == LAYOUT_GPU_FORCE_3D) {
+		// Started above; the run iterates in the frame's command buffer
+	} else if (!layout_thread_start(&state->layout_thread, &state->current_graph, state->current_layout)) {
+		graph_layout_step(&state->current_graph, state->current_layout, 50);
+		graph_action_post_process_layout(state);
+	}
+	renderer_update_graph(&state->renderer, &state->current_graph);
+}
+
+void graph_action_remove_overlaps(AppState *state)
+{
+	graph_action_stop_layout(state);
+	int passes = graph_remove_overlaps(&state->current_graph, state->renderer.layoutScale, 0.0);
+	printf("[Overlap Removal] %d passes\n", passes);
 	renderer_update_graph(&state->renderer, &state->current_graph);
 }
 
+void graph_action_post_process_layout(AppState *state)
+{
+	// Layered sphere nodes sit on their shells (shown while numSpheres > 0); pushing them apart
+	// would move them off
+	if (state->remove_overlaps && state->renderer.numSpheres == 0)
+		graph_remove_overlaps(&state->current_graph, state->renderer.layoutScale, OVERLAP_POST_PROCESS_BUDGET_MS);
+	graph_action_update_hubs(state);
+}
+
+void graph_action_update_hubs(AppState *state)
+{
+	GraphData *graph = &state->current_graph;
+	if (state->renderer.currentRoutingMode != ROUTING_MODE_HUB_SPOKE || !graph->graph_initialized || graph->edge_count == 0)
+		return;
+	int num_hubs = (int)sqrtf((float)graph->edge_count);
+	if (num_hubs > HUB_MAX_COUNT)
+		num_hubs = HUB_MAX_COUNT;
+	if (num_hubs < 1)
+		num_hubs = 1;
+	graph_generate_hubs(graph, num_hubs);
+}
+
 void graph_action_run_clustering(AppState *state)
 {
 	graph_cluster(&state->current_graph, state->current_cluster);
@@ -24,19 +114,26 @@ void graph_action_run_clustering(AppState *state)
 
 void graph_action_run_iteration(AppState *state)
 {
+	graph_action_stop_layout(state);
 	graph_layout_step(&state->current_graph, state->current_layout, 1);
 	renderer_update_graph(&state->renderer, &state->current_graph);
 }
 
 void graph_action_filter_degree(AppState *state, int min_deg)
 {
+	graph_action_stop_layout(state);
+	layout_scheduler_reset(&state->layout_scheduler);
 	graph_filter_degree(&state->current_graph, min_deg);
+	graph_action_update_hubs(state);
 	renderer_update_graph(&state->renderer, &state->current_graph);
 }
 
 void graph_action_filter_coreness(AppState *state, int min_core)
 {
+	graph_action_stop_layout(state);
+	layout_scheduler_reset(&state->layout_scheduler);
 	graph_filter_coreness(&state->current_graph, min_core);
+	graph_action_update_hubs(state);
 	renderer_update_graph(&state->renderer, &state->current_graph);
 }
 
@@ -48,20 +145,73 @@ void graph_action_highlight_infrastructure(AppState *state)
 
 void graph_action_reset(AppState *state)
 {
+	graph_action_stop_layout(state);
+	layout_scheduler_reset(&state->layout_scheduler);
 	graph_free_data(&state->current_graph);
+	renderer_update_spheres(&state->renderer, (vec3){0.0f, 0.0f, 0.0f}, NULL, 0);
 	state->current_layout = LAYOUT_OPENORD_3D;
 	state->renderer.layoutScale = 1.0f;
 	state->current_graph.props.coreness_filter = 0;
 
-	if (graph_load_graphml(state->current_filename, &state->current_graph, state->current_layout, state->node_attr, state->edge_attr) == 0) {
+	if (graph_load_graphml(state->current_filename, &state->current_graph, state->current_layout, state->initial_layout, state->node_attr, state->edge_attr) == 0) {
+		graph_action_update_hubs(state);
 		renderer_update_graph(&state->renderer, &state->current_graph);
 	}
 }
 
+// Only valid while the layout thread is idle (it owns the stepped contexts while busy)
+static bool stepped_layout_unfinished(AppState *state)
+{
+	GraphData *graph = &state->current_graph;
+	if (state->current_layout == LAYOUT_OPENORD_3D)
+		return graph->openord && graph->openord->stage_id < 5;
+	if (state->current_layout == LAYOUT_BARNES_HUT_3D)
+		return graph->barnes_hut && graph->barnes_hut->iteration < graph->barnes_hut->max_iterations;
+	if (state->current_layout == LAYOUT_LAYERED_SPHERE_3D)
+		return layered_sphere_unfinished(graph);
+	return false;
+}
+
 bool graph_action_step_background_layout(AppState *state)
 {
-	if (state->current_layout == LAYOUT_OPENORD_3D && state->current_graph.openord && state->current_graph.openord->stage_id < 5) {
-		graph_layout_step(&state->current_graph, state->current_layout, 1);
+	LayoutThread *lt = &state->layout_thread;
+	LayoutScheduler *sched = &state->layout_scheduler;
+
+	// Unfinished OpenOrd / Barnes-Hut / layered sphere with the thread idle: run as many iterations as fit into
+	// the frame budget, or hand the run to the layout thread once a single iteration doesn't fit
+	if (!layout_thread_is_busy(lt) && !lt->pending_final && stepped_layout_unfinished(state)) {
+		int iterations = layout_scheduler_plan(sched);
+		if (iterations > 0 || !layout_thread_start(lt, &state->current_graph, state->current_layout)) {
+			if (iterations == 0)
+				iterations = 1; // No layout thread: one iteration per frame at worst
+			double start = layout_scheduler_now_ms();
+			graph_layout_step(&state->current_graph, state->current_layout, iterations);
+			layout_scheduler_record(sched, iterations, layout_scheduler_now_ms() - start);
+			if (!stepped_layout_unfinished(state)) {
+				if (state->current_layout == LAYOUT_LAYERED_SPHERE_3D)
+					finish_layered_sphere(state);
+				graph_action_post_process_layout(state);
+			}
+			renderer_update_graph(&state->renderer, &state->current_graph);
+			return true;
+		}
+	}
+
+	// A finished GPU run: bring its positions into the graph and rebuild the geometry around them
+	if (state->renderer.forceDirty && !state->renderer.forceRunning) {
+		renderer_force_read_back(&state->renderer, &state->current_graph);
+		graph_action_post_process_layout(state);
+		renderer_update_graph(&state->renderer, &state->current_graph);
+		return true;
+	}
+
+	// Pick up the latest published positions, at most once per frame
+	bool final = !layout_thread_is_busy(lt) && lt->pending_final;
+	if (layout_thread_consume(lt, &state->current_graph)) {
+		if (final && lt->layout == LAYOUT_LAYERED_SPHERE_3D && !layered_sphere_unfinished(&state->current_graph))
+			finish_layered_sphere(state);
+		if (final)
+			graph_action_post_process_layout(state);
 		renderer_update_graph(&state->renderer, &state->current_graph);
 		return true;
 	}
@@ -83,6 +233,7 @@ void graph_action_cycle_cluster(AppState *state)
 void graph_action_cycle_community_arrangement(AppState *state)
 {
 	state->current_comm_arrangement = (state->current_comm_arrangement + 1) % COMMUNITY_ARRANGEMENT_COUNT;
+	graph_action_stop_layout(state);
 	if (state->current_comm_arrangement == COMMUNITY_ARRANGEMENT_NONE) {
 		graph_action_update_layout(state);
 	} else {
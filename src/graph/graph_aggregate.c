@@ -0,0 +1,121 @@
+#include "graph/graph_aggregate.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Pack an unordered community pair into one sortable key
+static uint64_t meta_edge_key(int a, int b)
+{
+	uint32_t lo = (uint32_t)(a < b ? a : b);
+	uint32_t hi = (uint32_t)(a < b ? b : a);
+	return ((uint64_t)lo << 32) | hi;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+	return (x > y) - (x < y);
+}
+
+CommunityAggregate *graph_aggregate_build(const GraphData *data, const igraph_vector_int_t *membership)
+{
+	if (!data->nodes || igraph_vector_int_size(membership) != data->node_count)
+		return NULL;
+
+	CommunityAggregate *agg = calloc(1, sizeof(CommunityAggregate));
+	agg->node_count = data->node_count;
+	agg->membership = malloc(sizeof(int) * (data->node_count + 1));
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		agg->membership[i] = (int)VECTOR(*membership)[i];
+		if (agg->membership[i] + 1 > agg->community_count)
+			agg->community_count = agg->membership[i] + 1;
+	}
+
+	agg->population = calloc(agg->community_count + 1, sizeof(int));
+	agg->centroids = calloc(agg->community_count + 1, sizeof(vec3));
+	agg->colors = calloc(agg->community_count + 1, sizeof(vec3));
+	agg->spread = calloc(agg->community_count + 1, sizeof(float));
+	for (uint32_t i = 0; i < data->node_count; i++)
+		agg->population[agg->membership[i]]++;
+
+	// Collapse inter-community edges: sort pair keys, then run-length count them
+	uint64_t *keys = malloc(sizeof(uint64_t) * (data->edge_count + 1));
+	int key_count = 0;
+	for (uint32_t e = 0; e < data->edge_count; e++) {
+		int ca = agg->membership[data->edges[e].from];
+		int cb = agg->membership[data->edges[e].to];
+		if (ca != cb)
+			keys[key_count++] = meta_edge_key(ca, cb);
+	}
+	qsort(keys, key_count, sizeof(uint64_t), compare_u64);
+
+	agg->meta_edges = malloc(sizeof(MetaEdge) * (key_count + 1));
+	for (int k = 0; k < key_count;) {
+		int run = 1;
+		while (k + run < key_count && keys[k + run] == keys[k])
+			run++;
+		MetaEdge *me = &agg->meta_edges[agg->meta_edge_count++];
+		me->from = (int)(keys[k] >> 32);
+		me->to = (int)(keys[k] & 0xFFFFFFFFu);
+		me->weight = run;
+		if (run > agg->max_meta_weight)
+			agg->max_meta_weight = run;
+		k += run;
+	}
+	free(keys);
+
+	graph_aggregate_update(agg, data);
+	return agg;
+}
+
+bool graph_aggregate_update(CommunityAggregate *agg, const GraphData *data)
+{
+	if (!agg || !data->nodes || data->node_count != agg->node_count)
+		return false;
+
+	memset(agg->centroids, 0, sizeof(vec3) * agg->community_count);
+	memset(agg->colors, 0, sizeof(vec3) * agg->community_count);
+	memset(agg->spread, 0, sizeof(float) * agg->community_count);
+
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		int c = agg->membership[i];
+		glm_vec3_add(agg->centroids[c], (float *)data->nodes[i].position, agg->centroids[c]);
+		glm_vec3_add(agg->colors[c], (float *)data->nodes[i].color, agg->colors[c]);
+	}
+	for (int c = 0; c < agg->community_count; c++) {
+		if (agg->population[c] == 0)
+			continue;
+		float inv = 1.0f / (float)agg->population[c];
+		glm_vec3_scale(agg->centroids[c], inv, agg->centroids[c]);
+		glm_vec3_scale(agg->colors[c], inv, agg->colors[c]);
+	}
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		int c = agg->membership[i];
+		agg->spread[c] += glm_vec3_distance2(agg->centroids[c], (float *)data->nodes[i].position);
+	}
+	for (int c = 0; c < agg->community_count; c++) {
+		if (agg->population[c] > 0)
+			agg->spread[c] = sqrtf(agg->spread[c] / (float)agg->population[c]);
+	}
+	return true;
+}
+
+void graph_aggregate_set(GraphData *data, const igraph_vector_int_t *membership)
+{
+	graph_aggregate_free(data->aggregate);
+	data->aggregate = graph_aggregate_build(data, membership);
+}
+
+void graph_aggregate_free(CommunityAggregate *agg)
+{
+	if (!agg)
+		return;
+	free(agg->membership);
+	free(agg->population);
+	free(agg->centroids);
+	free(agg->colors);
+	free(agg->spread);
+	free(agg->meta_edges);
+	free(agg);
+}
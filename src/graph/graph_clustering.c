@@ -5,15 +5,48 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "graph/graph_aggregate.h"
 #include "graph/graph_core.h"
+#include "graph/graph_rng.h"
 #include "graph/graph_types.h"
 
-// Helper structure for community arrangement
+// A node's color with its index, sorted to group graphs colored without a stored membership
 typedef struct
 {
-	int start_idx;
-	int end_idx;
-} CommBlock;
+	vec3 color;
+	int node;
+} NodeColorKey;
+
+static int compare_node_colors(const void *a, const void *b)
+{
+	const NodeColorKey *ka = a;
+	const NodeColorKey *kb = b;
+	for (int k = 0; k < 3; k++) {
+		if (ka->color[k] != kb->color[k])
+			return (ka->color[k] > kb->color[k]) - (ka->color[k] < kb->color[k]);
+	}
+	return ka->node - kb->node;
+}
+
+// One community per distinct node color; returns the community count
+static int membership_from_colors(const GraphData *data, int *membership)
+{
+	NodeColorKey *keys = malloc(sizeof(NodeColorKey) * (data->node_count + 1));
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		glm_vec3_copy((float *)data->nodes[i].color, keys[i].color);
+		keys[i].node = (int)i;
+	}
+	qsort(keys, data->node_count, sizeof(NodeColorKey), compare_node_colors);
+
+	int count = 0;
+	for (uint32_t i = 0; i < data->node_count; i++) {
+		if (i > 0 && memcmp(keys[i].color, keys[i - 1].color, sizeof(vec3)) != 0)
+			count++;
+		membership[keys[i].node] = count;
+	}
+	free(keys);
+	return data->node_count > 0 ? count + 1 : 0;
+}
 
 void graph_cluster(GraphData *data, ClusterType type)
 {
@@ -101,9 +134,9 @@ void graph_cluster(GraphData *data, ClusterType type)
 
 	vec3 *colors = malloc(sizeof(vec3) * cluster_count);
 	for (int i = 0; i < cluster_count; i++) {
-		colors[i][0] = (float)rand() / RAND_MAX;
-		colors[i][1] = (float)rand() / RAND_MAX;
-		colors[i][2] = (float)rand() / RAND_MAX;
+		colors[i][0] = graph_rng_float(GRAPH_RNG_STREAM_CLUSTER_COLOR, i, 0);
+		colors[i][1] = graph_rng_float(GRAPH_RNG_STREAM_CLUSTER_COLOR, i, 1);
+		colors[i][2] = graph_rng_float(GRAPH_RNG_STREAM_CLUSTER_COLOR, i, 2);
 	}
 	for (int i = 0; i < data->node_count; i++) {
 		int c_idx = VECTOR(membership)[i];
@@ -114,6 +147,7 @@ void graph_cluster(GraphData *data, ClusterType type)
 		igraph_vector_destroy(&node_weights_vec);
 		igraph_vector_destroy(&weights_vec);
 	}
+	graph_aggregate_set(data, &membership);
 	free(colors);
 	free(cluster_sizes);
 	igraph_vector_int_destroy(&membership);
@@ -132,44 +166,59 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 		old_pos[i][2] = MATRIX(data->current_layout, i, 2);
 	}
 
-	// 1. Sort nodes by community color to group them
-	int *indices = malloc(sizeof(int) * data->node_count);
-	for (int i = 0; i < data->node_count; i++)
-		indices[i] = i;
-
-	for (int i = 0; i < data->node_count - 1; i++) {
-		for (int j = i + 1; j < data->node_count; j++) {
-			float sum_i = data->nodes[indices[i]].color[0] + data->nodes[indices[i]].color[1] * 10 + data->nodes[indices[i]].color[2] * 100;
-			float sum_j = data->nodes[indices[j]].color[0] + data->nodes[indices[j]].color[1] * 10 + data->nodes[indices[j]].color[2] * 100;
-			if (sum_j < sum_i) {
-				int temp = indices[i];
-				indices[i] = indices[j];
-				indices[j] = temp;
-			}
-		}
+	// 1. Group nodes by community (counting sort), falling back to one community per color
+	uint32_t n = data->node_count;
+	int *fallback = NULL;
+	const CommunityAggregate *agg = data->aggregate;
+	const int *membership = agg && agg->node_count == n ? agg->membership : NULL;
+	int num_blocks = membership ? agg->community_count : 0;
+	if (!membership) {
+		fallback = malloc(sizeof(int) * n);
+		num_blocks = membership_from_colors(data, fallback);
+		membership = fallback;
 	}
 
-	// 2. Map out the start and end indices of each distinct community
-	CommBlock *blocks = malloc(sizeof(CommBlock) * data->node_count);
-	int num_blocks = 0;
-	int current_start = 0;
-
-	while (current_start < data->node_count) {
-		int current_end = current_start;
-		float current_sum = data->nodes[indices[current_start]].color[0] + data->nodes[indices[current_start]].color[1] * 10 + data->nodes[indices[current_start]].color[2] * 100;
+	int *block_start = calloc(num_blocks + 1, sizeof(int));
+	for (uint32_t i = 0; i < n; i++)
+		block_start[membership[i] + 1]++;
+	for (int b = 0; b < num_blocks; b++)
+		block_start[b + 1] += block_start[b];
+
+	int *indices = malloc(sizeof(int) * n);
+	int *position = malloc(sizeof(int) * n); // Index of each node in indices
+	int *fill = malloc(sizeof(int) * (num_blocks + 1));
+	memcpy(fill, block_start, sizeof(int) * (num_blocks + 1));
+	for (uint32_t i = 0; i < n; i++) {
+		position[i] = fill[membership[i]]++;
+		indices[position[i]] = (int)i;
+	}
 
-		while (current_end < data->node_count) {
-			float sum = data->nodes[indices[current_end]].color[0] + data->nodes[indices[current_end]].color[1] * 10 + data->nodes[indices[current_end]].color[2] * 100;
-			if (fabs(sum - current_sum) > 0.01f)
-				break;
-			current_end++;
+	// 2. Intra-community adjacency as CSR over positions in indices, neighbors stored as local
+	// indices within their block
+	int *adj_offsets = calloc(n + 1, sizeof(int));
+	for (uint32_t e = 0; e < data->edge_count; e++) {
+		uint32_t a = data->edges[e].from, b = data->edges[e].to;
+		if (a != b && membership[a] == membership[b]) {
+			adj_offsets[position[a] + 1]++;
+			adj_offsets[position[b] + 1]++;
+		}
+	}
+	for (uint32_t p = 0; p < n; p++)
+		adj_offsets[p + 1] += adj_offsets[p];
+	int *adj_local = malloc(sizeof(int) * (adj_offsets[n] + 1));
+	int *adj_fill = malloc(sizeof(int) * (n + 1));
+	memcpy(adj_fill, adj_offsets, sizeof(int) * (n + 1));
+	for (uint32_t e = 0; e < data->edge_count; e++) {
+		uint32_t a = data->edges[e].from, b = data->edges[e].to;
+		if (a != b && membership[a] == membership[b]) {
+			int base = block_start[membership[a]];
+			adj_local[adj_fill[position[a]]++] = position[b] - base;
+			adj_local[adj_fill[position[b]]++] = position[a] - base;
 		}
-
-		blocks[num_blocks].start_idx = current_start;
-		blocks[num_blocks].end_idx = current_end;
-		num_blocks++;
-		current_start = current_end;
 	}
+	free(adj_fill);
+	free(fill);
+	free(position);
 
 	// Use smaller spacing so the local communities don't expand into each other
 	float primary_spacing = 0.5f;
@@ -177,11 +226,13 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 	float grid_spacing = 0.5f;
 
 // 3. Process each community locally in PARALLEL
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic)
 	for (int b = 0; b < num_blocks; b++) {
-		int s_idx = blocks[b].start_idx;
-		int e_idx = blocks[b].end_idx;
+		int s_idx = block_start[b];
+		int e_idx = block_start[b + 1];
 		int comm_size = e_idx - s_idx;
+		if (comm_size == 0)
+			continue;
 
 		// Calculate the physical centroid of this community in the current layout
 		vec3 centroid = {0, 0, 0};
@@ -233,6 +284,13 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 			vec3 *grid_pos = malloc(sizeof(vec3) * comm_size);
 			vec3 *target_pos = malloc(sizeof(vec3) * comm_size);
 
+			// Grid cells are unique and stay inside the grid_size box (targets are rounded
+			// neighbor means), so a dense cell index answers "who sits there" in O(1)
+			int cell_count = grid_size * grid_size * (is_3d ? grid_size : 1);
+			int *cell_occupant = malloc(sizeof(int) * cell_count);
+			for (int c = 0; c < cell_count; c++)
+				cell_occupant[c] = -1;
+
 			// Initialize local grid layout
 			for (int i = 0; i < comm_size; i++) {
 				if (is_3d) {
@@ -244,6 +302,7 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 					grid_pos[i][1] = (i / grid_size);
 					grid_pos[i][2] = 0.0f;
 				}
+				cell_occupant[i] = i;
 			}
 
 			// Local Simulated Annealing
@@ -253,33 +312,15 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 
 			for (int iter = 0; iter < iterations && temperature > 0.2f; iter++) {
 				for (int i = 0; i < comm_size; i++) {
-					int u = indices[s_idx + i];
 					vec3 desired_pos = {0};
-					int neighbor_count = 0;
-
-					// Find internal neighbors within the same community block
-					for (uint32_t e = 0; e < data->edge_count; e++) {
-						int v_global = -1;
-						if (data->edges[e].from == u)
-							v_global = data->edges[e].to;
-						else if (data->edges[e].to == u)
-							v_global = data->edges[e].from;
-
-						if (v_global != -1) {
-							int v_local = -1;
-							for (int j = 0; j < comm_size; j++) {
-								if (indices[s_idx + j] == v_global) {
-									v_local = j;
-									break;
-								}
-							}
-							if (v_local != -1) {
-								desired_pos[0] += grid_pos[v_local][0];
-								desired_pos[1] += grid_pos[v_local][1];
-								desired_pos[2] += grid_pos[v_local][2];
-								neighbor_count++;
-							}
-						}
+					int neighbor_count = adj_offsets[s_idx + i + 1] - adj_offsets[s_idx + i];
+
+					// Internal neighbors, from the community-local CSR slice
+					for (int e = adj_offsets[s_idx + i]; e < adj_offsets[s_idx + i + 1]; e++) {
+						int v_local = adj_local[e];
+						desired_pos[0] += grid_pos[v_local][0];
+						desired_pos[1] += grid_pos[v_local][1];
+						desired_pos[2] += grid_pos[v_local][2];
 					}
 
 					if (neighbor_count > 0) {
@@ -292,23 +333,21 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 					}
 				}
 
-				// Resolve Collisions
+				// Resolve Collisions: swap with the target cell's occupant, or move into it if free
 				for (int i = 0; i < comm_size; i++) {
-					int swap_target = -1;
-					for (int j = 0; j < comm_size; j++) {
-						if (i != j && grid_pos[j][0] == target_pos[i][0] && grid_pos[j][1] == target_pos[i][1] && grid_pos[j][2] == target_pos[i][2]) {
-							swap_target = j;
-							break;
-						}
-					}
+					int own_cell = ((int)grid_pos[i][2] * grid_size + (int)grid_pos[i][1]) * grid_size + (int)grid_pos[i][0];
+					int target_cell = ((int)target_pos[i][2] * grid_size + (int)target_pos[i][1]) * grid_size + (int)target_pos[i][0];
+					int swap_target = cell_occupant[target_cell];
+					if (swap_target == i)
+						continue;
 					if (swap_target != -1) {
-						vec3 temp;
-						glm_vec3_copy(grid_pos[i], temp);
-						glm_vec3_copy(grid_pos[swap_target], grid_pos[i]);
-						glm_vec3_copy(temp, grid_pos[swap_target]);
+						glm_vec3_copy(grid_pos[i], grid_pos[swap_target]);
+						cell_occupant[own_cell] = swap_target;
 					} else {
-						glm_vec3_copy(target_pos[i], grid_pos[i]);
+						cell_occupant[own_cell] = -1;
 					}
+					glm_vec3_copy(target_pos[i], grid_pos[i]);
+					cell_occupant[target_cell] = i;
 				}
 				temperature *= cooling_rate;
 			}
@@ -325,10 +364,14 @@ void graph_apply_community_arrangement(GraphData *data, CommunityArrangementMode
 
 			free(grid_pos);
 			free(target_pos);
+			free(cell_occupant);
 		}
 	}
 
-	free(blocks);
+	free(block_start);
+	free(adj_offsets);
+	free(adj_local);
+	free(fallback);
 	free(old_pos);
 	free(indices);
 	graph_sync_node_positions(data);
@@ -6,6 +6,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "graph/graph_aggregate.h"
+#include "graph/graph_rng.h"
+#include "graph/layered_sphere.h"
+#include "graph/layout_barnes_hut.h"
 #include "graph/layout_openord.h"
 
 void graph_init(GraphData *data)
@@ -33,6 +37,14 @@ void graph_refresh_data(GraphData *data)
 	data->props.node_count = (int)data->node_count;
 	data->props.edge_count = (int)data->edge_count;
 
+	// Node ids and colors are rebuilt, so the old community aggregate no longer applies
+	graph_aggregate_free(data->aggregate);
+	data->aggregate = NULL;
+
+	// The hubs stay as a warm start, but the edge assignment refers to the old edges
+	free(data->edge_hubs);
+	data->edge_hubs = NULL;
+
 	// Re-calculate basic node properties
 	if (data->nodes) {
 		for (uint32_t i = 0; i < data->node_count; i++)
@@ -60,9 +72,9 @@ void graph_refresh_data(GraphData *data)
 	igraph_coreness(&data->g, &coreness, IGRAPH_ALL);
 
 	for (int i = 0; i < data->node_count; i++) {
-		data->nodes[i].color[0] = (float)rand() / RAND_MAX;
-		data->nodes[i].color[1] = (float)rand() / RAND_MAX;
-		data->nodes[i].color[2] = (float)rand() / RAND_MAX;
+		data->nodes[i].color[0] = graph_rng_float(GRAPH_RNG_STREAM_NODE_COLOR, i, 0);
+		data->nodes[i].color[1] = graph_rng_float(GRAPH_RNG_STREAM_NODE_COLOR, i, 1);
+		data->nodes[i].color[2] = graph_rng_float(GRAPH_RNG_STREAM_NODE_COLOR, i, 2);
 		data->nodes[i].size = (has_node_attr && max_n_val > 0) ? (float)VAN(&data->g, data->node_attr_name, i) / max_n_val : 1.0f;
 		data->nodes[i].label = has_label ? strdup(VAS(&data->g, "label", i)) : NULL;
 		igraph_vector_int_t neighbors;
@@ -107,6 +119,12 @@ void graph_free_data(GraphData *data)
 		free(data->openord);
 		data->openord = NULL;
 	}
+	if (data->barnes_hut) {
+		barnes_hut_cleanup(data->barnes_hut);
+		free(data->barnes_hut);
+		data->barnes_hut = NULL;
+	}
+	layered_sphere_forget(data);
 	if (data->node_attr_name) {
 		free(data->node_attr_name);
 		data->node_attr_name = NULL;
@@ -119,6 +137,11 @@ void graph_free_data(GraphData *data)
 		free(data->hubs);
 		data->hubs = NULL;
 	}
+	data->hub_count = 0;
+	free(data->edge_hubs);
+	data->edge_hubs = NULL;
+	graph_aggregate_free(data->aggregate);
+	data->aggregate = NULL;
 	for (uint32_t i = 0; i < data->node_count; i++) {
 		if (data->nodes && data->nodes[i].label)
 			free(data->nodes[i].label);
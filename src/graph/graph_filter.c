@@ -2,11 +2,14 @@
 #include "graph/graph_filter.h"
 
 #include <math.h>
+#include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "graph/graph_core.h"
+#include "graph/graph_rng.h"
+#include "graph/layered_sphere.h"
 
 void graph_filter_degree(GraphData *data, int min_degree)
 {
@@ -26,6 +29,7 @@ void graph_filter_degree(GraphData *data, int min_degree)
 
 	if (igraph_vector_int_size(&vids) > 0) {
 		printf("Filtering nodes with degree < %d. Removing %d nodes...\n", min_degree, (int)igraph_vector_int_size(&vids));
+		layered_sphere_delete_vertices(data, &vids);
 		igraph_delete_vertices(&data->g, igraph_vss_vector(&vids));
 
 		// Cleanup graph
@@ -60,6 +64,7 @@ void graph_filter_coreness(GraphData *data, int min_coreness)
 
 	if (igraph_vector_int_size(&vids) > 0) {
 		printf("Filtering nodes with coreness < %d. Removing %d nodes...\n", min_coreness, (int)igraph_vector_int_size(&vids));
+		layered_sphere_delete_vertices(data, &vids);
 		igraph_delete_vertices(&data->g, igraph_vss_vector(&vids));
 		igraph_simplify(&data->g, 1, 1, NULL);
 		data->props.coreness_filter = min_coreness;
@@ -129,54 +134,209 @@ void graph_highlight_infrastructure(GraphData *data)
 	igraph_vector_int_destroy(&bridges);
 }
 
+// Reorder hubs[lo, hi) so the hub at mid has the median coordinate on axis, smaller before it
+// and larger after (quickselect)
+static void hub_select(int *hubs, int lo, int hi, int mid, int axis, const Hub *positions)
+{
+	while (hi - lo > 1) {
+		float pivot = positions[hubs[(lo + hi) / 2]].position[axis];
+		int i = lo, j = hi - 1;
+		while (i <= j) {
+			while (positions[hubs[i]].position[axis] < pivot)
+				i++;
+			while (positions[hubs[j]].position[axis] > pivot)
+				j--;
+			if (i <= j) {
+				int tmp = hubs[i];
+				hubs[i++] = hubs[j];
+				hubs[j--] = tmp;
+			}
+		}
+		if (mid <= j)
+			hi = j + 1;
+		else if (mid >= i)
+			lo = i;
+		else
+			return;
+	}
+}
+
+// Implicit kd-tree: the median of hubs[lo, hi) sits at the middle, split on axis depth % 3
+static void hub_tree_build(int *hubs, int lo, int hi, int depth, const Hub *positions)
+{
+	if (hi - lo <= 1)
+		return;
+	int mid = (lo + hi) / 2;
+	hub_select(hubs, lo, hi, mid, depth % 3, positions);
+	hub_tree_build(hubs, lo, mid, depth + 1, positions);
+	hub_tree_build(hubs, mid + 1, hi, depth + 1, positions);
+}
+
+// Nearest hub to p; subtrees whose splitting plane is farther than the best hit are skipped
+static void hub_tree_nearest(const int *hubs, int lo, int hi, int depth, const Hub *positions, const float *p, int *best, float *best_dist)
+{
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
+		const float *h = positions[hubs[mid]].position;
+		float dx = p[0] - h[0], dy = p[1] - h[1], dz = p[2] - h[2];
+		float d = dx * dx + dy * dy + dz * dz;
+		if (d < *best_dist) {
+			*best_dist = d;
+			*best = hubs[mid];
+		}
+		float split = p[depth % 3] - h[depth % 3];
+		// Near side first, far side only if the plane is within the best distance
+		if (split < 0.0f) {
+			hub_tree_nearest(hubs, lo, mid, depth + 1, positions, p, best, best_dist);
+			if (split * split >= *best_dist)
+				return;
+			lo = mid + 1;
+		} else {
+			hub_tree_nearest(hubs, mid + 1, hi, depth + 1, positions, p, best, best_dist);
+			if (split * split >= *best_dist)
+				return;
+			hi = mid;
+		}
+		depth++;
+	}
+}
+
+// k-means++ seeding on a sample of the midpoints: each new hub is drawn with probability
+// proportional to the squared distance to the nearest hub picked so far
+static void seed_hubs(GraphData *data, int num_hubs, const float *mid, uint32_t mid_count)
+{
+	uint32_t sample_count = (uint32_t)num_hubs * HUB_SEED_SAMPLE < mid_count ? (uint32_t)num_hubs * HUB_SEED_SAMPLE : mid_count;
+	float *sample = malloc(sizeof(float) * 3 * sample_count);
+	float *dist = malloc(sizeof(float) * sample_count);
+	double *cumulative = malloc(sizeof(double) * sample_count);
+	for (uint32_t s = 0; s < sample_count; s++) {
+		uint32_t e = sample_count == mid_count ? s : (uint32_t)(graph_rng_u64(GRAPH_RNG_STREAM_HUBS, s, 1) % mid_count);
+		memcpy(&sample[s * 3], &mid[e * 3], sizeof(float) * 3);
+		dist[s] = INFINITY;
+	}
+
+	uint32_t pick = (uint32_t)(graph_rng_u64(GRAPH_RNG_STREAM_HUBS, 0, 0) % sample_count);
+	for (int h = 0; h < num_hubs; h++) {
+		memcpy(data->hubs[h].position, &sample[pick * 3], sizeof(float) * 3);
+		if (h == num_hubs - 1)
+			break;
+		const float *c = data->hubs[h].position;
+#pragma omp parallel for
+		for (int64_t s = 0; s < (int64_t)sample_count; s++) {
+			float dx = sample[s * 3] - c[0], dy = sample[s * 3 + 1] - c[1], dz = sample[s * 3 + 2] - c[2];
+			float d = dx * dx + dy * dy + dz * dz;
+			if (d < dist[s])
+				dist[s] = d;
+		}
+		double total = 0.0;
+		for (uint32_t s = 0; s < sample_count; s++) {
+			total += dist[s];
+			cumulative[s] = total;
+		}
+		if (total <= 0.0) {
+			// Fewer distinct midpoints than hubs: the rest stack on already picked ones
+			pick = (uint32_t)(graph_rng_u64(GRAPH_RNG_STREAM_HUBS, h + 1, 0) % sample_count);
+			continue;
+		}
+		double target = graph_rng_float(GRAPH_RNG_STREAM_HUBS, h + 1, 0) * total;
+		uint32_t lo = 0, hi = sample_count - 1;
+		while (lo < hi) {
+			uint32_t m = (lo + hi) / 2;
+			if (cumulative[m] <= target)
+				lo = m + 1;
+			else
+				hi = m;
+		}
+		pick = lo;
+	}
+	free(sample);
+	free(dist);
+	free(cumulative);
+}
+
 void graph_generate_hubs(GraphData *data, int num_hubs)
 {
-	if (data->edge_count == 0)
+	if (data->edge_count == 0 || num_hubs <= 0)
 		return;
+	uint32_t edge_count = data->edge_count;
+	// The previous hubs are a warm start as long as their number stays the same
+	bool warm = data->hubs && data->hub_count == num_hubs;
 	data->hub_count = num_hubs;
 	data->hubs = realloc(data->hubs, sizeof(Hub) * num_hubs);
+	data->edge_hubs = realloc(data->edge_hubs, sizeof(int) * edge_count);
 
-	// Init hubs randomly to node positions
-	for (int i = 0; i < num_hubs; i++) {
-		int n = rand() % data->node_count;
-		memcpy(data->hubs[i].position, data->nodes[n].position, sizeof(float) * 3);
+	float *mid = malloc(sizeof(float) * 3 * edge_count);
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)edge_count; i++) {
+		const float *a = data->nodes[data->edges[i].from].position, *b = data->nodes[data->edges[i].to].position;
+		for (int k = 0; k < 3; k++)
+			mid[i * 3 + k] = (a[k] + b[k]) * 0.5f;
+		data->edge_hubs[i] = -1;
 	}
+	if (!warm)
+		seed_hubs(data, num_hubs, mid, edge_count);
 
-	// K-Means Clustering on Edge Midpoints (10 Iterations)
-	int *counts = calloc(num_hubs, sizeof(int));
-	float *sums = calloc(num_hubs * 3, sizeof(float));
-
-	for (int iter = 0; iter < 10; iter++) {
-		memset(counts, 0, sizeof(int) * num_hubs);
-		memset(sums, 0, sizeof(float) * num_hubs * 3);
-
-		for (uint32_t i = 0; i < data->edge_count; i++) {
-			float mid[3] = {(data->nodes[data->edges[i].from].position[0] + data->nodes[data->edges[i].to].position[0]) * 0.5f, (data->nodes[data->edges[i].from].position[1] + data->nodes[data->edges[i].to].position[1]) * 0.5f, (data->nodes[data->edges[i].from].position[2] + data->nodes[data->edges[i].to].position[2]) * 0.5f};
-			int best_hub = 0;
-			float best_dist = 1e9f;
-			for (int h = 0; h < num_hubs; h++) {
-				float dx = mid[0] - data->hubs[h].position[0];
-				float dy = mid[1] - data->hubs[h].position[1];
-				float dz = mid[2] - data->hubs[h].position[2];
-				float d = dx * dx + dy * dy + dz * dz;
-				if (d < best_dist) {
-					best_dist = d;
-					best_hub = h;
+	// Lloyd iterations: the assignment queries a kd-tree over the hubs in parallel, each thread
+	// summing into its own slice, so the totals are reduced without atomics
+	int num_threads = omp_get_max_threads();
+	int *tree = malloc(sizeof(int) * num_hubs);
+	int *counts = malloc(sizeof(int) * num_hubs * num_threads);
+	double *sums = malloc(sizeof(double) * 3 * num_hubs * num_threads);
+	for (int iter = 0; iter < HUB_KMEANS_ITERATIONS; iter++) {
+		for (int h = 0; h < num_hubs; h++)
+			tree[h] = h;
+		hub_tree_build(tree, 0, num_hubs, 0, data->hubs);
+		memset(counts, 0, sizeof(int) * num_hubs * num_threads);
+		memset(sums, 0, sizeof(double) * 3 * num_hubs * num_threads);
+
+		int64_t changed = 0;
+#pragma omp parallel reduction(+ : changed)
+		{
+			int t = omp_get_thread_num();
+			int *thread_counts = counts + (size_t)t * num_hubs;
+			double *thread_sums = sums + (size_t)t * num_hubs * 3;
+#pragma omp for schedule(static)
+			for (int64_t i = 0; i < (int64_t)edge_count; i++) {
+				const float *p = &mid[i * 3];
+				int best = data->edge_hubs[i];
+				float best_dist = INFINITY;
+				if (best >= 0) {
+					// Last iteration's hub bounds the search from the start
+					const float *h = data->hubs[best].position;
+					best_dist = (p[0] - h[0]) * (p[0] - h[0]) + (p[1] - h[1]) * (p[1] - h[1]) + (p[2] - h[2]) * (p[2] - h[2]);
 				}
+				int previous = best;
+				hub_tree_nearest(tree, 0, num_hubs, 0, data->hubs, p, &best, &best_dist);
+				changed += best != previous;
+				data->edge_hubs[i] = best;
+				thread_sums[best * 3 + 0] += p[0];
+				thread_sums[best * 3 + 1] += p[1];
+				thread_sums[best * 3 + 2] += p[2];
+				thread_counts[best]++;
 			}
-			sums[best_hub * 3 + 0] += mid[0];
-			sums[best_hub * 3 + 1] += mid[1];
-			sums[best_hub * 3 + 2] += mid[2];
-			counts[best_hub]++;
 		}
+
+#pragma omp parallel for
 		for (int h = 0; h < num_hubs; h++) {
-			if (counts[h] > 0) {
-				data->hubs[h].position[0] = sums[h * 3 + 0] / counts[h];
-				data->hubs[h].position[1] = sums[h * 3 + 1] / counts[h];
-				data->hubs[h].position[2] = sums[h * 3 + 2] / counts[h];
+			int count = 0;
+			double sx = 0.0, sy = 0.0, sz = 0.0;
+			for (int t = 0; t < num_threads; t++) {
+				count += counts[(size_t)t * num_hubs + h];
+				sx += sums[((size_t)t * num_hubs + h) * 3 + 0];
+				sy += sums[((size_t)t * num_hubs + h) * 3 + 1];
+				sz += sums[((size_t)t * num_hubs + h) * 3 + 2];
+			}
+			if (count > 0) {
+				data->hubs[h].position[0] = (float)(sx / count);
+				data->hubs[h].position[1] = (float)(sy / count);
+				data->hubs[h].position[2] = (float)(sz / count);
 			}
 		}
+		if (changed == 0)
+			break;
 	}
+	free(tree);
 	free(counts);
 	free(sums);
+	free(mid);
 }
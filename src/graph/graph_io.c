@@ -7,8 +7,27 @@
 #include <string.h>
 
 #include "graph/graph_core.h"
+#include "graph/layout_spectral.h"
 
-int graph_load_graphml(const char *filename, GraphData *data, LayoutType layout_type, const char *node_attr, const char *edge_attr)
+// HDE or spectral positions into current_layout; false (layout left empty) if they failed
+static bool spectral_initial_layout(GraphData *data, InitialLayout initial_layout)
+{
+	igraph_integer_t vcount = igraph_vcount(&data->g);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return false;
+	bool ok = igraph_get_edgelist(&data->g, &edges, 0) == IGRAPH_SUCCESS;
+	if (ok && initial_layout == INITIAL_LAYOUT_HDE)
+		ok = spectral_hde_layout((uint32_t)vcount, &edges, SPECTRAL_HDE_PIVOTS, &data->current_layout);
+	else if (ok)
+		ok = spectral_laplacian_layout((uint32_t)vcount, &edges, &data->current_layout);
+	igraph_vector_int_destroy(&edges);
+	if (!ok)
+		igraph_matrix_resize(&data->current_layout, 0, 0);
+	return ok;
+}
+
+int graph_load_graphml(const char *filename, GraphData *data, LayoutType layout_type, InitialLayout initial_layout, const char *node_attr, const char *edge_attr)
 {
 	igraph_set_attribute_table(&igraph_cattribute_table);
 	FILE *fp = fopen(filename, "r");
@@ -27,9 +46,14 @@ int graph_load_graphml(const char *filename, GraphData *data, LayoutType layout_
 	data->edges = NULL;
 	data->hubs = NULL;
 	data->hub_count = 0;
+	data->edge_hubs = NULL;
 
 	igraph_matrix_init(&data->current_layout, 0, 0);
-	if (layout_type == LAYOUT_OPENORD_3D || layout_type == LAYOUT_RANDOM_3D) {
+	// HDE and spectral starts come from the graph structure; OpenOrd and the force layouts
+	// start from the loaded positions, so they refine it
+	if (initial_layout != INITIAL_LAYOUT_DEFAULT && spectral_initial_layout(data, initial_layout)) {
+		// Positions already in current_layout
+	} else if (layout_type == LAYOUT_OPENORD_3D || layout_type == LAYOUT_BARNES_HUT_3D || layout_type == LAYOUT_GPU_FORCE_3D || layout_type == LAYOUT_RANDOM_3D) {
 		igraph_layout_random_3d(&data->g, &data->current_layout);
 	} else {
 		// Use grid layout as default
@@ -2,12 +2,16 @@
 #include "graph/graph_layout.h"
 
 #include <math.h>
+#include <omp.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "graph/graph_core.h"
 #include "graph/graph_layout.h"
+#include "graph/graph_rng.h"
+#include "graph/layered_sphere.h"
+#include "graph/layout_barnes_hut.h"
 #include "graph/layout_openord.h"
 
 void graph_layout_step(GraphData *data, LayoutType type, int iterations)
@@ -45,7 +49,7 @@ void graph_layout_step(GraphData *data, LayoutType type, int iterations)
 	case LAYOUT_OPENORD_3D: {
 		if (!data->openord) {
 			data->openord = malloc(sizeof(OpenOrdContext));
-			openord_init(data->openord, data->node_count, 128);
+			openord_init(data->openord, data, 0);
 			igraph_layout_random_3d(&data->g, &data->current_layout);
 		}
 		for (int i = 0; i < iterations; i++) {
@@ -54,84 +58,184 @@ void graph_layout_step(GraphData *data, LayoutType type, int iterations)
 		}
 		break;
 	}
+	// The GPU layout runs in the renderer; here (no device) the same force model runs on the CPU
+	case LAYOUT_GPU_FORCE_3D:
+	case LAYOUT_BARNES_HUT_3D: {
+		if (!data->barnes_hut) {
+			data->barnes_hut = malloc(sizeof(BarnesHutContext));
+			barnes_hut_init(data->barnes_hut, data);
+		}
+		for (int i = 0; i < iterations; i++) {
+			if (!barnes_hut_step(data->barnes_hut, data))
+				break;
+		}
+		break;
+	}
+	case LAYOUT_LAYERED_SPHERE_3D: {
+		if (!data->layered_sphere_run && !layered_sphere_start(data))
+			break;
+		for (int i = 0; i < iterations; i++) {
+			if (!layered_sphere_iterate_run(data))
+				break;
+		}
+		layered_sphere_copy_layout(data, &data->current_layout);
+		break;
+	}
 	}
 	graph_sync_node_positions(data);
 }
 
-void graph_remove_overlaps(GraphData *data, float layoutScale)
+// Bucket of a grid cell in the power-of-two table of the hashed sparse grid
+static uint32_t overlap_cell_bucket(int cx, int cy, int cz, uint32_t mask)
 {
-	if (!data->graph_initialized || data->node_count == 0)
-		return;
+	return ((uint32_t)cx * 73856093u ^ (uint32_t)cy * 19349663u ^ (uint32_t)cz * 83492791u) & mask;
+}
+
+int graph_remove_overlaps(GraphData *data, float layoutScale, double budget_ms)
+{
+	if (!data->graph_initialized || data->node_count == 0 || !data->nodes)
+		return 0;
+	uint32_t n = data->node_count;
+	int cols = (int)igraph_matrix_ncol(&data->current_layout);
+	if (igraph_matrix_nrow(&data->current_layout) != n || cols < 2)
+		return 0;
+	bool is_3d = cols > 2;
+	float scale = layoutScale > 0.0f ? layoutScale : 1.0f;
+
+	// Positions and radii in layout units (the renderer scales positions but not node sizes)
+	float *x = malloc(sizeof(float) * n), *y = malloc(sizeof(float) * n), *z = malloc(sizeof(float) * n);
+	float *move_x = malloc(sizeof(float) * n), *move_y = malloc(sizeof(float) * n), *move_z = malloc(sizeof(float) * n);
+	float *radius = malloc(sizeof(float) * n);
 	float max_radius = 0.0f;
-	vec3 min_p = {1e10, 1e10, 1e10}, max_p = {-1e10, -1e10, -1e10};
-	for (int i = 0; i < data->node_count; i++) {
-		float r = 0.5f * data->nodes[i].size;
-		if (r > max_radius)
-			max_radius = r;
-		for (int j = 0; j < 3; j++) {
-			if (data->nodes[i].position[j] < min_p[j])
-				min_p[j] = data->nodes[i].position[j];
-			if (data->nodes[i].position[j] > max_p[j])
-				max_p[j] = data->nodes[i].position[j];
-		}
+	for (uint32_t i = 0; i < n; i++) {
+		x[i] = (float)MATRIX(data->current_layout, i, 0);
+		y[i] = (float)MATRIX(data->current_layout, i, 1);
+		z[i] = is_3d ? (float)MATRIX(data->current_layout, i, 2) : 0.0f;
+		radius[i] = 0.5f * data->nodes[i].size / scale;
+		if (radius[i] > max_radius)
+			max_radius = radius[i];
 	}
-	float cellSize = (max_radius * 2.0f) + 0.1f;
-	int dimX = (int)((max_p[0] - min_p[0]) / cellSize) + 1;
-	int dimY = (int)((max_p[1] - min_p[1]) / cellSize) + 1;
-	int dimZ = (int)((max_p[2] - min_p[2]) / cellSize) + 1;
-	if (dimX * dimY * dimZ > 1000000)
-		cellSize *= 2.0f;
-	int totalCells = dimX * dimY * dimZ;
-	int *head = malloc(sizeof(int) * totalCells);
-	int *next = malloc(sizeof(int) * data->node_count);
-	memset(head, -1, sizeof(int) * totalCells);
-	for (int i = 0; i < data->node_count; i++) {
-		int cx = (int)((data->nodes[i].position[0] - min_p[0]) / cellSize);
-		int cy = (int)((data->nodes[i].position[1] - min_p[1]) / cellSize);
-		int cz = (int)((data->nodes[i].position[2] - min_p[2]) / cellSize);
-		int cellIdx = cx + cy * dimX + cz * dimX * dimY;
-		if (cellIdx >= 0 && cellIdx < totalCells) {
-			next[i] = head[cellIdx];
-			head[cellIdx] = i;
+
+	// Cells as wide as the largest diameter: overlapping pairs sit in neighboring cells. Only
+	// occupied cells cost memory, however far the layout spreads.
+	float cell_size = 2.0f * max_radius;
+	uint32_t buckets = 1;
+	while (buckets < 2 * n)
+		buckets <<= 1;
+	uint32_t mask = buckets - 1;
+	int *bucket_start = malloc(sizeof(int) * (buckets + 1));
+	int *bucket_fill = malloc(sizeof(int) * buckets);
+	int *bucket_nodes = malloc(sizeof(int) * n);
+	uint32_t *node_bucket = malloc(sizeof(uint32_t) * n);
+
+	double start_ms = omp_get_wtime() * 1000.0;
+	int passes = 0;
+	float max_overlap = 0.0f;
+	while (max_radius > 0.0f && passes < OVERLAP_MAX_PASSES) {
+		memset(bucket_start, 0, sizeof(int) * (buckets + 1));
+		for (uint32_t i = 0; i < n; i++) {
+			node_bucket[i] = overlap_cell_bucket((int)floorf(x[i] / cell_size), (int)floorf(y[i] / cell_size), (int)floorf(z[i] / cell_size), mask);
+			bucket_start[node_bucket[i] + 1]++;
 		}
-	}
-	for (int i = 0; i < data->node_count; i++) {
-		int cx = (int)((data->nodes[i].position[0] - min_p[0]) / cellSize);
-		int cy = (int)((data->nodes[i].position[1] - min_p[1]) / cellSize);
-		int cz = (int)((data->nodes[i].position[2] - min_p[2]) / cellSize);
-		for (int nx = cx - 1; nx <= cx + 1; nx++) {
-			for (int ny = cy - 1; ny <= cy + 1; ny++) {
-				for (int nz = cz - 1; nz <= cz + 1; nz++) {
-					if (nx < 0 || nx >= dimX || ny < 0 || ny >= dimY || nz < 0 || nz >= dimZ)
-						continue;
-					int cellIdx = nx + ny * dimX + nz * dimX * dimY;
-					for (int j = head[cellIdx]; j >= 0; j = next[j]) {
-						if (i == j)
+		for (uint32_t b = 0; b < buckets; b++)
+			bucket_start[b + 1] += bucket_start[b];
+		memcpy(bucket_fill, bucket_start, sizeof(int) * buckets);
+		for (uint32_t i = 0; i < n; i++)
+			bucket_nodes[bucket_fill[node_bucket[i]]++] = (int)i;
+
+		// Each node takes its half of every overlap, all from the same snapshot, so the result
+		// doesn't depend on node order or thread count
+		max_overlap = 0.0f;
+#pragma omp parallel for schedule(dynamic, 256) reduction(max : max_overlap)
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			int cx = (int)floorf(x[i] / cell_size), cy = (int)floorf(y[i] / cell_size), cz = (int)floorf(z[i] / cell_size);
+			uint32_t visited[27];
+			int visited_count = 0;
+			float mx = 0.0f, my = 0.0f, mz = 0.0f;
+			for (int ox = -1; ox <= 1; ox++) {
+				for (int oy = -1; oy <= 1; oy++) {
+					for (int oz = is_3d ? -1 : 0; oz <= (is_3d ? 1 : 0); oz++) {
+						// Distinct cells can share a bucket; scan each bucket once
+						uint32_t b = overlap_cell_bucket(cx + ox, cy + oy, cz + oz, mask);
+						bool seen = false;
+						for (int v = 0; v < visited_count; v++)
+							seen |= visited[v] == b;
+						if (seen)
 							continue;
-						float dx = data->nodes[i].position[0] - data->nodes[j].position[0];
-						float dy = data->nodes[i].position[1] - data->nodes[j].position[1];
-						float dz = data->nodes[i].position[2] - data->nodes[j].position[2];
-						float distSq = dx * dx + dy * dy + dz * dz;
-						float minDist = 0.5f * (data->nodes[i].size + data->nodes[j].size);
-						if (distSq < minDist * minDist && distSq > 0.0001f) {
-							float dist = sqrtf(distSq);
-							float overlap = 0.5f * (minDist - dist);
-							dx /= dist;
-							dy /= dist;
-							dz /= dist;
-							data->nodes[i].position[0] += overlap * dx;
-							data->nodes[i].position[1] += overlap * dy;
-							data->nodes[i].position[2] += overlap * dz;
-							data->nodes[j].position[0] -= overlap * dx;
-							data->nodes[j].position[1] -= overlap * dy;
-							data->nodes[j].position[2] -= overlap * dz;
+						visited[visited_count++] = b;
+
+						for (int k = bucket_start[b]; k < bucket_start[b + 1]; k++) {
+							int j = bucket_nodes[k];
+							if (j == i)
+								continue;
+							float dx = x[i] - x[j], dy = y[i] - y[j], dz = z[i] - z[j];
+							float dist_sq = dx * dx + dy * dy + dz * dz;
+							float min_dist = radius[i] + radius[j];
+							if (dist_sq >= min_dist * min_dist)
+								continue;
+							float dist = sqrtf(dist_sq);
+							if (dist < 1e-6f * min_dist) {
+								// Coincident pair: a direction drawn for the pair, opposite for its two nodes
+								uint64_t pair = (uint64_t)(i < j ? i : j) * n + (uint64_t)(i < j ? j : i);
+								float sign = i < j ? 1.0f : -1.0f;
+								float theta = 2.0f * (float)M_PI * graph_rng_float(GRAPH_RNG_STREAM_OVERLAP, pair, 0);
+								float cos_phi = is_3d ? 2.0f * graph_rng_float(GRAPH_RNG_STREAM_OVERLAP, pair, 1) - 1.0f : 0.0f;
+								float sin_phi = sqrtf(1.0f - cos_phi * cos_phi);
+								dx = sign * sin_phi * cosf(theta);
+								dy = sign * sin_phi * sinf(theta);
+								dz = sign * cos_phi;
+								dist = 0.0f;
+							} else {
+								dx /= dist;
+								dy /= dist;
+								dz /= dist;
+							}
+							float overlap = min_dist - dist;
+							mx += 0.5f * overlap * dx;
+							my += 0.5f * overlap * dy;
+							mz += 0.5f * overlap * dz;
+							if (overlap / min_dist > max_overlap)
+								max_overlap = overlap / min_dist;
 						}
 					}
 				}
 			}
+			move_x[i] = mx;
+			move_y[i] = my;
+			move_z[i] = mz;
+		}
+
+		if (max_overlap <= OVERLAP_TOLERANCE)
+			break;
+		passes++;
+#pragma omp parallel for
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			x[i] += move_x[i];
+			y[i] += move_y[i];
+			z[i] += move_z[i];
 		}
+		if (budget_ms > 0.0 && omp_get_wtime() * 1000.0 - start_ms > budget_ms)
+			break;
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		MATRIX(data->current_layout, i, 0) = x[i];
+		MATRIX(data->current_layout, i, 1) = y[i];
+		if (is_3d)
+			MATRIX(data->current_layout, i, 2) = z[i];
 	}
 	graph_sync_node_positions(data);
-	free(head);
-	free(next);
+
+	free(x);
+	free(y);
+	free(z);
+	free(move_x);
+	free(move_y);
+	free(move_z);
+	free(radius);
+	free(bucket_start);
+	free(bucket_fill);
+	free(bucket_nodes);
+	free(node_bucket);
+	return passes;
 }
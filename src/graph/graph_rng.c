@@ -0,0 +1,16 @@
+#include "graph/graph_rng.h"
+
+#include <igraph.h>
+
+static uint64_t g_seed = 0x5eed;
+
+void graph_rng_set_seed(uint64_t seed)
+{
+	g_seed = seed;
+	igraph_rng_seed(igraph_rng_default(), (igraph_uint_t)seed);
+}
+
+uint64_t graph_rng_get_seed(void)
+{
+	return g_seed;
+}
@@ -2,12 +2,19 @@
 
 #include <math.h>
 #include <omp.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include <igraph_progress.h>
 
+#include "app_state.h"
+#include "graph/layout_pivot_mds.h"
+#include "graph/worker_thread.h"
+#include "graph/wrappers_layout.h"
+#include "vulkan/renderer.h"
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -15,6 +22,8 @@
 #define MAX_INTRA_ITERS 50
 #define MAX_INTER_ITERS 100
 #define HILBERT_RES 32768
+// An incremental run rebuilds from scratch once more than this fraction of nodes is re-assigned
+#define INCREMENTAL_REBUILD_FRACTION 0.5
 
 typedef struct
 {
@@ -61,8 +70,31 @@ typedef struct LayeredSphereContext
 	int inter_sphere_pass;
 	int vcount;
 	igraph_matrix_t *layout;
+
+	// Adjacency as CSR (both directions, self-loops dropped)
+	int *adj_offsets;
+	int *adj_neighbors;
+	// Nodes grouped by sphere, ascending within each sphere
+	int *sphere_offsets;
+	int *sphere_nodes;
+	// Unit direction of each node's slot (SoA); the move deltas only need these
+	float *dir_x, *dir_y, *dir_z;
+
+	// Kept across runs for incremental updates
+	int num_communities;
+	double cpm_resolution;
+	unsigned char *sphere_active; // Spheres the swap passes visit
+	unsigned char *touched;		  // Nodes whose neighborhood changed since the last run
+
+	// Stepped runs write into their own matrix, taken with the retained state at this epoch
+	bool owns_layout;
+	int epoch;
 } LayeredSphereContext;
 
+// Guards GraphData.layered_sphere and layered_sphere_epoch. Only held to take or return the
+// retained state, never while a run iterates.
+static pthread_mutex_t retained_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void rot(int n, int *x, int *y, int rx, int ry)
 {
 	if (ry == 0) {
@@ -115,6 +147,12 @@ static int compare_points(const void *a, const void *b)
 	return ((SpherePoint *)a)->hilbert_dist - ((SpherePoint *)b)->hilbert_dist;
 }
 
+static int compare_int(const void *a, const void *b)
+{
+	int ia = *(const int *)a, ib = *(const int *)b;
+	return (ia > ib) - (ia < ib);
+}
+
 static int get_vector_int_max(const igraph_vector_int_t *v)
 {
 	int max_val = 0;
@@ -142,126 +180,162 @@ static int find_closest_slot_by_hilbert(SphereGrid *grid, int target_h)
 	return best_idx;
 }
 
-static double calculate_move_delta_intra(const igraph_t *ig, const igraph_matrix_t *layout, LayeredSphereContext *ctx, int u, int target_sphere_s, int target_slot_k)
+// Free slot nearest to target_h in Hilbert order, -1 if the sphere is full
+static int find_free_slot(SphereGrid *grid, int target_h)
 {
-	int v = ctx->grids[target_sphere_s].slot_occupant[target_slot_k];
-	double current_score = 0.0, potential_score = 0.0;
-
-	double tx = ctx->grids[target_sphere_s].slots[target_slot_k].x;
-	double ty = ctx->grids[target_sphere_s].slots[target_slot_k].y;
-	double tz = ctx->grids[target_sphere_s].slots[target_slot_k].z;
-
-	int u_slot = ctx->node_to_slot_idx[u];
-	double ux = ctx->grids[target_sphere_s].slots[u_slot].x;
-	double uy = ctx->grids[target_sphere_s].slots[u_slot].y;
-	double uz = ctx->grids[target_sphere_s].slots[u_slot].z;
-
-	igraph_vector_int_t neis;
-	igraph_vector_int_init(&neis, 0);
-	igraph_incident(ig, &neis, u, IGRAPH_ALL, IGRAPH_NO_LOOPS);
-	for (int i = 0; i < igraph_vector_int_size(&neis); i++) {
-		igraph_integer_t from, to;
-		igraph_edge(ig, VECTOR(neis)[i], &from, &to);
-		int neighbor = (from == u) ? to : from;
-
-		if (neighbor == v || ctx->node_to_sphere_id[neighbor] != target_sphere_s)
-			continue;
-
-		double nx = MATRIX(*layout, neighbor, 0), ny = MATRIX(*layout, neighbor, 1), nz = MATRIX(*layout, neighbor, 2);
-		current_score += (ux - nx) * (ux - nx) + (uy - ny) * (uy - ny) + (uz - nz) * (uz - nz);
-		potential_score += (tx - nx) * (tx - nx) + (ty - ny) * (ty - ny) + (tz - nz) * (tz - nz);
+	int start = find_closest_slot_by_hilbert(grid, target_h);
+	for (int d = 0; start - d >= 0 || start + d < grid->max_slots; d++) {
+		if (start - d >= 0 && grid->slot_occupant[start - d] == -1)
+			return start - d;
+		if (start + d < grid->max_slots && grid->slot_occupant[start + d] == -1)
+			return start + d;
 	}
-	igraph_vector_int_destroy(&neis);
-
-	if (v != -1) {
-		igraph_vector_int_init(&neis, 0);
-		igraph_incident(ig, &neis, v, IGRAPH_ALL, IGRAPH_NO_LOOPS);
-		for (int i = 0; i < igraph_vector_int_size(&neis); i++) {
-			igraph_integer_t from, to;
-			igraph_edge(ig, VECTOR(neis)[i], &from, &to);
-			int neighbor = (from == v) ? to : from;
-			if (neighbor == u || ctx->node_to_sphere_id[neighbor] != target_sphere_s)
-				continue;
-
-			double nx = MATRIX(*layout, neighbor, 0), ny = MATRIX(*layout, neighbor, 1), nz = MATRIX(*layout, neighbor, 2);
-			current_score += (tx - nx) * (tx - nx) + (ty - ny) * (ty - ny) + (tz - nz) * (tz - nz);
-			potential_score += (ux - nx) * (ux - nx) + (uy - ny) * (uy - ny) + (uz - nz) * (uz - nz);
-		}
-		igraph_vector_int_destroy(&neis);
-	}
-	return potential_score - current_score;
+	return -1;
 }
 
-static double calculate_move_delta_inter(const igraph_t *ig, const igraph_matrix_t *layout, LayeredSphereContext *ctx, int u, int target_sphere_s, int target_slot_k)
+// Hilbert index of the slot position a unit direction points at
+static int direction_to_hilbert(double x, double y, double z)
 {
-	int v = ctx->grids[target_sphere_s].slot_occupant[target_slot_k];
-	double current_score = 0.0, potential_score = 0.0;
-	double r = ctx->grids[target_sphere_s].radius;
-
-	double tx = ctx->grids[target_sphere_s].slots[target_slot_k].x / r;
-	double ty = ctx->grids[target_sphere_s].slots[target_slot_k].y / r;
-	double tz = ctx->grids[target_sphere_s].slots[target_slot_k].z / r;
+	double phi = acos(fmax(-1.0, fmin(1.0, z)));
+	double theta = atan2(y, x);
+	if (theta < 0)
+		theta += 2 * M_PI;
+	return xy2d(HILBERT_RES, (int)((theta / (2 * M_PI)) * (HILBERT_RES - 1)), (int)((phi / M_PI) * (HILBERT_RES - 1)));
+}
 
-	int u_slot = ctx->node_to_slot_idx[u];
-	double ux = ctx->grids[target_sphere_s].slots[u_slot].x / r;
-	double uy = ctx->grids[target_sphere_s].slots[u_slot].y / r;
-	double uz = ctx->grids[target_sphere_s].slots[u_slot].z / r;
+// Sort each node's neighbor slice, so the adjacency of two runs compares slice by slice
+static void sort_adjacency(int vcount, const int *offsets, int *neighbors)
+{
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int i = 0; i < vcount; i++)
+		qsort(neighbors + offsets[i], offsets[i + 1] - offsets[i], sizeof(int), compare_int);
+}
 
-	igraph_vector_int_t neis;
-	igraph_vector_int_init(&neis, 0);
-	igraph_incident(ig, &neis, u, IGRAPH_ALL, IGRAPH_NO_LOOPS);
-	for (int i = 0; i < igraph_vector_int_size(&neis); i++) {
-		igraph_integer_t from, to;
-		igraph_edge(ig, VECTOR(neis)[i], &from, &to);
-		int neighbor = (from == u) ? to : from;
-		if (neighbor == v)
-			continue;
+// Sum of the unit directions of u's neighbors, skipping exclude and, if sphere >= 0, neighbors
+// on other spheres. Returns how many were summed. Branch-free so the gather loop vectorizes.
+static int neighbor_direction_sum(const LayeredSphereContext *ctx, int u, int sphere, int exclude, float sum[3])
+{
+	const int *neighbors = ctx->adj_neighbors;
+	const int *sphere_id = ctx->node_to_sphere_id;
+	float sx = 0.0f, sy = 0.0f, sz = 0.0f;
+	int count = 0;
+#pragma omp simd reduction(+ : sx, sy, sz, count)
+	for (int e = ctx->adj_offsets[u]; e < ctx->adj_offsets[u + 1]; e++) {
+		int j = neighbors[e];
+		float keep = (j != exclude && (sphere < 0 || sphere_id[j] == sphere)) ? 1.0f : 0.0f;
+		sx += keep * ctx->dir_x[j];
+		sy += keep * ctx->dir_y[j];
+		sz += keep * ctx->dir_z[j];
+		count += keep != 0.0f;
+	}
+	sum[0] = sx;
+	sum[1] = sy;
+	sum[2] = sz;
+	return count;
+}
 
-		double nx = MATRIX(*layout, neighbor, 0), ny = MATRIX(*layout, neighbor, 1), nz = MATRIX(*layout, neighbor, 2);
-		double n_len = sqrt(nx * nx + ny * ny + nz * nz);
-		if (n_len < 0.001)
-			continue;
-		nx /= n_len;
-		ny /= n_len;
-		nz /= n_len;
+// Edges between u and v (parallel edges count separately)
+static int edge_multiplicity(const LayeredSphereContext *ctx, int u, int v)
+{
+	int count = 0;
+#pragma omp simd reduction(+ : count)
+	for (int e = ctx->adj_offsets[u]; e < ctx->adj_offsets[u + 1]; e++)
+		count += ctx->adj_neighbors[e] == v;
+	return count;
+}
 
-		current_score += (1.0 - (ux * nx + uy * ny + uz * nz));
-		potential_score += (1.0 - (tx * nx + ty * ny + tz * nz));
+// Score change of swapping u into slot target_slot of sphere s (with its occupant, if any,
+// taking u's slot). With every node on its shell, both scores reduce to dot products with the
+// neighbors' unit directions: intra-sphere squared distances |a - n|^2 = r^2 (2 - 2 a.n) over
+// neighbors on the same sphere, inter-sphere angular 1 - a.n over all neighbors. sum_u is u's
+// neighbor direction sum under the same filter (sphere, or -1 for all).
+static double calculate_move_delta(const LayeredSphereContext *ctx, int u, const float sum_u[3], int s, int sphere_filter, int target_slot)
+{
+	const SphereGrid *grid = &ctx->grids[s];
+	int v = grid->slot_occupant[target_slot];
+	double r = grid->radius;
+	double tx = grid->slots[target_slot].x / r, ty = grid->slots[target_slot].y / r, tz = grid->slots[target_slot].z / r;
+	double ux = ctx->dir_x[u], uy = ctx->dir_y[u], uz = ctx->dir_z[u];
+
+	// u's neighbors other than v (whose distance to u the swap keeps), minus v's other than u
+	double nx = sum_u[0], ny = sum_u[1], nz = sum_u[2];
+	if (v != -1) {
+		int multiplicity = edge_multiplicity(ctx, u, v);
+		nx -= multiplicity * ctx->dir_x[v];
+		ny -= multiplicity * ctx->dir_y[v];
+		nz -= multiplicity * ctx->dir_z[v];
+		float sum_v[3];
+		neighbor_direction_sum(ctx, v, sphere_filter, u, sum_v);
+		nx -= sum_v[0];
+		ny -= sum_v[1];
+		nz -= sum_v[2];
 	}
-	igraph_vector_int_destroy(&neis);
+	double delta = (ux - tx) * nx + (uy - ty) * ny + (uz - tz) * nz;
+	return sphere_filter >= 0 ? 2.0 * r * r * delta : delta;
+}
 
-	if (v != -1) {
-		igraph_vector_int_init(&neis, 0);
-		igraph_incident(ig, &neis, v, IGRAPH_ALL, IGRAPH_NO_LOOPS);
-		for (int i = 0; i < igraph_vector_int_size(&neis); i++) {
-			igraph_integer_t from, to;
-			igraph_edge(ig, VECTOR(neis)[i], &from, &to);
-			int neighbor = (from == v) ? to : from;
-			if (neighbor == u)
-				continue;
+// Put node into slot of sphere s, in the layout and the cached direction
+static void place_node(LayeredSphereContext *ctx, int node, int s, int slot)
+{
+	const SphereGrid *grid = &ctx->grids[s];
+	ctx->grids[s].slot_occupant[slot] = node;
+	ctx->node_to_slot_idx[node] = slot;
+	MATRIX(*ctx->layout, node, 0) = grid->slots[slot].x;
+	MATRIX(*ctx->layout, node, 1) = grid->slots[slot].y;
+	MATRIX(*ctx->layout, node, 2) = grid->slots[slot].z;
+	ctx->dir_x[node] = (float)(grid->slots[slot].x / grid->radius);
+	ctx->dir_y[node] = (float)(grid->slots[slot].y / grid->radius);
+	ctx->dir_z[node] = (float)(grid->slots[slot].z / grid->radius);
+}
 
-			double nx = MATRIX(*layout, neighbor, 0), ny = MATRIX(*layout, neighbor, 1), nz = MATRIX(*layout, neighbor, 2);
-			double n_len = sqrt(nx * nx + ny * ny + nz * nz);
-			if (n_len < 0.001)
-				continue;
-			nx /= n_len;
-			ny /= n_len;
-			nz /= n_len;
+// Group nodes by sphere (counting sort), ascending within each sphere
+static void build_sphere_members(LayeredSphereContext *ctx)
+{
+	free(ctx->sphere_offsets);
+	if (!ctx->sphere_nodes)
+		ctx->sphere_nodes = malloc(ctx->vcount * sizeof(int));
+	ctx->sphere_offsets = calloc(ctx->num_spheres + 1, sizeof(int));
+	for (int i = 0; i < ctx->vcount; i++)
+		ctx->sphere_offsets[ctx->node_to_sphere_id[i] + 1]++;
+	for (int sp = 0; sp < ctx->num_spheres; sp++)
+		ctx->sphere_offsets[sp + 1] += ctx->sphere_offsets[sp];
+	int *fill = malloc((ctx->num_spheres + 1) * sizeof(int));
+	memcpy(fill, ctx->sphere_offsets, (ctx->num_spheres + 1) * sizeof(int));
+	for (int i = 0; i < ctx->vcount; i++)
+		ctx->sphere_nodes[fill[ctx->node_to_sphere_id[i]]++] = i;
+	free(fill);
+}
 
-			current_score += (1.0 - (tx * nx + ty * ny + tz * nz));
-			potential_score += (1.0 - (ux * nx + uy * ny + uz * nz));
-		}
-		igraph_vector_int_destroy(&neis);
+static void write_positions(LayeredSphereContext *ctx)
+{
+	for (int i = 0; i < ctx->vcount; i++) {
+		const SpherePoint *p = &ctx->grids[ctx->node_to_sphere_id[i]].slots[ctx->node_to_slot_idx[i]];
+		MATRIX(*ctx->layout, i, 0) = p->x;
+		MATRIX(*ctx->layout, i, 1) = p->y;
+		MATRIX(*ctx->layout, i, 2) = p->z;
 	}
-	return potential_score - current_score;
 }
 
 static void layered_sphere_cleanup(LayeredSphereContext *ctx)
 {
+	if (ctx->owns_layout) {
+		igraph_matrix_destroy(ctx->layout);
+		free(ctx->layout);
+	}
 	if (ctx->node_to_sphere_id)
 		free(ctx->node_to_sphere_id);
 	if (ctx->node_to_slot_idx)
 		free(ctx->node_to_slot_idx);
+	free(ctx->node_to_comm_id);
+	free(ctx->adj_offsets);
+	free(ctx->adj_neighbors);
+	free(ctx->sphere_offsets);
+	free(ctx->sphere_nodes);
+	free(ctx->dir_x);
+	free(ctx->dir_y);
+	free(ctx->dir_z);
+	free(ctx->sphere_active);
+	free(ctx->touched);
 	if (ctx->grids) {
 		for (int s = 0; s < ctx->num_spheres; s++) {
 			if (ctx->grids[s].slots)
@@ -286,6 +360,10 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 		ctx->node_to_sphere_id = malloc(vcount * sizeof(int));
 		ctx->node_to_slot_idx = malloc(vcount * sizeof(int));
 		ctx->node_to_comm_id = malloc(vcount * sizeof(int));
+		ctx->dir_x = malloc(vcount * sizeof(float));
+		ctx->dir_y = malloc(vcount * sizeof(float));
+		ctx->dir_z = malloc(vcount * sizeof(float));
+		ctx->touched = calloc(vcount, 1);
 
 		igraph_t undirected_ig;
 		igraph_copy(&undirected_ig, ig);
@@ -305,6 +383,8 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 		igraph_community_leiden(&undirected_ig, NULL, NULL, NULL, cpm_resolution, 0.01, true, 2, &membership, NULL, NULL);
 
 		int num_communities = get_vector_int_max(&membership) + 1;
+		ctx->num_communities = num_communities;
+		ctx->cpm_resolution = cpm_resolution;
 
 		CommData *comms = calloc(num_communities, sizeof(CommData));
 		for (int i = 0; i < vcount; i++) {
@@ -349,9 +429,16 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 		}
 
 		ctx->num_spheres = current_sphere + 1;
+		ctx->sphere_active = malloc(ctx->num_spheres);
+		memset(ctx->sphere_active, 1, ctx->num_spheres);
 
-		for (int i = 0; i < vcount; i++)
+		for (int i = 0; i < vcount; i++) {
+			ctx->node_to_comm_id[i] = VECTOR(membership)[i];
 			ctx->node_to_sphere_id[i] = comm_to_sphere[VECTOR(membership)[i]];
+		}
+
+		// Members of each sphere, so passes don't scan every node per sphere
+		build_sphere_members(ctx);
 
 		free(comms);
 		free(comm_to_sphere);
@@ -377,10 +464,7 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 		double current_radius = 0.0;
 
 		for (int s = 0; s < ctx->num_spheres; s++) {
-			int n_in_group = 0;
-			for (int i = 0; i < vcount; i++)
-				if (ctx->node_to_sphere_id[i] == s)
-					n_in_group++;
+			int n_in_group = ctx->sphere_offsets[s + 1] - ctx->sphere_offsets[s];
 			if (n_in_group == 0)
 				continue;
 
@@ -417,15 +501,12 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 			qsort(ctx->grids[s].slots, M_s, sizeof(SpherePoint), compare_points);
 
 			NodePlacement *group_nodes = malloc(n_in_group * sizeof(NodePlacement));
-			int g_idx = 0;
-			for (int i = 0; i < vcount; i++) {
-				if (ctx->node_to_sphere_id[i] == s) {
-					group_nodes[g_idx].id = i;
-					group_nodes[g_idx].community_id = VECTOR(membership)[i];
-					group_nodes[g_idx].density = VECTOR(transitivity)[i];
-					group_nodes[g_idx].intra_degree = intra_degree[i];
-					g_idx++;
-				}
+			for (int g_idx = 0; g_idx < n_in_group; g_idx++) {
+				int i = ctx->sphere_nodes[ctx->sphere_offsets[s] + g_idx];
+				group_nodes[g_idx].id = i;
+				group_nodes[g_idx].community_id = VECTOR(membership)[i];
+				group_nodes[g_idx].density = VECTOR(transitivity)[i];
+				group_nodes[g_idx].intra_degree = intra_degree[i];
 			}
 			qsort(group_nodes, n_in_group, sizeof(NodePlacement), compare_nodes_placement);
 
@@ -433,11 +514,7 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 			for (int i = 0; i < n_in_group; i++) {
 				int nid = group_nodes[i].id;
 				int sid = fmin(M_s - 1, i * step);
-				ctx->grids[s].slot_occupant[sid] = nid;
-				ctx->node_to_slot_idx[nid] = sid;
-				MATRIX(*ctx->layout, nid, 0) = ctx->grids[s].slots[sid].x;
-				MATRIX(*ctx->layout, nid, 1) = ctx->grids[s].slots[sid].y;
-				MATRIX(*ctx->layout, nid, 2) = ctx->grids[s].slots[sid].z;
+				place_node(ctx, nid, s, sid);
 			}
 			free(group_nodes);
 		}
@@ -460,46 +537,19 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 
 #pragma omp parallel for schedule(dynamic) reduction(+ : local_moves)
 	for (int s = start_s; s < ctx->num_spheres; s += step_s) {
-		double radius = ctx->grids[s].radius;
+		if (!ctx->sphere_active[s])
+			continue;
 
-		for (int u = 0; u < vcount; u++) {
-			if (ctx->node_to_sphere_id[u] != s)
-				continue;
+		int sphere_filter = is_intra ? s : -1;
+
+		for (int m = ctx->sphere_offsets[s]; m < ctx->sphere_offsets[s + 1]; m++) {
+			int u = ctx->sphere_nodes[m];
 			int current_slot = ctx->node_to_slot_idx[u];
 
-			double bx = 0, by = 0, bz = 0;
-			int neighbor_count = 0;
-
-			igraph_vector_int_t neis;
-			igraph_vector_int_init(&neis, 0);
-			igraph_incident(ig, &neis, u, IGRAPH_ALL, IGRAPH_NO_LOOPS);
-
-			for (int j = 0; j < (int)igraph_vector_int_size(&neis); j++) {
-				igraph_integer_t from, to;
-				igraph_edge(ig, VECTOR(neis)[j], &from, &to);
-				int neighbor = (from == u) ? to : from;
-				int n_sphere = ctx->node_to_sphere_id[neighbor];
-
-				if (is_intra) {
-					if (n_sphere != s)
-						continue;
-					bx += MATRIX(*ctx->layout, neighbor, 0);
-					by += MATRIX(*ctx->layout, neighbor, 1);
-					bz += MATRIX(*ctx->layout, neighbor, 2);
-				} else {
-					double nx = MATRIX(*ctx->layout, neighbor, 0);
-					double ny = MATRIX(*ctx->layout, neighbor, 1);
-					double nz = MATRIX(*ctx->layout, neighbor, 2);
-					double n_len = sqrt(nx * nx + ny * ny + nz * nz);
-					if (n_len > 0.001) {
-						bx += (nx / n_len);
-						by += (ny / n_len);
-						bz += (nz / n_len);
-					}
-				}
-				neighbor_count++;
-			}
-			igraph_vector_int_destroy(&neis);
+			// Barycenter direction: same-sphere neighbors (intra) or all neighbors (inter)
+			float sum_u[3];
+			int neighbor_count = neighbor_direction_sum(ctx, u, sphere_filter, -1, sum_u);
+			double bx = sum_u[0], by = sum_u[1], bz = sum_u[2];
 
 			if (neighbor_count == 0)
 				continue;
@@ -507,16 +557,8 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 			double len = sqrt(bx * bx + by * by + bz * bz);
 			if (len < 0.0001)
 				continue;
-			bx = (bx / len) * radius;
-			by = (by / len) * radius;
-			bz = (bz / len) * radius;
-
-			double phi = acos(bz / radius);
-			double theta = atan2(by, bx);
-			if (theta < 0)
-				theta += 2 * M_PI;
 
-			int target_h = xy2d(hilbert_res, (int)((theta / (2 * M_PI)) * (hilbert_res - 1)), (int)((phi / M_PI) * (hilbert_res - 1)));
+			int target_h = direction_to_hilbert(bx / len, by / len, bz / len);
 
 			int current_h = ctx->grids[s].slots[current_slot].hilbert_dist;
 			int total_h = hilbert_res * hilbert_res;
@@ -537,30 +579,15 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 			if (target_slot == current_slot)
 				continue;
 
-			double delta;
-			if (is_intra)
-				delta = calculate_move_delta_intra(ig, ctx->layout, ctx, u, s, target_slot);
-			else
-				delta = calculate_move_delta_inter(ig, ctx->layout, ctx, u, s, target_slot);
+			double delta = calculate_move_delta(ctx, u, sum_u, s, sphere_filter, target_slot);
 
 			if (delta < -0.001) {
 				int v = ctx->grids[s].slot_occupant[target_slot];
-
-				MATRIX(*ctx->layout, u, 0) = ctx->grids[s].slots[target_slot].x;
-				MATRIX(*ctx->layout, u, 1) = ctx->grids[s].slots[target_slot].y;
-				MATRIX(*ctx->layout, u, 2) = ctx->grids[s].slots[target_slot].z;
-				ctx->grids[s].slot_occupant[target_slot] = u;
-				ctx->node_to_slot_idx[u] = target_slot;
-
-				if (v != -1) {
-					MATRIX(*ctx->layout, v, 0) = ctx->grids[s].slots[current_slot].x;
-					MATRIX(*ctx->layout, v, 1) = ctx->grids[s].slots[current_slot].y;
-					MATRIX(*ctx->layout, v, 2) = ctx->grids[s].slots[current_slot].z;
-					ctx->grids[s].slot_occupant[current_slot] = v;
-					ctx->node_to_slot_idx[v] = current_slot;
-				} else {
+				place_node(ctx, u, s, target_slot);
+				if (v != -1)
+					place_node(ctx, v, s, current_slot);
+				else
 					ctx->grids[s].slot_occupant[current_slot] = -1;
-				}
 
 				local_moves++;
 			}
@@ -587,24 +614,377 @@ static bool layered_sphere_iterate(LayeredSphereContext *ctx, const igraph_t *ig
 	return (ctx->phase != PHASE_DONE);
 }
 
+// Incremental run on the retained state: communities with a node whose neighbors changed are
+// re-detected on the subgraph they induce, join the sphere most of their members were on and are
+// placed next to their neighbors; only the spheres nodes leave or join are re-optimized, on the
+// existing slot grids. Takes ownership of the new adjacency unless it returns false, which means
+// too much changed (or the spheres ran out of slots) and the caller should rebuild from scratch.
+static bool layered_sphere_update(LayeredSphereContext *ctx, int *offsets, int *neighbors)
+{
+	int vcount = ctx->vcount;
+
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int i = 0; i < vcount; i++) {
+		int degree = offsets[i + 1] - offsets[i];
+		if (degree != ctx->adj_offsets[i + 1] - ctx->adj_offsets[i] || memcmp(neighbors + offsets[i], ctx->adj_neighbors + ctx->adj_offsets[i], degree * sizeof(int)) != 0)
+			ctx->touched[i] = 1;
+	}
+
+	// Communities with a touched member are re-detected as a whole
+	unsigned char *comm_affected = calloc(ctx->num_communities, 1);
+	for (int i = 0; i < vcount; i++) {
+		if (ctx->touched[i])
+			comm_affected[ctx->node_to_comm_id[i]] = 1;
+	}
+	int *affected = malloc(vcount * sizeof(int));
+	int *local = malloc(vcount * sizeof(int));
+	int count = 0;
+	for (int i = 0; i < vcount; i++)
+		local[i] = comm_affected[ctx->node_to_comm_id[i]] ? count++ : -1;
+	for (int i = 0; i < vcount; i++) {
+		if (local[i] >= 0)
+			affected[local[i]] = i;
+	}
+	free(comm_affected);
+
+	if (count > vcount * INCREMENTAL_REBUILD_FRACTION) {
+		free(affected);
+		free(local);
+		return false;
+	}
+
+	free(ctx->adj_offsets);
+	free(ctx->adj_neighbors);
+	ctx->adj_offsets = offsets;
+	ctx->adj_neighbors = neighbors;
+	memset(ctx->touched, 0, vcount);
+	memset(ctx->sphere_active, 0, ctx->num_spheres);
+
+	if (count > 0) {
+		igraph_vector_int_t sub_edges;
+		igraph_vector_int_init(&sub_edges, 0);
+		for (int a = 0; a < count; a++) {
+			int u = affected[a];
+			for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+				int b = local[neighbors[e]];
+				if (b > a) {
+					igraph_vector_int_push_back(&sub_edges, a);
+					igraph_vector_int_push_back(&sub_edges, b);
+				}
+			}
+		}
+		igraph_t sub_ig;
+		igraph_create(&sub_ig, &sub_edges, count, IGRAPH_UNDIRECTED);
+		igraph_simplify(&sub_ig, true, true, NULL);
+		igraph_vector_int_destroy(&sub_edges);
+
+		igraph_vector_int_t membership;
+		igraph_vector_int_init(&membership, count);
+		igraph_community_leiden(&sub_ig, NULL, NULL, NULL, ctx->cpm_resolution, 0.01, true, 2, &membership, NULL, NULL);
+		igraph_destroy(&sub_ig);
+
+		// Same order as the initial placement: by community, most connected within it first
+		NodePlacement *order = malloc(count * sizeof(NodePlacement));
+		for (int a = 0; a < count; a++) {
+			int u = affected[a];
+			order[a].id = u;
+			order[a].community_id = VECTOR(membership)[a];
+			order[a].density = 0.0;
+			order[a].intra_degree = 0;
+			for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+				int b = local[neighbors[e]];
+				order[a].intra_degree += b >= 0 && VECTOR(membership)[b] == VECTOR(membership)[a];
+			}
+		}
+		qsort(order, count, sizeof(NodePlacement), compare_nodes_placement);
+		igraph_vector_int_destroy(&membership);
+
+		// Each new community joins the sphere most of its members were on
+		int *free_slots = malloc(ctx->num_spheres * sizeof(int));
+		int *votes = calloc(ctx->num_spheres, sizeof(int));
+		for (int s = 0; s < ctx->num_spheres; s++)
+			free_slots[s] = ctx->grids[s].max_slots - (ctx->sphere_offsets[s + 1] - ctx->sphere_offsets[s]);
+		for (int begin = 0, end; begin < count; begin = end) {
+			int best = ctx->node_to_sphere_id[order[begin].id];
+			for (end = begin; end < count && order[end].community_id == order[begin].community_id; end++) {
+				int sphere = ctx->node_to_sphere_id[order[end].id];
+				if (++votes[sphere] > votes[best] || (votes[sphere] == votes[best] && sphere < best))
+					best = sphere;
+			}
+			for (int m = begin; m < end; m++) {
+				votes[ctx->node_to_sphere_id[order[m].id]] = 0;
+				order[m].intra_degree = best; // Reused as the target sphere from here on
+			}
+		}
+		free(votes);
+
+		// Vacate the old slots. Unplaced nodes get a zero direction, so neighbor sums skip them;
+		// the old one is kept for nodes without a placed neighbor.
+		float *old_dir = malloc(3 * count * sizeof(float));
+		for (int a = 0; a < count; a++) {
+			int u = affected[a], s = ctx->node_to_sphere_id[u];
+			ctx->grids[s].slot_occupant[ctx->node_to_slot_idx[u]] = -1;
+			ctx->sphere_active[s] = 1;
+			free_slots[s]++;
+			old_dir[3 * a] = ctx->dir_x[u];
+			old_dir[3 * a + 1] = ctx->dir_y[u];
+			old_dir[3 * a + 2] = ctx->dir_z[u];
+			ctx->dir_x[u] = ctx->dir_y[u] = ctx->dir_z[u] = 0.0f;
+		}
+
+		for (int m = 0; m < count; m++) {
+			int u = order[m].id, target = order[m].intra_degree, s = target;
+			// A full sphere sends the node to the nearest one with room (spheres whose slot
+			// count was capped can hold more nodes than slots)
+			for (int d = 1; free_slots[s] <= 0 && d < ctx->num_spheres; d++) {
+				if (target + d < ctx->num_spheres && free_slots[target + d] > 0)
+					s = target + d;
+				else if (target - d >= 0 && free_slots[target - d] > 0)
+					s = target - d;
+			}
+
+			float sum[3];
+			neighbor_direction_sum(ctx, u, s, -1, sum);
+			double len = sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+			if (len < 0.0001) {
+				neighbor_direction_sum(ctx, u, -1, -1, sum);
+				len = sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+			}
+			if (len < 0.0001) {
+				const float *dir = &old_dir[3 * local[u]];
+				sum[0] = dir[0];
+				sum[1] = dir[1];
+				sum[2] = dir[2];
+				len = 1.0;
+			}
+
+			int slot = free_slots[s] > 0 ? find_free_slot(&ctx->grids[s], direction_to_hilbert(sum[0] / len, sum[1] / len, sum[2] / len)) : -1;
+			if (slot < 0) {
+				// No room left anywhere. The state is half-updated, so it's dropped and the caller
+				// rebuilds from scratch with the adjacency it still owns.
+				ctx->adj_offsets = NULL;
+				ctx->adj_neighbors = NULL;
+				free(old_dir);
+				free(free_slots);
+				free(order);
+				free(affected);
+				free(local);
+				return false;
+			}
+			ctx->node_to_sphere_id[u] = s;
+			place_node(ctx, u, s, slot);
+			ctx->sphere_active[s] = 1;
+			free_slots[s]--;
+		}
+
+		// Fresh community ids, past the ones already in use
+		for (int a = 0; a < count; a++)
+			ctx->node_to_comm_id[order[a].id] = ctx->num_communities + order[a].community_id;
+		ctx->num_communities += order[count - 1].community_id + 1;
+
+		free(old_dir);
+		free(free_slots);
+		free(order);
+		build_sphere_members(ctx);
+	}
+
+	free(affected);
+	free(local);
+	write_positions(ctx);
+
+	ctx->current_iter = 0;
+	ctx->phase_iter = 0;
+	ctx->inter_sphere_pass = 0;
+	ctx->phase = count > 0 ? PHASE_INTRA_SPHERE : PHASE_DONE;
+	return true;
+}
+
+void layered_sphere_delete_vertices(GraphData *data, const igraph_vector_int_t *vids)
+{
+	// A finished stepped run joins the retained state below; an unfinished one can't follow the deletion
+	if (layered_sphere_unfinished(data)) {
+		layered_sphere_cleanup(data->layered_sphere_run);
+		data->layered_sphere_run = NULL;
+	}
+	layered_sphere_finish(data);
+
+	pthread_mutex_lock(&retained_mutex);
+	LayeredSphereContext *ctx = data->layered_sphere;
+	// A running layout holds the state; it turns stale instead of the deletion waiting for it
+	if (!ctx)
+		data->layered_sphere_epoch++;
+	if (ctx) {
+		int vcount = ctx->vcount;
+		int *old_to_new = calloc(vcount, sizeof(int));
+		for (igraph_integer_t k = 0; k < igraph_vector_int_size(vids); k++) {
+			if (VECTOR(*vids)[k] >= 0 && VECTOR(*vids)[k] < vcount)
+				old_to_new[VECTOR(*vids)[k]] = -1;
+		}
+		int kept = 0;
+		for (int i = 0; i < vcount; i++)
+			old_to_new[i] = old_to_new[i] < 0 ? -1 : kept++;
+
+		// Deleted nodes free their slots; their neighbors lose edges, so get re-assigned
+		for (int i = 0; i < vcount; i++) {
+			if (old_to_new[i] >= 0)
+				continue;
+			ctx->grids[ctx->node_to_sphere_id[i]].slot_occupant[ctx->node_to_slot_idx[i]] = -1;
+			for (int e = ctx->adj_offsets[i]; e < ctx->adj_offsets[i + 1]; e++)
+				ctx->touched[ctx->adj_neighbors[e]] = 1;
+		}
+
+		// Compact in place: new ids never exceed old ones and keep their order
+		int edge_out = 0;
+		for (int i = 0; i < vcount; i++) {
+			int k = old_to_new[i];
+			if (k < 0)
+				continue;
+			int begin = ctx->adj_offsets[i], end = ctx->adj_offsets[i + 1];
+			ctx->adj_offsets[k] = edge_out;
+			for (int e = begin; e < end; e++) {
+				int j = old_to_new[ctx->adj_neighbors[e]];
+				if (j >= 0)
+					ctx->adj_neighbors[edge_out++] = j;
+			}
+			ctx->node_to_sphere_id[k] = ctx->node_to_sphere_id[i];
+			ctx->node_to_slot_idx[k] = ctx->node_to_slot_idx[i];
+			ctx->node_to_comm_id[k] = ctx->node_to_comm_id[i];
+			ctx->dir_x[k] = ctx->dir_x[i];
+			ctx->dir_y[k] = ctx->dir_y[i];
+			ctx->dir_z[k] = ctx->dir_z[i];
+			ctx->touched[k] = ctx->touched[i];
+		}
+		ctx->adj_offsets[kept] = edge_out;
+		for (int s = 0; s < ctx->num_spheres; s++) {
+			for (int slot = 0; slot < ctx->grids[s].max_slots; slot++) {
+				if (ctx->grids[s].slot_occupant[slot] >= 0)
+					ctx->grids[s].slot_occupant[slot] = old_to_new[ctx->grids[s].slot_occupant[slot]];
+			}
+		}
+		ctx->vcount = kept;
+		build_sphere_members(ctx);
+		free(old_to_new);
+	}
+	pthread_mutex_unlock(&retained_mutex);
+}
+
+void layered_sphere_forget(GraphData *data)
+{
+	if (data->layered_sphere_run) {
+		layered_sphere_cleanup(data->layered_sphere_run);
+		data->layered_sphere_run = NULL;
+	}
+	pthread_mutex_lock(&retained_mutex);
+	LayeredSphereContext *ctx = data->layered_sphere;
+	data->layered_sphere = NULL;
+	data->layered_sphere_epoch++;
+	pthread_mutex_unlock(&retained_mutex);
+	if (ctx)
+		layered_sphere_cleanup(ctx);
+}
+
+// Build the CSR of graph and take the retained state of data for a run writing into layout:
+// incremental while the retained state still fits the graph, from scratch otherwise
+static LayeredSphereContext *layered_sphere_prepare(const igraph_t *graph, GraphData *data, igraph_matrix_t *layout, int *epoch)
+{
+	igraph_integer_t vcount = igraph_vcount(graph);
+
+	// All passes read neighbors from this CSR instead of igraph_incident + igraph_edge. Sorted
+	// slices compare directly against the retained run's.
+	igraph_vector_int_t edges;
+	igraph_vector_int_init(&edges, 0);
+	igraph_get_edgelist(graph, &edges, 0);
+	int *offsets = NULL, *neighbors = NULL;
+	bool ok = pivot_mds_adjacency((uint32_t)vcount, &edges, &offsets, &neighbors);
+	igraph_vector_int_destroy(&edges);
+	if (!ok)
+		return NULL;
+	sort_adjacency((int)vcount, offsets, neighbors);
+
+	// Filters and resets never wait for a run; they bump the epoch, and a stale state isn't returned
+	LayeredSphereContext *ctx = NULL;
+	*epoch = 0;
+	if (data) {
+		pthread_mutex_lock(&retained_mutex);
+		ctx = data->layered_sphere;
+		data->layered_sphere = NULL;
+		*epoch = data->layered_sphere_epoch;
+		pthread_mutex_unlock(&retained_mutex);
+	}
+	if (ctx)
+		ctx->layout = layout;
+	if (!ctx || vcount == 0 || ctx->vcount != vcount || !layered_sphere_update(ctx, offsets, neighbors)) {
+		if (ctx)
+			layered_sphere_cleanup(ctx);
+		ctx = calloc(1, sizeof(LayeredSphereContext));
+		ctx->vcount = vcount;
+		ctx->layout = layout;
+		ctx->adj_offsets = offsets;
+		ctx->adj_neighbors = neighbors;
+		ctx->phase = PHASE_INIT;
+		ctx->current_iter = 0;
+	}
+	return ctx;
+}
+
+// Hand the state of a finished run back to data for the next run, unless the graph changed since
+// it was taken; the positions stay with the caller
+static void layered_sphere_retain(GraphData *data, LayeredSphereContext *ctx, int epoch)
+{
+	if (ctx->owns_layout) {
+		igraph_matrix_destroy(ctx->layout);
+		free(ctx->layout);
+		ctx->owns_layout = false;
+	}
+	ctx->layout = NULL;
+	if (data) {
+		pthread_mutex_lock(&retained_mutex);
+		if (data->layered_sphere_epoch == epoch && !data->layered_sphere) {
+			data->layered_sphere = ctx;
+			ctx = NULL;
+		}
+		pthread_mutex_unlock(&retained_mutex);
+	}
+	if (ctx)
+		layered_sphere_cleanup(ctx);
+}
+
+// One shell per occupied sphere, at the radius its slots were laid out on
+static float *layered_sphere_shells(const LayeredSphereContext *ctx, uint32_t *count)
+{
+	float *radii = malloc(sizeof(float) * (ctx->num_spheres + 1));
+	*count = 0;
+	for (int s = 0; s < ctx->num_spheres && ctx->sphere_offsets; s++) {
+		if (ctx->sphere_offsets[s + 1] > ctx->sphere_offsets[s])
+			radii[(*count)++] = (float)ctx->grids[s].radius;
+	}
+	return radii;
+}
+
 void *compute_layout_layered_sphere(igraph_t *graph)
 {
 	igraph_integer_t vcount = igraph_vcount(graph);
-	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
+	LayeredSphereResult *sphere_result = calloc(1, sizeof(LayeredSphereResult));
+	igraph_matrix_t *result = &sphere_result->layout;
 	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
-		free(result);
+		free(sphere_result);
 		return NULL;
 	}
 
-	LayeredSphereContext *ctx = calloc(1, sizeof(LayeredSphereContext));
-	ctx->vcount = vcount;
-	ctx->layout = result;
-	ctx->phase = PHASE_INIT;
-	ctx->current_iter = 0;
-
 	igraph_progress("Layered Sphere layout", 0.0, NULL);
 
-	const int total_iters = MAX_INTRA_ITERS + MAX_INTER_ITERS;
+	// The run takes the retained state of the job's graph and returns it when done
+	GraphData *data = worker_thread_graph();
+	if (data && &data->g != graph)
+		data = NULL;
+	int epoch;
+	LayeredSphereContext *ctx = layered_sphere_prepare(graph, data, result, &epoch);
+	if (!ctx) {
+		igraph_matrix_destroy(result);
+		free(sphere_result);
+		return NULL;
+	}
+
 	const double intra_weight = 50.0;
 	const double inter_weight = 50.0;
 
@@ -620,7 +1000,111 @@ void *compute_layout_layered_sphere(igraph_t *graph)
 
 	igraph_progress("Layered Sphere layout", 100.0, NULL);
 
-	layered_sphere_cleanup(ctx);
+	sphere_result->shell_radii = layered_sphere_shells(ctx, &sphere_result->shell_count);
+	layered_sphere_retain(data, ctx, epoch);
+	return sphere_result;
+}
+
+bool layered_sphere_start(GraphData *data)
+{
+	if (data->layered_sphere_run) {
+		if (layered_sphere_unfinished(data))
+			return true;
+		layered_sphere_finish(data);
+	}
+	if (!data->graph_initialized)
+		return false;
 
-	return result;
+	// Starts from the current positions, so the graph never collapses before the first pass
+	uint32_t n = (uint32_t)igraph_vcount(&data->g);
+	igraph_matrix_t *layout = malloc(sizeof(igraph_matrix_t));
+	igraph_matrix_init(layout, n, 3);
+	int cols = (int)igraph_matrix_ncol(&data->current_layout);
+	if (igraph_matrix_nrow(&data->current_layout) == n && cols >= 2) {
+		for (uint32_t i = 0; i < n; i++) {
+			for (int c = 0; c < 3 && c < cols; c++)
+				MATRIX(*layout, i, c) = MATRIX(data->current_layout, i, c);
+		}
+	}
+
+	int epoch;
+	LayeredSphereContext *ctx = layered_sphere_prepare(&data->g, data, layout, &epoch);
+	if (!ctx) {
+		igraph_matrix_destroy(layout);
+		free(layout);
+		return false;
+	}
+	ctx->owns_layout = true;
+	ctx->epoch = epoch;
+	data->layered_sphere_run = ctx;
+	return true;
+}
+
+bool layered_sphere_unfinished(const GraphData *data)
+{
+	return data->layered_sphere_run && data->layered_sphere_run->phase != PHASE_DONE;
+}
+
+bool layered_sphere_iterate_run(GraphData *data)
+{
+	return data->layered_sphere_run && layered_sphere_iterate(data->layered_sphere_run, &data->g);
+}
+
+int layered_sphere_run_iteration(const GraphData *data)
+{
+	return data->layered_sphere_run ? data->layered_sphere_run->current_iter : 0;
+}
+
+void layered_sphere_get_positions(const GraphData *data, vec3 *out)
+{
+	const LayeredSphereContext *ctx = data->layered_sphere_run;
+	if (!ctx)
+		return;
+	for (int i = 0; i < ctx->vcount; i++) {
+		out[i][0] = (float)MATRIX(*ctx->layout, i, 0);
+		out[i][1] = (float)MATRIX(*ctx->layout, i, 1);
+		out[i][2] = (float)MATRIX(*ctx->layout, i, 2);
+	}
+}
+
+void layered_sphere_copy_layout(const GraphData *data, igraph_matrix_t *out)
+{
+	const LayeredSphereContext *ctx = data->layered_sphere_run;
+	if (!ctx)
+		return;
+	igraph_matrix_update(out, ctx->layout);
+}
+
+float *layered_sphere_shell_radii(const GraphData *data, uint32_t *count)
+{
+	*count = 0;
+	if (!data->layered_sphere_run || data->layered_sphere_run->phase == PHASE_INIT)
+		return NULL;
+	return layered_sphere_shells(data->layered_sphere_run, count);
+}
+
+void layered_sphere_finish(GraphData *data)
+{
+	LayeredSphereContext *ctx = data->layered_sphere_run;
+	data->layered_sphere_run = NULL;
+	if (ctx)
+		layered_sphere_retain(data, ctx, ctx->epoch);
+}
+
+void apply_layout_layered_sphere(ExecutionContext *ctx, void *result_data)
+{
+	if (!result_data)
+		return;
+	LayeredSphereResult *sphere_result = (LayeredSphereResult *)result_data;
+	apply_layout_matrix_with_shells(ctx, &sphere_result->layout, sphere_result->shell_radii, sphere_result->shell_count);
+}
+
+void free_layout_layered_sphere(void *result_data)
+{
+	LayeredSphereResult *sphere_result = (LayeredSphereResult *)result_data;
+	if (!sphere_result)
+		return;
+	igraph_matrix_destroy(&sphere_result->layout);
+	free(sphere_result->shell_radii);
+	free(sphere_result);
 }
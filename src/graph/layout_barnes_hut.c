@@ -0,0 +1,488 @@
+#include "graph/layout_barnes_hut.h"
+
+#include <cglm/cglm.h>
+#include <float.h>
+#include <math.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph/graph_rng.h"
+
+// Morton codes interleave this many bits per axis, which also bounds the octree depth
+#define MORTON_BITS 10
+// Subtrees with more bodies than this are built as separate OpenMP tasks
+#define TASK_MIN_BODIES 4096
+// Keeps coincident bodies from producing infinite forces
+#define SOFTENING 1e-4f
+// Traversal stack: at most 8 pending children per level
+#define STACK_SIZE (8 * (MORTON_BITS + 2))
+
+static void free_state(BarnesHutContext *ctx)
+{
+	free(ctx->x);
+	free(ctx->y);
+	free(ctx->z);
+	free(ctx->fx);
+	free(ctx->fy);
+	free(ctx->fz);
+	free(ctx->adj_offsets);
+	free(ctx->adj_neighbors);
+	free(ctx->codes);
+	free(ctx->order);
+	free(ctx->sx);
+	free(ctx->sy);
+	free(ctx->sz);
+	free(ctx->sort_keys);
+	free(ctx->sort_values);
+	free(ctx->cells);
+}
+
+static void alloc_state(BarnesHutContext *ctx, uint32_t n)
+{
+	free_state(ctx);
+	ctx->node_count = n;
+	ctx->x = malloc(sizeof(float) * (n + 1));
+	ctx->y = malloc(sizeof(float) * (n + 1));
+	ctx->z = malloc(sizeof(float) * (n + 1));
+	ctx->fx = malloc(sizeof(float) * (n + 1));
+	ctx->fy = malloc(sizeof(float) * (n + 1));
+	ctx->fz = malloc(sizeof(float) * (n + 1));
+	ctx->codes = malloc(sizeof(uint32_t) * (n + 1));
+	ctx->order = malloc(sizeof(int) * (n + 1));
+	ctx->sx = malloc(sizeof(float) * (n + 1));
+	ctx->sy = malloc(sizeof(float) * (n + 1));
+	ctx->sz = malloc(sizeof(float) * (n + 1));
+	ctx->sort_keys = malloc(sizeof(uint32_t) * (n + 1));
+	ctx->sort_values = malloc(sizeof(int) * (n + 1));
+	// Every internal cell has at least two children and every leaf a body: < 2n cells
+	ctx->cell_capacity = 2 * n + 1;
+	ctx->cells = malloc(sizeof(BarnesHutCell) * ctx->cell_capacity);
+	ctx->adj_offsets = NULL;
+	ctx->adj_neighbors = NULL;
+}
+
+// CSR from either the graph's edges or an igraph edge list (exactly one is given)
+static void build_adjacency(BarnesHutContext *ctx, uint32_t edge_count, const Edge *edges, const igraph_vector_int_t *list)
+{
+	uint32_t n = ctx->node_count;
+	ctx->edge_count = edge_count;
+	ctx->adj_offsets = calloc(n + 1, sizeof(int));
+	for (uint32_t e = 0; e < edge_count; e++) {
+		int a = edges ? (int)edges[e].from : (int)VECTOR(*list)[2 * e];
+		int b = edges ? (int)edges[e].to : (int)VECTOR(*list)[2 * e + 1];
+		if (a == b)
+			continue;
+		ctx->adj_offsets[a + 1]++;
+		ctx->adj_offsets[b + 1]++;
+	}
+	for (uint32_t i = 0; i < n; i++)
+		ctx->adj_offsets[i + 1] += ctx->adj_offsets[i];
+
+	ctx->adj_neighbors = malloc(sizeof(int) * (ctx->adj_offsets[n] + 1));
+	int *fill = malloc(sizeof(int) * (n + 1));
+	memcpy(fill, ctx->adj_offsets, sizeof(int) * (n + 1));
+	for (uint32_t e = 0; e < edge_count; e++) {
+		int a = edges ? (int)edges[e].from : (int)VECTOR(*list)[2 * e];
+		int b = edges ? (int)edges[e].to : (int)VECTOR(*list)[2 * e + 1];
+		if (a == b)
+			continue;
+		ctx->adj_neighbors[fill[a]++] = b;
+		ctx->adj_neighbors[fill[b]++] = a;
+	}
+	free(fill);
+}
+
+static void bounding_cube(const BarnesHutContext *ctx, float lo[3], float *size)
+{
+	float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+	float max_x = -FLT_MAX, max_y = -FLT_MAX, max_z = -FLT_MAX;
+#pragma omp parallel for reduction(min : min_x, min_y, min_z) reduction(max : max_x, max_y, max_z)
+	for (int i = 0; i < (int)ctx->node_count; i++) {
+		min_x = fminf(min_x, ctx->x[i]);
+		min_y = fminf(min_y, ctx->y[i]);
+		min_z = fminf(min_z, ctx->z[i]);
+		max_x = fmaxf(max_x, ctx->x[i]);
+		max_y = fmaxf(max_y, ctx->y[i]);
+		max_z = fmaxf(max_z, ctx->z[i]);
+	}
+	lo[0] = min_x;
+	lo[1] = min_y;
+	lo[2] = min_z;
+	*size = fmaxf(fmaxf(max_x - min_x, max_y - min_y), max_z - min_z);
+}
+
+// Scale parameters to the starting layout, so warm starts keep their size
+static void init_schedule(BarnesHutContext *ctx)
+{
+	float lo[3], size;
+	bounding_cube(ctx, lo, &size);
+	float k = cbrtf(size * size * size / (float)(ctx->node_count ? ctx->node_count : 1));
+	ctx->ideal_length = k > 1e-6f ? k : 1.0f;
+	ctx->start_temperature = fmaxf(0.1f * size, ctx->ideal_length);
+	ctx->iteration = 0;
+	ctx->max_iterations = BARNES_HUT_ITERATIONS;
+	ctx->num_threads = omp_get_max_threads();
+}
+
+void barnes_hut_init(BarnesHutContext *ctx, const GraphData *graph)
+{
+	memset(ctx, 0, sizeof(BarnesHutContext));
+	alloc_state(ctx, graph->node_count);
+	build_adjacency(ctx, graph->edge_count, graph->edges, NULL);
+	for (uint32_t i = 0; i < graph->node_count; i++) {
+		ctx->x[i] = graph->nodes[i].position[0];
+		ctx->y[i] = graph->nodes[i].position[1];
+		ctx->z[i] = graph->nodes[i].position[2];
+	}
+	init_schedule(ctx);
+}
+
+void barnes_hut_init_edges(BarnesHutContext *ctx, uint32_t node_count, const igraph_vector_int_t *edges, const igraph_matrix_t *seed)
+{
+	memset(ctx, 0, sizeof(BarnesHutContext));
+	alloc_state(ctx, node_count);
+	build_adjacency(ctx, (uint32_t)(igraph_vector_int_size(edges) / 2), NULL, edges);
+	if (seed) {
+		for (uint32_t i = 0; i < node_count; i++) {
+			ctx->x[i] = (float)MATRIX(*seed, i, 0);
+			ctx->y[i] = (float)MATRIX(*seed, i, 1);
+			ctx->z[i] = (float)MATRIX(*seed, i, 2);
+		}
+		init_schedule(ctx);
+		return;
+	}
+	// Seeded random cube with about one node per unit volume
+	float side = cbrtf((float)node_count);
+	for (uint32_t i = 0; i < node_count; i++) {
+		ctx->x[i] = graph_rng_float(GRAPH_RNG_STREAM_BARNES_HUT, i, 0) * side;
+		ctx->y[i] = graph_rng_float(GRAPH_RNG_STREAM_BARNES_HUT, i, 1) * side;
+		ctx->z[i] = graph_rng_float(GRAPH_RNG_STREAM_BARNES_HUT, i, 2) * side;
+	}
+	init_schedule(ctx);
+}
+
+void barnes_hut_cleanup(BarnesHutContext *ctx)
+{
+	free_state(ctx);
+	memset(ctx, 0, sizeof(BarnesHutContext));
+}
+
+void barnes_hut_sync(BarnesHutContext *ctx, const GraphData *graph)
+{
+	// Filtering replaces the graph under a live context; the run continues on the new graph
+	if (graph->node_count != ctx->node_count || graph->edge_count != ctx->edge_count) {
+		int iteration = ctx->iteration;
+		float k = ctx->ideal_length, temperature = ctx->start_temperature;
+		alloc_state(ctx, graph->node_count);
+		build_adjacency(ctx, graph->edge_count, graph->edges, NULL);
+		ctx->iteration = iteration;
+		ctx->ideal_length = k;
+		ctx->start_temperature = temperature;
+	}
+	for (uint32_t i = 0; i < graph->node_count; i++) {
+		ctx->x[i] = graph->nodes[i].position[0];
+		ctx->y[i] = graph->nodes[i].position[1];
+		ctx->z[i] = graph->nodes[i].position[2];
+	}
+}
+
+// Spread the low 10 bits of v to every third bit
+static inline uint32_t expand_bits(uint32_t v)
+{
+	v &= 0x3ff;
+	v = (v | (v << 16)) & 0x030000ff;
+	v = (v | (v << 8)) & 0x0300f00f;
+	v = (v | (v << 4)) & 0x030c30c3;
+	v = (v | (v << 2)) & 0x09249249;
+	return v;
+}
+
+// LSD radix sort of (code, node) pairs, 8 bits per pass; an even pass count leaves the
+// result in codes/order
+static void sort_by_code(BarnesHutContext *ctx)
+{
+	uint32_t n = ctx->node_count;
+	uint32_t *keys = ctx->codes, *keys_tmp = ctx->sort_keys;
+	int *values = ctx->order, *values_tmp = ctx->sort_values;
+	for (int shift = 0; shift < 32; shift += 8) {
+		uint32_t count[257] = {0};
+		for (uint32_t i = 0; i < n; i++)
+			count[((keys[i] >> shift) & 0xff) + 1]++;
+		for (int b = 0; b < 256; b++)
+			count[b + 1] += count[b];
+		for (uint32_t i = 0; i < n; i++) {
+			uint32_t dst = count[(keys[i] >> shift) & 0xff]++;
+			keys_tmp[dst] = keys[i];
+			values_tmp[dst] = values[i];
+		}
+		uint32_t *k = keys;
+		keys = keys_tmp;
+		keys_tmp = k;
+		int *v = values;
+		values = values_tmp;
+		values_tmp = v;
+	}
+}
+
+// First body in [begin, end) whose octant at shift is >= octant (octants are sorted there)
+static int octant_lower_bound(const uint32_t *codes, int begin, int end, int shift, uint32_t octant)
+{
+	while (begin < end) {
+		int mid = begin + (end - begin) / 2;
+		if (((codes[mid] >> shift) & 7) < octant)
+			begin = mid + 1;
+		else
+			end = mid;
+	}
+	return begin;
+}
+
+static void build_cell(BarnesHutContext *ctx, int c, int begin, int end, int level, float size)
+{
+	const uint32_t *codes = ctx->codes;
+
+	// Descend while all bodies share one octant, so every internal cell splits
+	while (end - begin > BARNES_HUT_LEAF_SIZE && level < MORTON_BITS) {
+		int shift = 3 * (MORTON_BITS - 1 - level);
+		if (((codes[begin] >> shift) & 7) != ((codes[end - 1] >> shift) & 7))
+			break;
+		size *= 0.5f;
+		level++;
+	}
+
+	BarnesHutCell *cell = &ctx->cells[c];
+	cell->size = size;
+	cell->begin = begin;
+	cell->end = end;
+
+	if (end - begin <= BARNES_HUT_LEAF_SIZE || level >= MORTON_BITS) {
+		float mx = 0.0f, my = 0.0f, mz = 0.0f;
+		for (int i = begin; i < end; i++) {
+			mx += ctx->sx[i];
+			my += ctx->sy[i];
+			mz += ctx->sz[i];
+		}
+		cell->mass = (float)(end - begin);
+		cell->com[0] = mx / cell->mass;
+		cell->com[1] = my / cell->mass;
+		cell->com[2] = mz / cell->mass;
+		cell->first_child = -1;
+		cell->child_count = 0;
+		return;
+	}
+
+	int shift = 3 * (MORTON_BITS - 1 - level);
+	int bounds[9];
+	bounds[0] = begin;
+	bounds[8] = end;
+	for (uint32_t o = 1; o < 8; o++)
+		bounds[o] = octant_lower_bound(codes, bounds[o - 1], end, shift, o);
+
+	int children = 0;
+	for (int o = 0; o < 8; o++)
+		children += bounds[o] < bounds[o + 1];
+	int first;
+#pragma omp atomic capture
+	{
+		first = ctx->cell_count;
+		ctx->cell_count += children;
+	}
+	cell->first_child = first;
+	cell->child_count = children;
+
+	int child = first;
+	for (int o = 0; o < 8; o++) {
+		int b = bounds[o], e = bounds[o + 1];
+		if (b == e)
+			continue;
+		if (e - b > TASK_MIN_BODIES) {
+#pragma omp task firstprivate(child, b, e)
+			build_cell(ctx, child, b, e, level + 1, size * 0.5f);
+		} else {
+			build_cell(ctx, child, b, e, level + 1, size * 0.5f);
+		}
+		child++;
+	}
+#pragma omp taskwait
+
+	float mx = 0.0f, my = 0.0f, mz = 0.0f;
+	for (int i = 0; i < children; i++) {
+		const BarnesHutCell *ch = &ctx->cells[first + i];
+		mx += ch->com[0] * ch->mass;
+		my += ch->com[1] * ch->mass;
+		mz += ch->com[2] * ch->mass;
+	}
+	cell->mass = (float)(end - begin);
+	cell->com[0] = mx / cell->mass;
+	cell->com[1] = my / cell->mass;
+	cell->com[2] = mz / cell->mass;
+}
+
+// Sort bodies along a Morton curve and build the octree over the sorted ranges
+static void build_tree(BarnesHutContext *ctx)
+{
+	int n = (int)ctx->node_count;
+	float lo[3], size;
+	bounding_cube(ctx, lo, &size);
+	size = size * 1.0001f + 1e-6f;
+	float scale = (float)(1 << MORTON_BITS) / size;
+
+#pragma omp parallel for
+	for (int i = 0; i < n; i++) {
+		uint32_t qx = (uint32_t)fminf((ctx->x[i] - lo[0]) * scale, (float)((1 << MORTON_BITS) - 1));
+		uint32_t qy = (uint32_t)fminf((ctx->y[i] - lo[1]) * scale, (float)((1 << MORTON_BITS) - 1));
+		uint32_t qz = (uint32_t)fminf((ctx->z[i] - lo[2]) * scale, (float)((1 << MORTON_BITS) - 1));
+		ctx->codes[i] = (expand_bits(qx) << 2) | (expand_bits(qy) << 1) | expand_bits(qz);
+		ctx->order[i] = i;
+	}
+	sort_by_code(ctx);
+
+#pragma omp parallel for
+	for (int i = 0; i < n; i++) {
+		int v = ctx->order[i];
+		ctx->sx[i] = ctx->x[v];
+		ctx->sy[i] = ctx->y[v];
+		ctx->sz[i] = ctx->z[v];
+	}
+
+	ctx->cell_count = 1;
+#pragma omp parallel
+#pragma omp single
+	build_cell(ctx, 0, 0, n, 0, size);
+}
+
+// Repulsion k^2/d from every other body, with far cells approximated by their center of mass
+static void compute_repulsion(BarnesHutContext *ctx)
+{
+	const float k2 = ctx->ideal_length * ctx->ideal_length;
+	const float theta2 = BARNES_HUT_THETA * BARNES_HUT_THETA;
+	const BarnesHutCell *cells = ctx->cells;
+	const float *sx = ctx->sx, *sy = ctx->sy, *sz = ctx->sz;
+
+	// Bodies in Morton order: neighboring iterations walk nearly the same cells
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < (int)ctx->node_count; i++) {
+		float px = sx[i], py = sy[i], pz = sz[i];
+		float ax = 0.0f, ay = 0.0f, az = 0.0f;
+		int stack[STACK_SIZE];
+		int top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const BarnesHutCell *c = &cells[stack[--top]];
+			if (c->first_child < 0) {
+				// Leaf: exact sum over its bodies (the body itself contributes zero)
+				float lx = 0.0f, ly = 0.0f, lz = 0.0f;
+#pragma omp simd reduction(+ : lx, ly, lz)
+				for (int j = c->begin; j < c->end; j++) {
+					float dx = sx[j] - px, dy = sy[j] - py, dz = sz[j] - pz;
+					float s = k2 / (dx * dx + dy * dy + dz * dz + SOFTENING);
+					lx -= dx * s;
+					ly -= dy * s;
+					lz -= dz * s;
+				}
+				ax += lx;
+				ay += ly;
+				az += lz;
+				continue;
+			}
+			float dx = c->com[0] - px, dy = c->com[1] - py, dz = c->com[2] - pz;
+			float d2 = dx * dx + dy * dy + dz * dz + SOFTENING;
+			// Never approximate a cell that contains the body itself
+			bool contains = i >= c->begin && i < c->end;
+			if (!contains && c->size * c->size < theta2 * d2) {
+				float s = c->mass * k2 / d2;
+				ax -= dx * s;
+				ay -= dy * s;
+				az -= dz * s;
+			} else {
+				for (int ch = 0; ch < c->child_count; ch++)
+					stack[top++] = c->first_child + ch;
+			}
+		}
+		int v = ctx->order[i];
+		ctx->fx[v] = ax;
+		ctx->fy[v] = ay;
+		ctx->fz[v] = az;
+	}
+}
+
+// Spring attraction d^2/k along every edge
+static void add_attraction(BarnesHutContext *ctx)
+{
+	const float inv_k = 1.0f / ctx->ideal_length;
+#pragma omp parallel for schedule(dynamic, 256)
+	for (int u = 0; u < (int)ctx->node_count; u++) {
+		float px = ctx->x[u], py = ctx->y[u], pz = ctx->z[u];
+		float ax = 0.0f, ay = 0.0f, az = 0.0f;
+		for (int e = ctx->adj_offsets[u]; e < ctx->adj_offsets[u + 1]; e++) {
+			int v = ctx->adj_neighbors[e];
+			float dx = ctx->x[v] - px, dy = ctx->y[v] - py, dz = ctx->z[v] - pz;
+			float s = sqrtf(dx * dx + dy * dy + dz * dz) * inv_k;
+			ax += dx * s;
+			ay += dy * s;
+			az += dz * s;
+		}
+		ctx->fx[u] += ax;
+		ctx->fy[u] += ay;
+		ctx->fz[u] += az;
+	}
+}
+
+bool barnes_hut_iterate(BarnesHutContext *ctx)
+{
+	if (ctx->iteration >= ctx->max_iterations || ctx->node_count == 0)
+		return false;
+
+	build_tree(ctx);
+	compute_repulsion(ctx);
+	add_attraction(ctx);
+
+	// Displacement capped by a temperature that cools linearly over the run
+	float temperature = ctx->start_temperature * (1.0f - (float)ctx->iteration / (float)ctx->max_iterations);
+	float *x = ctx->x, *y = ctx->y, *z = ctx->z;
+	const float *fx = ctx->fx, *fy = ctx->fy, *fz = ctx->fz;
+#pragma omp parallel for simd
+	for (int i = 0; i < (int)ctx->node_count; i++) {
+		float f = sqrtf(fx[i] * fx[i] + fy[i] * fy[i] + fz[i] * fz[i]);
+		float s = f > 0.0f ? fminf(f, temperature) / f : 0.0f;
+		x[i] += fx[i] * s;
+		y[i] += fy[i] * s;
+		z[i] += fz[i] * s;
+	}
+
+	ctx->iteration++;
+	return true;
+}
+
+void barnes_hut_get_positions(const BarnesHutContext *ctx, vec3 *out)
+{
+	for (uint32_t i = 0; i < ctx->node_count; i++) {
+		out[i][0] = ctx->x[i];
+		out[i][1] = ctx->y[i];
+		out[i][2] = ctx->z[i];
+	}
+}
+
+bool barnes_hut_step(BarnesHutContext *ctx, GraphData *graph)
+{
+	if (ctx->iteration >= ctx->max_iterations)
+		return false;
+
+	barnes_hut_sync(ctx, graph);
+	if (!barnes_hut_iterate(ctx))
+		return false;
+
+	// Sync to layout matrix for other parts of app
+	bool has_z = igraph_matrix_ncol(&graph->current_layout) > 2;
+	for (uint32_t i = 0; i < graph->node_count; i++) {
+		graph->nodes[i].position[0] = ctx->x[i];
+		graph->nodes[i].position[1] = ctx->y[i];
+		graph->nodes[i].position[2] = ctx->z[i];
+		MATRIX(graph->current_layout, i, 0) = ctx->x[i];
+		MATRIX(graph->current_layout, i, 1) = ctx->y[i];
+		if (has_z)
+			MATRIX(graph->current_layout, i, 2) = ctx->z[i];
+	}
+	return true;
+}
@@ -8,14 +8,31 @@
 #include <string.h>
 
 #include "graph/graph_core.h"
+#include "graph/graph_rng.h"
 
+// Reference grid: 128 cells over 4000 units; larger graphs get a larger view at the same cell size
 #define GRID_DIM 128
-#define GRID_VOL (GRID_DIM * GRID_DIM * GRID_DIM)
 #define VIEW_SIZE 4000.0f
-#define HALF_VIEW (VIEW_SIZE * 0.5f)
-#define VIEW_TO_GRID (GRID_DIM / VIEW_SIZE)
+#define VIEW_NODE_REF 100000.0f
+#define GRID_MAX 1024
 #define RADIUS 10
 
+// Sparse grid storage: BRICK_DIM^3 cells per brick, bricks allocated on demand
+#define BRICK_SHIFT 3
+#define BRICK_DIM (1 << BRICK_SHIFT)
+#define BRICK_MASK (BRICK_DIM - 1)
+#define BRICK_VOL (BRICK_DIM * BRICK_DIM * BRICK_DIM)
+// Bricks a stencil can reach beyond the brick of its center
+#define BRICK_REACH ((RADIUS + BRICK_DIM - 1) / BRICK_DIM)
+
+struct OpenOrdBrick
+{
+	float density[BRICK_VOL];
+	uint32_t count[BRICK_VOL];
+	int key; // Brick coordinate (bz * n + by) * n + bx
+};
+
+// Indexed [z][y][x] so a row of the stencil is contiguous for SIMD
 static float fall_off[RADIUS * 2 + 1][RADIUS * 2 + 1][RADIUS * 2 + 1];
 
 static void init_falloff()
@@ -27,7 +44,7 @@ static void init_falloff()
 		for (int j = -RADIUS; j <= RADIUS; j++) {
 			for (int k = -RADIUS; k <= RADIUS; k++) {
 				float dist = sqrtf(i * i + j * j + k * k);
-				fall_off[i + RADIUS][j + RADIUS][k + RADIUS] = (float)((RADIUS - fminf(dist, RADIUS)) / RADIUS);
+				fall_off[k + RADIUS][j + RADIUS][i + RADIUS] = (float)((RADIUS - fminf(dist, RADIUS)) / RADIUS);
 			}
 		}
 	}
@@ -54,31 +71,295 @@ const char *openord_get_stage_name(int stage_id)
 	}
 }
 
-void openord_init(OpenOrdContext *ctx, int node_count, int grid_size)
+static void free_level(OpenOrdLevel *level)
 {
-	memset(ctx, 0, sizeof(OpenOrdContext));
-	init_falloff();
+	free(level->adj_offsets);
+	free(level->adj_neighbors);
+	free(level->adj_weights);
+	free(level->mass);
+	free(level->parent);
+	free(level->positions);
+	free(level->next_positions);
+	memset(level, 0, sizeof(OpenOrdLevel));
+}
 
-	ctx->grid_size = GRID_DIM;
-	ctx->view_size = VIEW_SIZE;
-	ctx->radius = (float)RADIUS;
+// Level 0: flatten the input edge list into CSR once, instead of an igraph_neighbors
+// fetch per energy evaluation
+static void build_input_level(OpenOrdContext *ctx, const GraphData *graph)
+{
+	for (int l = 0; l < ctx->level_count; l++)
+		free_level(&ctx->levels[l]);
+
+	OpenOrdLevel *level = &ctx->levels[0];
+	uint32_t n = graph->node_count;
+	free(ctx->cut_targets);
+	ctx->cut_targets = malloc(sizeof(int) * (n + 1));
+	ctx->level_count = 1;
+	ctx->level = 0;
+	ctx->input_node_count = n;
+	ctx->input_edge_count = graph->edge_count;
+
+	level->node_count = n;
+	level->positions = malloc(sizeof(vec3) * (n + 1));
+	level->next_positions = malloc(sizeof(vec3) * (n + 1));
+	for (uint32_t i = 0; i < n; i++)
+		glm_vec3_copy((float *)graph->nodes[i].position, level->positions[i]);
+
+	level->adj_offsets = calloc(n + 1, sizeof(int));
+	for (uint32_t e = 0; e < graph->edge_count; e++) {
+		const Edge *edge = &graph->edges[e];
+		if (edge->from == edge->to)
+			continue;
+		level->adj_offsets[edge->from + 1]++;
+		level->adj_offsets[edge->to + 1]++;
+	}
+	for (uint32_t i = 0; i < n; i++)
+		level->adj_offsets[i + 1] += level->adj_offsets[i];
+
+	int total = level->adj_offsets[n];
+	level->adj_neighbors = malloc(sizeof(int) * (total + 1));
+	level->adj_weights = malloc(sizeof(float) * (total + 1));
+	int *fill = malloc(sizeof(int) * (n + 1));
+	memcpy(fill, level->adj_offsets, sizeof(int) * (n + 1));
+	for (uint32_t e = 0; e < graph->edge_count; e++) {
+		const Edge *edge = &graph->edges[e];
+		if (edge->from == edge->to)
+			continue;
+		int a = fill[edge->from]++;
+		level->adj_neighbors[a] = edge->to;
+		level->adj_weights[a] = edge->size;
+		int b = fill[edge->to]++;
+		level->adj_neighbors[b] = edge->from;
+		level->adj_weights[b] = edge->size;
+	}
+	free(fill);
+}
 
-	// Allocate density grid (can be huge, maybe use sparse if memory is issue,
-	// but 128^3 is 2M floats = 8MB, OK) If user wants larger, we might need a
-	// hash map. For now, 128^3 is fast.
-	ctx->density_grid = calloc(GRID_VOL, sizeof(float));
-
-	// Stages setup based on original implementation
-	// Liquid
-	ctx->stages[0] = (OpenOrdStage){200, 2000.0f, 2.0f, 1.0f, 0, 0, 0, 0, 0};
-	// Expansion
-	ctx->stages[1] = (OpenOrdStage){200, 2000.0f, 10.0f, 1.0f, 0, 0, 0, 0, 0};
-	// Cooldown
-	ctx->stages[2] = (OpenOrdStage){200, 2000.0f, 1.0f, 0.1f, 0, 0, 0, 0, 0};
-	// Crunch
-	ctx->stages[3] = (OpenOrdStage){50, 250.0f, 1.0f, 0.25f, 0, 0, 0, 0, 0};
-	// Simmer
-	ctx->stages[4] = (OpenOrdStage){100, 250.0f, 0.5f, 0.0f, 0, 0, 0, 0, 0};
+static inline uint32_t level_mass(const OpenOrdLevel *level, int i)
+{
+	return level->mass ? level->mass[i] : 1;
+}
+
+typedef struct
+{
+	int neighbor;
+	float weight;
+} OpenOrdCoarseEdge;
+
+// Heaviest first; ties by neighbor so the order doesn't depend on qsort
+static int compare_coarse_edges(const void *a, const void *b)
+{
+	const OpenOrdCoarseEdge *x = a, *y = b;
+	if (x->weight != y->weight)
+		return x->weight > y->weight ? -1 : 1;
+	return (x->neighbor > y->neighbor) - (x->neighbor < y->neighbor);
+}
+
+// Heavy-edge matching: visit nodes by increasing degree and merge each with its heaviest
+// unmatched neighbor. Leftover nodes sharing a heaviest neighbor (star leaves) are paired
+// too, so hubs don't stall the coarsening. Returns false if the level barely shrank.
+static bool coarsen_level(OpenOrdLevel *fine, OpenOrdLevel *coarse)
+{
+	uint32_t n = fine->node_count;
+	int *order = malloc(sizeof(int) * (n + 1));
+	int *match = malloc(sizeof(int) * (n + 1));
+	int *pending = malloc(sizeof(int) * (n + 1));
+
+	// Counting sort by degree
+	int max_degree = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		int d = fine->adj_offsets[i + 1] - fine->adj_offsets[i];
+		if (d > max_degree)
+			max_degree = d;
+	}
+	int *bucket = calloc(max_degree + 2, sizeof(int));
+	for (uint32_t i = 0; i < n; i++)
+		bucket[fine->adj_offsets[i + 1] - fine->adj_offsets[i] + 1]++;
+	for (int d = 0; d <= max_degree; d++)
+		bucket[d + 1] += bucket[d];
+	for (uint32_t i = 0; i < n; i++)
+		order[bucket[fine->adj_offsets[i + 1] - fine->adj_offsets[i]]++] = i;
+	free(bucket);
+
+	for (uint32_t i = 0; i < n; i++) {
+		match[i] = -1;
+		pending[i] = -1;
+	}
+	for (uint32_t k = 0; k < n; k++) {
+		int u = order[k];
+		if (match[u] >= 0)
+			continue;
+		int best = -1;
+		float best_w = -1.0f;
+		for (int e = fine->adj_offsets[u]; e < fine->adj_offsets[u + 1]; e++) {
+			int v = fine->adj_neighbors[e];
+			if (match[v] < 0 && v != u && fine->adj_weights[e] > best_w) {
+				best = v;
+				best_w = fine->adj_weights[e];
+			}
+		}
+		if (best >= 0) {
+			match[u] = best;
+			match[best] = u;
+		}
+	}
+	for (uint32_t k = 0; k < n; k++) {
+		int u = order[k];
+		if (match[u] >= 0 || fine->adj_offsets[u] == fine->adj_offsets[u + 1])
+			continue;
+		int hub = fine->adj_neighbors[fine->adj_offsets[u]];
+		float best_w = fine->adj_weights[fine->adj_offsets[u]];
+		for (int e = fine->adj_offsets[u] + 1; e < fine->adj_offsets[u + 1]; e++) {
+			if (fine->adj_weights[e] > best_w) {
+				hub = fine->adj_neighbors[e];
+				best_w = fine->adj_weights[e];
+			}
+		}
+		if (pending[hub] >= 0) {
+			match[u] = pending[hub];
+			match[pending[hub]] = u;
+			pending[hub] = -1;
+		} else {
+			pending[hub] = u;
+		}
+	}
+	free(pending);
+
+	// Number coarse nodes; a pair takes the id of its lower member
+	int *parent = malloc(sizeof(int) * (n + 1));
+	uint32_t cn = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		if (match[i] < 0 || (uint32_t)match[i] > i)
+			parent[i] = cn++;
+		else
+			parent[i] = parent[match[i]];
+	}
+	if (cn > n - n / 10) {
+		free(order);
+		free(match);
+		free(parent);
+		return false;
+	}
+
+	coarse->node_count = cn;
+	coarse->mass = calloc(cn + 1, sizeof(uint32_t));
+	coarse->positions = calloc(cn + 1, sizeof(vec3));
+	coarse->next_positions = malloc(sizeof(vec3) * (cn + 1));
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t m = level_mass(fine, i);
+		coarse->mass[parent[i]] += m;
+		glm_vec3_muladds(fine->positions[i], (float)m, coarse->positions[parent[i]]);
+	}
+	for (uint32_t c = 0; c < cn; c++)
+		glm_vec3_scale(coarse->positions[c], 1.0f / (float)coarse->mass[c], coarse->positions[c]);
+
+	// Coarse CSR: union of the members' neighbor lists, duplicates merged by summing weights
+	int *members = malloc(sizeof(int) * (2 * cn + 1));
+	for (uint32_t i = 0; i < n; i++) {
+		if (match[i] < 0 || (uint32_t)match[i] > i) {
+			members[2 * parent[i]] = i;
+			members[2 * parent[i] + 1] = match[i];
+		}
+	}
+	int total = fine->adj_offsets[n];
+	coarse->adj_offsets = malloc(sizeof(int) * (cn + 1));
+	coarse->adj_neighbors = malloc(sizeof(int) * (total + 1));
+	coarse->adj_weights = malloc(sizeof(float) * (total + 1));
+	int *row_of = malloc(sizeof(int) * (cn + 1));
+	int *slot_of = malloc(sizeof(int) * (cn + 1));
+	OpenOrdCoarseEdge *row = malloc(sizeof(OpenOrdCoarseEdge) * (cn + 1));
+	for (uint32_t c = 0; c < cn; c++)
+		row_of[c] = -1;
+	int out = 0;
+	for (uint32_t c = 0; c < cn; c++) {
+		int begin = out;
+		coarse->adj_offsets[c] = out;
+		for (int m = 0; m < 2; m++) {
+			int u = members[2 * c + m];
+			if (u < 0)
+				continue;
+			for (int e = fine->adj_offsets[u]; e < fine->adj_offsets[u + 1]; e++) {
+				int pc = parent[fine->adj_neighbors[e]];
+				if ((uint32_t)pc == c)
+					continue;
+				if (row_of[pc] != (int)c) {
+					row_of[pc] = c;
+					slot_of[pc] = out;
+					coarse->adj_neighbors[out] = pc;
+					coarse->adj_weights[out] = 0.0f;
+					out++;
+				}
+				coarse->adj_weights[slot_of[pc]] += fine->adj_weights[e];
+			}
+		}
+
+		// Keep the heaviest neighbors. Rows may lose their symmetry; each node is then pulled
+		// by its own strongest links, and the finer levels restore the full edge set.
+		int degree = out - begin;
+		if (degree > OPENORD_COARSE_MAX_DEGREE) {
+			for (int e = 0; e < degree; e++)
+				row[e] = (OpenOrdCoarseEdge){coarse->adj_neighbors[begin + e], coarse->adj_weights[begin + e]};
+			qsort(row, degree, sizeof(OpenOrdCoarseEdge), compare_coarse_edges);
+			for (int e = 0; e < OPENORD_COARSE_MAX_DEGREE; e++) {
+				coarse->adj_neighbors[begin + e] = row[e].neighbor;
+				coarse->adj_weights[begin + e] = row[e].weight;
+			}
+			out = begin + OPENORD_COARSE_MAX_DEGREE;
+		}
+	}
+	coarse->adj_offsets[cn] = out;
+	free(row);
+	free(row_of);
+	free(slot_of);
+	free(members);
+	free(order);
+	free(match);
+
+	// The fine level keeps the mapping to project positions back down
+	fine->parent = parent;
+	return true;
+}
+
+// Build the level-0 CSR and, for large graphs, the coarsened levels above it
+static void build_hierarchy(OpenOrdContext *ctx, const GraphData *graph)
+{
+	build_input_level(ctx, graph);
+	while (ctx->level_count < OPENORD_MAX_LEVELS && ctx->levels[ctx->level_count - 1].node_count > OPENORD_COARSEST_NODES) {
+		if (!coarsen_level(&ctx->levels[ctx->level_count - 1], &ctx->levels[ctx->level_count]))
+			break;
+		ctx->level_count++;
+	}
+	ctx->level = ctx->level_count - 1;
+}
+
+// Full five-stage schedule for the coarsest level; finer levels only refine the projected
+// layout, so they skip Liquid and Expansion and run a short, cooler Cooldown/Crunch/Simmer
+static void init_schedule(OpenOrdContext *ctx, bool refine)
+{
+	ctx->stage_id = 0;
+	ctx->current_iter = 0;
+	if (!refine) {
+		// Stages setup based on original implementation
+		// Liquid
+		ctx->stages[0] = (OpenOrdStage){200, 2000.0f, 2.0f, 1.0f, 0, 0, 0, 0, 0};
+		// Expansion
+		ctx->stages[1] = (OpenOrdStage){200, 2000.0f, 10.0f, 1.0f, 0, 0, 0, 0, 0};
+		// Cooldown
+		ctx->stages[2] = (OpenOrdStage){200, 2000.0f, 1.0f, 0.1f, 0, 0, 0, 0, 0};
+		// Crunch
+		ctx->stages[3] = (OpenOrdStage){50, 250.0f, 1.0f, 0.25f, 0, 0, 0, 0, 0};
+		// Simmer
+		ctx->stages[4] = (OpenOrdStage){100, 250.0f, 0.5f, 0.0f, 0, 0, 0, 0, 0};
+	} else {
+		// The finest level is the most expensive and starts from a layout already refined on
+		// every coarser level, so it only settles the split pairs
+		bool finest = ctx->level == 0;
+		ctx->stages[0] = (OpenOrdStage){0, 2000.0f, 2.0f, 1.0f, 0, 0, 0, 0, 0};
+		ctx->stages[1] = (OpenOrdStage){0, 2000.0f, 10.0f, 1.0f, 0, 0, 0, 0, 0};
+		ctx->stages[2] = (OpenOrdStage){finest ? 5 : 13, 250.0f, 1.0f, 0.1f, 0, 0, 0, 0, 0};
+		ctx->stages[3] = (OpenOrdStage){finest ? 2 : 5, 250.0f, 1.0f, 0.25f, 0, 0, 0, 0, 0};
+		ctx->stages[4] = (OpenOrdStage){finest ? 3 : 7, 250.0f, 0.5f, 0.0f, 0, 0, 0, 0, 0};
+	}
 
 	// Calculate cut parameters
 	float edge_cut = 0.8f; // Default high cut
@@ -91,6 +372,43 @@ void openord_init(OpenOrdContext *ctx, int node_count, int grid_size)
 	ctx->cut_off_length = cut_length_start;
 	ctx->cut_rate = (cut_length_start - cut_length_end) / 400.0f;
 	ctx->min_edges = 20.0f; // Default start
+}
+
+// Size the density grid for node_count nodes. Automatic grids (grid_size <= 0) grow the view
+// with the cube root of the graph size at the reference cell size, up to GRID_MAX cells per axis.
+static void init_grid(OpenOrdContext *ctx, uint32_t node_count, int grid_size)
+{
+	if (grid_size > 0) {
+		ctx->view_size = VIEW_SIZE;
+	} else {
+		ctx->view_size = VIEW_SIZE * fmaxf(1.0f, cbrtf((float)node_count / VIEW_NODE_REF));
+		grid_size = (int)ceilf(ctx->view_size * (GRID_DIM / VIEW_SIZE));
+	}
+	if (grid_size > GRID_MAX)
+		grid_size = GRID_MAX;
+	ctx->grid_size = (grid_size + BRICK_MASK) & ~BRICK_MASK;
+	ctx->grid_scale = ctx->grid_size / ctx->view_size;
+
+	// The density grid itself is sparse (see rebuild_density); only the brick directory
+	// (one int per 8^3 cells) and the plane index are dense
+	ctx->bricks_per_axis = ctx->grid_size >> BRICK_SHIFT;
+	free(ctx->brick_table);
+	free(ctx->plane_offsets);
+	ctx->brick_table = malloc(sizeof(int) * ctx->bricks_per_axis * ctx->bricks_per_axis * ctx->bricks_per_axis);
+	ctx->plane_offsets = calloc(ctx->grid_size + 1, sizeof(int));
+}
+
+void openord_init(OpenOrdContext *ctx, const GraphData *graph, int grid_size)
+{
+	memset(ctx, 0, sizeof(OpenOrdContext));
+	init_falloff();
+
+	ctx->auto_grid = grid_size <= 0;
+	init_grid(ctx, graph->node_count, grid_size);
+	ctx->radius = (float)RADIUS;
+
+	build_hierarchy(ctx, graph);
+	init_schedule(ctx, false);
 
 	ctx->initialized = true;
 	ctx->num_threads = omp_get_max_threads();
@@ -98,142 +416,367 @@ void openord_init(OpenOrdContext *ctx, int node_count, int grid_size)
 
 void openord_cleanup(OpenOrdContext *ctx)
 {
-	if (ctx->density_grid)
-		free(ctx->density_grid);
+	free(ctx->bricks);
+	free(ctx->brick_table);
+	free(ctx->occupied_cells);
+	free(ctx->plane_offsets);
+	ctx->bricks = NULL;
+	ctx->brick_table = NULL;
+	ctx->occupied_cells = NULL;
+	ctx->plane_offsets = NULL;
+	for (int l = 0; l < ctx->level_count; l++)
+		free_level(&ctx->levels[l]);
+	ctx->level_count = 0;
+	free(ctx->cut_targets);
+	ctx->cut_targets = NULL;
 	ctx->initialized = false;
 }
 
-static inline int get_grid_idx(float x, float y, float z)
+// Cell coordinates of a position, clamped into the grid; returns false if it was outside
+static inline bool grid_cell(const OpenOrdContext *ctx, const vec3 pos, int *gx, int *gy, int *gz)
 {
-	int gx = (int)((x + HALF_VIEW) * VIEW_TO_GRID);
-	int gy = (int)((y + HALF_VIEW) * VIEW_TO_GRID);
-	int gz = (int)((z + HALF_VIEW) * VIEW_TO_GRID);
-
-	if (gx < 0)
-		gx = 0;
-	if (gx >= GRID_DIM)
-		gx = GRID_DIM - 1;
-	if (gy < 0)
-		gy = 0;
-	if (gy >= GRID_DIM)
-		gy = GRID_DIM - 1;
-	if (gz < 0)
-		gz = 0;
-	if (gz >= GRID_DIM)
-		gz = GRID_DIM - 1;
-
-	return gz * GRID_DIM * GRID_DIM + gy * GRID_DIM + gx;
+	float half = ctx->view_size * 0.5f;
+	int c[3];
+	bool inside = true;
+	for (int d = 0; d < 3; d++) {
+		c[d] = (int)floorf((pos[d] + half) * ctx->grid_scale);
+		if (c[d] < 0) {
+			c[d] = 0;
+			inside = false;
+		} else if (c[d] >= ctx->grid_size) {
+			c[d] = ctx->grid_size - 1;
+			inside = false;
+		}
+	}
+	*gx = c[0];
+	*gy = c[1];
+	*gz = c[2];
+	return inside;
 }
 
-static void update_density(OpenOrdContext *ctx, vec3 pos, float sign)
+static inline int brick_key(const OpenOrdContext *ctx, int bx, int by, int bz)
 {
-	int gx = (int)((pos[0] + HALF_VIEW) * VIEW_TO_GRID);
-	int gy = (int)((pos[1] + HALF_VIEW) * VIEW_TO_GRID);
-	int gz = (int)((pos[2] + HALF_VIEW) * VIEW_TO_GRID);
+	return (bz * ctx->bricks_per_axis + by) * ctx->bricks_per_axis + bx;
+}
 
-	for (int k = -RADIUS; k <= RADIUS; k++) {
-		for (int j = -RADIUS; j <= RADIUS; j++) {
-			for (int i = -RADIUS; i <= RADIUS; i++) {
-				int dx = gx + i;
-				int dy = gy + j;
-				int dz = gz + k;
-
-				if (dx >= 0 && dx < GRID_DIM && dy >= 0 && dy < GRID_DIM && dz >= 0 && dz < GRID_DIM) {
-					int idx = dz * GRID_DIM * GRID_DIM + dy * GRID_DIM + dx;
-#pragma omp atomic
-					ctx->density_grid[idx] += sign * fall_off[i + RADIUS][j + RADIUS][k + RADIUS];
+static inline OpenOrdBrick *find_brick(const OpenOrdContext *ctx, int bx, int by, int bz)
+{
+	int slot = ctx->brick_table[brick_key(ctx, bx, by, bz)];
+	return slot < 0 ? NULL : &ctx->bricks[slot];
+}
+
+// Look up a brick, allocating a zeroed one from the pool if missing (sequential phases only)
+static OpenOrdBrick *get_brick(OpenOrdContext *ctx, int bx, int by, int bz)
+{
+	int key = brick_key(ctx, bx, by, bz);
+	if (ctx->brick_table[key] >= 0)
+		return &ctx->bricks[ctx->brick_table[key]];
+
+	if (ctx->brick_count == ctx->brick_capacity) {
+		ctx->brick_capacity = ctx->brick_capacity ? ctx->brick_capacity * 2 : 256;
+		ctx->bricks = realloc(ctx->bricks, sizeof(OpenOrdBrick) * ctx->brick_capacity);
+	}
+	int slot = ctx->brick_count++;
+	OpenOrdBrick *brick = &ctx->bricks[slot];
+	memset(brick, 0, sizeof(OpenOrdBrick));
+	brick->key = key;
+	ctx->brick_table[key] = slot;
+	return brick;
+}
+
+// Rebuild the density grid from scratch: bin nodes per cell, then convolve the occupied
+// cells with the falloff stencil. Storage is a set of 8^3 bricks allocated around occupied
+// cells only, so memory follows the occupied space. Each thread owns whole z-planes of the
+// output, so the stencil is applied without atomics and each stencil row is a SIMD loop.
+static void rebuild_density(OpenOrdContext *ctx, const OpenOrdLevel *level)
+{
+	int n = ctx->grid_size;
+	int nb = ctx->bricks_per_axis;
+
+	// Recycle the pool: every brick is re-created (zeroed) on first touch this step
+	ctx->brick_count = 0;
+	memset(ctx->brick_table, 0xff, sizeof(int) * nb * nb * nb);
+
+	// Coarse nodes weigh as many input nodes as they merge, so every level fills the same space
+	for (uint32_t i = 0; i < level->node_count; i++) {
+		int gx, gy, gz;
+		grid_cell(ctx, level->positions[i], &gx, &gy, &gz);
+		OpenOrdBrick *brick = get_brick(ctx, gx >> BRICK_SHIFT, gy >> BRICK_SHIFT, gz >> BRICK_SHIFT);
+		brick->count[((gz & BRICK_MASK) * BRICK_DIM + (gy & BRICK_MASK)) * BRICK_DIM + (gx & BRICK_MASK)] += level_mass(level, i);
+	}
+
+	// Occupied cells, counting-sorted by z-plane
+	int occupied_bricks = ctx->brick_count;
+	memset(ctx->plane_offsets, 0, sizeof(int) * (n + 1));
+	int occupied = 0;
+	for (int b = 0; b < occupied_bricks; b++) {
+		int bz = ctx->bricks[b].key / (nb * nb);
+		for (int c = 0; c < BRICK_VOL; c++) {
+			if (ctx->bricks[b].count[c]) {
+				ctx->plane_offsets[bz * BRICK_DIM + c / (BRICK_DIM * BRICK_DIM) + 1]++;
+				occupied++;
+			}
+		}
+	}
+	for (int z = 0; z < n; z++)
+		ctx->plane_offsets[z + 1] += ctx->plane_offsets[z];
+	if (occupied > ctx->occupied_capacity) {
+		ctx->occupied_capacity = occupied;
+		ctx->occupied_cells = realloc(ctx->occupied_cells, sizeof(int) * occupied);
+	}
+	int *fill = malloc(sizeof(int) * n);
+	memcpy(fill, ctx->plane_offsets, sizeof(int) * n);
+	for (int b = 0; b < occupied_bricks; b++) {
+		int key = ctx->bricks[b].key;
+		int bx = key % nb, by = (key / nb) % nb, bz = key / (nb * nb);
+		for (int c = 0; c < BRICK_VOL; c++) {
+			if (!ctx->bricks[b].count[c])
+				continue;
+			int z = bz * BRICK_DIM + c / (BRICK_DIM * BRICK_DIM);
+			int y = by * BRICK_DIM + (c / BRICK_DIM) % BRICK_DIM;
+			int x = bx * BRICK_DIM + c % BRICK_DIM;
+			ctx->occupied_cells[fill[z]++] = (z * n + y) * n + x;
+		}
+	}
+	free(fill);
+
+	// Allocate every brick a stencil can reach before the parallel phase (lookups are read-only there)
+	for (int b = 0; b < occupied_bricks; b++) {
+		int key = ctx->bricks[b].key;
+		int bx = key % nb, by = (key / nb) % nb, bz = key / (nb * nb);
+		for (int dz = -BRICK_REACH; dz <= BRICK_REACH; dz++)
+			for (int dy = -BRICK_REACH; dy <= BRICK_REACH; dy++)
+				for (int dx = -BRICK_REACH; dx <= BRICK_REACH; dx++)
+					if (bx + dx >= 0 && bx + dx < nb && by + dy >= 0 && by + dy < nb && bz + dz >= 0 && bz + dz < nb)
+						get_brick(ctx, bx + dx, by + dy, bz + dz);
+	}
+
+	// Each thread accumulates one output plane at a time into a dense scratch plane (contiguous
+	// stencil rows), then copies the slices of allocated bricks out of it
+#pragma omp parallel
+	{
+		float *plane = malloc(sizeof(float) * n * n);
+#pragma omp for schedule(dynamic, 1)
+		for (int z = 0; z < n; z++) {
+			int bz = z >> BRICK_SHIFT;
+			int sz0 = z - RADIUS < 0 ? 0 : z - RADIUS;
+			int sz1 = z + RADIUS >= n ? n - 1 : z + RADIUS;
+			if (ctx->plane_offsets[sz0] == ctx->plane_offsets[sz1 + 1])
+				continue;
+			memset(plane, 0, sizeof(float) * n * n);
+			for (int o = ctx->plane_offsets[sz0]; o < ctx->plane_offsets[sz1 + 1]; o++) {
+				int cell = ctx->occupied_cells[o];
+				int sx = cell % n;
+				int sy = (cell / n) % n;
+				int sz = cell / (n * n);
+				int k = z - sz + RADIUS;
+				OpenOrdBrick *src = find_brick(ctx, sx >> BRICK_SHIFT, sy >> BRICK_SHIFT, sz >> BRICK_SHIFT);
+				float w = (float)src->count[((sz & BRICK_MASK) * BRICK_DIM + (sy & BRICK_MASK)) * BRICK_DIM + (sx & BRICK_MASK)];
+
+				int x0 = sx - RADIUS < 0 ? 0 : sx - RADIUS;
+				int x1 = sx + RADIUS >= n ? n - 1 : sx + RADIUS;
+				for (int y = (sy - RADIUS < 0 ? 0 : sy - RADIUS); y <= sy + RADIUS && y < n; y++) {
+					float *restrict row = plane + y * n;
+					const float *restrict f = &fall_off[k][y - sy + RADIUS][x0 - sx + RADIUS];
+#pragma omp simd
+					for (int x = x0; x <= x1; x++)
+						row[x] += w * f[x - x0];
+				}
+			}
+			int slice = (z & BRICK_MASK) * BRICK_DIM * BRICK_DIM;
+			for (int by = 0; by < nb; by++) {
+				for (int bx = 0; bx < nb; bx++) {
+					OpenOrdBrick *brick = find_brick(ctx, bx, by, bz);
+					if (!brick)
+						continue;
+					for (int y = 0; y < BRICK_DIM; y++)
+						memcpy(brick->density + slice + y * BRICK_DIM, plane + (by * BRICK_DIM + y) * n + bx * BRICK_DIM, sizeof(float) * BRICK_DIM);
 				}
 			}
 		}
+		free(plane);
 	}
 }
 
-static float get_density(OpenOrdContext *ctx, vec3 pos)
+// Density at pos from the frozen grid, excluding the node's own contribution at self_pos
+static float get_density(OpenOrdContext *ctx, vec3 pos, const vec3 self_pos, float self_mass)
 {
-	int gx = (int)((pos[0] + HALF_VIEW) * VIEW_TO_GRID);
-	int gy = (int)((pos[1] + HALF_VIEW) * VIEW_TO_GRID);
-	int gz = (int)((pos[2] + HALF_VIEW) * VIEW_TO_GRID);
-
-	if (gx < 0 || gx >= GRID_DIM || gy < 0 || gy >= GRID_DIM || gz < 0 || gz >= GRID_DIM)
+	int gx, gy, gz;
+	if (!grid_cell(ctx, pos, &gx, &gy, &gz))
 		return 10000.0f;
 
-	int idx = gz * GRID_DIM * GRID_DIM + gy * GRID_DIM + gx;
-	return ctx->density_grid[idx]; // Simplified, originally squared but linear
-								   // is often fine for 3D repulsion
+	// No brick means nothing within stencil reach
+	OpenOrdBrick *brick = find_brick(ctx, gx >> BRICK_SHIFT, gy >> BRICK_SHIFT, gz >> BRICK_SHIFT);
+	if (!brick)
+		return 0.0f;
+	float density = brick->density[((gz & BRICK_MASK) * BRICK_DIM + (gy & BRICK_MASK)) * BRICK_DIM + (gx & BRICK_MASK)];
+	// Simplified, originally squared but linear is often fine for 3D repulsion
+
+	// The node was binned (clamped) at self_pos; remove that stencil sample
+	int sx, sy, sz;
+	grid_cell(ctx, self_pos, &sx, &sy, &sz);
+	int dx = gx - sx, dy = gy - sy, dz = gz - sz;
+	if (abs(dx) <= RADIUS && abs(dy) <= RADIUS && abs(dz) <= RADIUS)
+		density -= self_mass * fall_off[dz + RADIUS][dy + RADIUS][dx + RADIUS];
+	return density;
 }
 
-static float compute_energy(OpenOrdContext *ctx, GraphData *g, int node_idx, vec3 pos)
+// Energy of the node at two candidate positions, in one pass over its neighbors
+static void compute_energies(OpenOrdContext *ctx, const OpenOrdLevel *level, int node_idx, vec3 pos_a, vec3 pos_b, float *energy_a, float *energy_b)
 {
-	float energy = 0.0f;
+	float ea = 0.0f, eb = 0.0f;
 	float attraction = ctx->stages[ctx->stage_id].attraction;
 	float attraction_factor = attraction * attraction * attraction * attraction * 2e-2f; // From original
 
-	igraph_vector_int_t neighbors;
-	igraph_vector_int_init(&neighbors, 0);
-	igraph_neighbors(&g->g, &neighbors, node_idx, IGRAPH_ALL, IGRAPH_NO_LOOPS, 1);
-
-	for (int i = 0; i < igraph_vector_int_size(&neighbors); i++) {
-		int neighbor_idx = VECTOR(neighbors)[i];
-		vec3 diff;
-		glm_vec3_sub(pos, g->nodes[neighbor_idx].position, diff);
-		float dist_sq = glm_vec3_norm2(diff);
-
-		if (ctx->stage_id < 2)
-			dist_sq *= dist_sq; // Higher power for liquid/expansion
-		if (ctx->stage_id == 0)
-			dist_sq *= dist_sq; // Liquid
-
-		// Edge weight is 1.0f for now, can be fetched if exists
-		float weight = g->edges ? g->edges[i].size : 1.0f;
+	for (int i = level->adj_offsets[node_idx]; i < level->adj_offsets[node_idx + 1]; i++) {
+		const float *neighbor = level->positions[level->adj_neighbors[i]];
+		vec3 diff_a, diff_b;
+		glm_vec3_sub(pos_a, (float *)neighbor, diff_a);
+		glm_vec3_sub(pos_b, (float *)neighbor, diff_b);
+		float dist_a = glm_vec3_norm2(diff_a);
+		float dist_b = glm_vec3_norm2(diff_b);
+
+		if (ctx->stage_id < 2) { // Higher power for liquid/expansion
+			dist_a *= dist_a;
+			dist_b *= dist_b;
+		}
+		if (ctx->stage_id == 0) { // Liquid
+			dist_a *= dist_a;
+			dist_b *= dist_b;
+		}
 
-		energy += weight * attraction_factor * dist_sq;
+		float w = level->adj_weights[i] * attraction_factor;
+		ea += w * dist_a;
+		eb += w * dist_b;
 	}
-	igraph_vector_int_destroy(&neighbors);
 
-	energy += get_density(ctx, pos);
-	return energy;
+	float mass = (float)level_mass(level, node_idx);
+	*energy_a = ea + get_density(ctx, pos_a, level->positions[node_idx], mass);
+	*energy_b = eb + get_density(ctx, pos_b, level->positions[node_idx], mass);
 }
 
-static void solve_analytic(OpenOrdContext *ctx, GraphData *g, int node_idx, vec3 out_pos)
+static void solve_analytic(OpenOrdContext *ctx, const OpenOrdLevel *level, int node_idx, vec3 out_pos)
 {
 	vec3 centroid = {0, 0, 0};
 	float total_weight = 0.0f;
 
-	igraph_vector_int_t neighbors;
-	igraph_vector_int_init(&neighbors, 0);
-	igraph_neighbors(&g->g, &neighbors, node_idx, IGRAPH_ALL, IGRAPH_NO_LOOPS, 1);
-
-	for (int i = 0; i < igraph_vector_int_size(&neighbors); i++) {
-		int n_idx = VECTOR(neighbors)[i];
-		float weight = 1.0f; // Simplified
+	for (int i = level->adj_offsets[node_idx]; i < level->adj_offsets[node_idx + 1]; i++) {
+		float weight = level->adj_weights[i];
 		total_weight += weight;
-		glm_vec3_muladds(g->nodes[n_idx].position, weight, centroid);
+		glm_vec3_muladds(level->positions[level->adj_neighbors[i]], weight, centroid);
 	}
-	igraph_vector_int_destroy(&neighbors);
 
 	if (total_weight > 0.0f) {
 		glm_vec3_divs(centroid, total_weight, centroid);
 		float damping = 1.0f - ctx->stages[ctx->stage_id].damping_mult;
-		vec3 current = {g->nodes[node_idx].position[0], g->nodes[node_idx].position[1], g->nodes[node_idx].position[2]};
-		glm_vec3_lerp(centroid, current, damping, out_pos);
+		glm_vec3_lerp(centroid, level->positions[node_idx], damping, out_pos);
 	} else {
-		glm_vec3_copy(g->nodes[node_idx].position, out_pos);
+		glm_vec3_copy(level->positions[node_idx], out_pos);
 	}
 }
 
-bool openord_step(OpenOrdContext *ctx, GraphData *graph)
+// Edge cutting as in the original: once a node has more than min_edges edges, its longest
+// edge (scaled by sqrt(degree)) is cut if it exceeds the current cut length. Returns the
+// neighbor to cut or -1.
+static int find_cut(const OpenOrdContext *ctx, const OpenOrdLevel *level, int node_idx, const vec3 pos)
+{
+	int degree = level->adj_offsets[node_idx + 1] - level->adj_offsets[node_idx];
+	if (ctx->min_edges >= 99.0f || ctx->cut_end >= 39500.0f || (float)degree <= ctx->min_edges)
+		return -1;
+
+	// Compared squared: length^2 * degree against cut_off_length^2
+	float max_length_sq = 0.0f;
+	int target = -1;
+	for (int i = level->adj_offsets[node_idx]; i < level->adj_offsets[node_idx + 1]; i++) {
+		float length_sq = glm_vec3_distance2((float *)pos, level->positions[level->adj_neighbors[i]]);
+		if (length_sq > max_length_sq) {
+			max_length_sq = length_sq;
+			target = level->adj_neighbors[i];
+		}
+	}
+	return max_length_sq * (float)degree > ctx->cut_off_length * ctx->cut_off_length ? target : -1;
+}
+
+// Drop the edges chosen by find_cut from both endpoints' rows. Each node cuts at most one
+// neighbor per iteration, so an edge u-v goes if cut_targets[u] == v or cut_targets[v] == u.
+static void apply_cuts(OpenOrdContext *ctx, OpenOrdLevel *level)
+{
+	const int *cut = ctx->cut_targets;
+	int out = 0;
+	for (uint32_t u = 0; u < level->node_count; u++) {
+		int begin = level->adj_offsets[u];
+		int end = level->adj_offsets[u + 1];
+		level->adj_offsets[u] = out;
+		for (int e = begin; e < end; e++) {
+			int v = level->adj_neighbors[e];
+			if (cut[u] == v || cut[v] == (int)u)
+				continue;
+			level->adj_neighbors[out] = v;
+			level->adj_weights[out] = level->adj_weights[e];
+			out++;
+		}
+	}
+	level->adj_offsets[level->node_count] = out;
+}
+
+// Copy positions of level l + 1 down to level l; with jitter, merged nodes are split apart
+static void project_level(OpenOrdContext *ctx, int l, bool jitter)
+{
+	OpenOrdLevel *fine = &ctx->levels[l];
+	const OpenOrdLevel *coarse = &ctx->levels[l + 1];
+	float spread = jitter ? 1.0f / ctx->grid_scale : 0.0f; // About one density cell
+
+#pragma omp parallel for
+	for (int i = 0; i < (int)fine->node_count; i++) {
+		glm_vec3_copy((float *)coarse->positions[fine->parent[i]], fine->positions[i]);
+		if (jitter) {
+			for (int d = 0; d < 3; d++)
+				fine->positions[i][d] += (graph_rng_float(GRAPH_RNG_STREAM_OPENORD_PROJECT, l, (uint64_t)i * 3 + d) - 0.5f) * spread;
+		}
+	}
+}
+
+void openord_sync(OpenOrdContext *ctx, const GraphData *graph)
+{
+	// Filtering replaces the graph under a live context: the hierarchy and, for automatic
+	// grids, the grid size are derived from the graph size, so rebuild both
+	if (graph->node_count != ctx->input_node_count || graph->edge_count != ctx->input_edge_count) {
+		// Once the coarsest level has finished its full schedule the layout is formed, and the
+		// rebuilt levels (averaged from it) only need refining; otherwise the schedule carries on
+		bool formed = ctx->level < ctx->level_count - 1;
+		if (ctx->auto_grid)
+			init_grid(ctx, graph->node_count, 0);
+		build_hierarchy(ctx, graph);
+		if (formed)
+			init_schedule(ctx, true);
+	}
+
+	// At full resolution the graph's positions are authoritative (other code may move nodes)
+	if (ctx->level == 0) {
+		for (uint32_t i = 0; i < graph->node_count; i++)
+			glm_vec3_copy((float *)graph->nodes[i].position, ctx->levels[0].positions[i]);
+	}
+}
+
+bool openord_iterate(OpenOrdContext *ctx)
 {
 	if (ctx->stage_id >= 5)
 		return false;
 
 	OpenOrdStage *stage = &ctx->stages[ctx->stage_id];
 
-	// Check transitions
-	if (ctx->current_iter >= stage->iterations) {
+	// Check transitions (refinement schedules skip stages with zero iterations)
+	while (ctx->current_iter >= stage->iterations) {
 		ctx->stage_id++;
 		ctx->current_iter = 0;
-		if (ctx->stage_id >= 5)
-			return false;
+		if (ctx->stage_id >= 5) {
+			if (ctx->level == 0)
+				return false;
+			// Level done: split it onto the next finer level and refine there
+			ctx->level--;
+			project_level(ctx, ctx->level, true);
+			init_schedule(ctx, true);
+		}
 		stage = &ctx->stages[ctx->stage_id];
 
 		// Between stage logic (resetting parameters)
@@ -247,45 +790,50 @@ bool openord_step(OpenOrdContext *ctx, GraphData *graph)
 		}
 	}
 
+	OpenOrdLevel *level = &ctx->levels[ctx->level];
+
 	// Update logic
 	float temp = stage->temperature;
 	float jump = 0.01f * temp;
 
-	// Only update nodes if not simmer (simmer just fine tunes)
-
-#pragma omp parallel for schedule(dynamic)
-	for (int i = 0; i < graph->node_count; i++) {
-		// Remove from density (thread safe? No, need atomic or separate pass)
-		// Original code does sequential updates per processor chunk.
-		// We can do approximate density updates or use atomics in density grid
-		// (which we added).
-
-		vec3 old_pos;
-		glm_vec3_copy(graph->nodes[i].position, old_pos);
-		update_density(ctx, old_pos, -1.0f); // Atomic inside
+	// Jacobi update: every node reads the positions and density of the previous
+	// iteration and writes its move to next_positions, so there are no shared writes
+	rebuild_density(ctx, level);
 
+	int cuts = 0;
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : cuts)
+	for (int i = 0; i < (int)level->node_count; i++) {
 		vec3 analytic_pos;
-		solve_analytic(ctx, graph, i, analytic_pos);
+		solve_analytic(ctx, level, i, analytic_pos);
+		ctx->cut_targets[i] = find_cut(ctx, level, i, analytic_pos);
+		cuts += ctx->cut_targets[i] >= 0;
 
 		vec3 random_pos;
-		float r1 = ((float)rand() / RAND_MAX) - 0.5f;
-		float r2 = ((float)rand() / RAND_MAX) - 0.5f;
-		float r3 = ((float)rand() / RAND_MAX) - 0.5f;
+		// Keyed by (iteration, node): independent of thread count and scheduling
+		uint64_t key = (uint64_t)i * 3;
+		float r1 = graph_rng_float(GRAPH_RNG_STREAM_OPENORD, ctx->total_iters, key) - 0.5f;
+		float r2 = graph_rng_float(GRAPH_RNG_STREAM_OPENORD, ctx->total_iters, key + 1) - 0.5f;
+		float r3 = graph_rng_float(GRAPH_RNG_STREAM_OPENORD, ctx->total_iters, key + 2) - 0.5f;
 		random_pos[0] = analytic_pos[0] + r1 * jump;
 		random_pos[1] = analytic_pos[1] + r2 * jump;
 		random_pos[2] = analytic_pos[2] + r3 * jump;
 
-		float e1 = compute_energy(ctx, graph, i, analytic_pos);
-		float e2 = compute_energy(ctx, graph, i, random_pos);
+		float e1, e2;
+		compute_energies(ctx, level, i, analytic_pos, random_pos, &e1, &e2);
 
 		if (e2 < e1) {
-			glm_vec3_copy(random_pos, graph->nodes[i].position);
+			glm_vec3_copy(random_pos, level->next_positions[i]);
 		} else {
-			glm_vec3_copy(analytic_pos, graph->nodes[i].position);
+			glm_vec3_copy(analytic_pos, level->next_positions[i]);
 		}
-
-		update_density(ctx, graph->nodes[i].position, 1.0f); // Atomic inside
 	}
+	vec3 *swap = level->positions;
+	level->positions = level->next_positions;
+	level->next_positions = swap;
+	ctx->node_updates += level->node_count;
+	// The working edge set shrinks; the graph's own edges are untouched
+	if (cuts > 0)
+		apply_cuts(ctx, level);
 
 	// Per-iteration updates
 	if (ctx->stage_id == 1) { // Expansion
@@ -311,6 +859,36 @@ bool openord_step(OpenOrdContext *ctx, GraphData *graph)
 	ctx->current_iter++;
 	ctx->total_iters++;
 
+	return true;
+}
+
+// Coarse levels are shown through their members
+static void project_to_input(OpenOrdContext *ctx)
+{
+	for (int l = ctx->level - 1; l >= 0; l--)
+		project_level(ctx, l, false);
+}
+
+void openord_get_positions(OpenOrdContext *ctx, vec3 *out)
+{
+	project_to_input(ctx);
+	memcpy(out, ctx->levels[0].positions, sizeof(vec3) * ctx->levels[0].node_count);
+}
+
+bool openord_step(OpenOrdContext *ctx, GraphData *graph)
+{
+	if (ctx->stage_id >= 5)
+		return false;
+
+	openord_sync(ctx, graph);
+	if (!openord_iterate(ctx))
+		return false;
+
+	project_to_input(ctx);
+#pragma omp parallel for
+	for (int i = 0; i < (int)graph->node_count; i++)
+		glm_vec3_copy(ctx->levels[0].positions[i], graph->nodes[i].position);
+
 	// Sync to layout matrix for other parts of app
 	for (int i = 0; i < graph->node_count; i++) {
 		MATRIX(graph->current_layout, i, 0) = graph->nodes[i].position[0];
@@ -0,0 +1,281 @@
+#include "graph/layout_pivot_mds.h"
+
+#include <math.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph/graph_rng.h"
+
+bool pivot_mds_adjacency(uint32_t n, const igraph_vector_int_t *edges, int **offsets_out, int **neighbors_out)
+{
+	igraph_integer_t edge_count = igraph_vector_int_size(edges) / 2;
+	int *offsets = calloc(n + 1, sizeof(int));
+	if (!offsets)
+		return false;
+	for (igraph_integer_t e = 0; e < edge_count; e++) {
+		int a = (int)VECTOR(*edges)[2 * e], b = (int)VECTOR(*edges)[2 * e + 1];
+		if (a == b)
+			continue;
+		offsets[a + 1]++;
+		offsets[b + 1]++;
+	}
+	for (uint32_t i = 0; i < n; i++)
+		offsets[i + 1] += offsets[i];
+
+	int *neighbors = malloc(sizeof(int) * (offsets[n] + 1));
+	int *fill = malloc(sizeof(int) * (n + 1));
+	if (!neighbors || !fill) {
+		free(offsets);
+		free(neighbors);
+		free(fill);
+		return false;
+	}
+	memcpy(fill, offsets, sizeof(int) * (n + 1));
+	for (igraph_integer_t e = 0; e < edge_count; e++) {
+		int a = (int)VECTOR(*edges)[2 * e], b = (int)VECTOR(*edges)[2 * e + 1];
+		if (a == b)
+			continue;
+		neighbors[fill[a]++] = b;
+		neighbors[fill[b]++] = a;
+	}
+	free(fill);
+	*offsets_out = offsets;
+	*neighbors_out = neighbors;
+	return true;
+}
+
+void pivot_mds_choose_pivots(uint32_t n, int k, int *pivots)
+{
+	unsigned char *taken = calloc(n, 1);
+	int count = 0;
+	for (uint64_t attempt = 0; count < k; attempt++) {
+		uint32_t v = (uint32_t)(graph_rng_u64(GRAPH_RNG_STREAM_PIVOT_MDS, attempt, 0) % n);
+		if (taken[v])
+			continue;
+		taken[v] = 1;
+		pivots[count++] = (int)v;
+	}
+	free(taken);
+}
+
+// Hop distances from source into dist (one float per node); unreachable nodes end up one hop
+// beyond the farthest reachable one
+static void bfs(uint32_t n, const int *offsets, const int *neighbors, int source, float *dist, int *queue)
+{
+	for (uint32_t i = 0; i < n; i++)
+		dist[i] = -1.0f;
+	int head = 0, tail = 0;
+	dist[source] = 0.0f;
+	queue[tail++] = source;
+	while (head < tail) {
+		int v = queue[head++];
+		float d = dist[v] + 1.0f;
+		for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+			int w = neighbors[e];
+			if (dist[w] < 0.0f) {
+				dist[w] = d;
+				queue[tail++] = w;
+			}
+		}
+	}
+	float unreachable = dist[queue[tail - 1]] + 1.0f;
+	for (uint32_t i = 0; i < n; i++) {
+		if (dist[i] < 0.0f)
+			dist[i] = unreachable;
+	}
+}
+
+void pivot_mds_top_eigenvectors(const double *b, int k, double *vectors, double *values)
+{
+	double *next = malloc(sizeof(double) * 3 * k);
+	for (int d = 0; d < 3; d++) {
+		for (int p = 0; p < k; p++)
+			vectors[d * k + p] = graph_rng_float(GRAPH_RNG_STREAM_PIVOT_MDS, (uint64_t)p, (uint64_t)d + 1) - 0.5;
+	}
+
+	for (int it = 0; it < PIVOT_MDS_EIGEN_ITERATIONS; it++) {
+		for (int d = 0; d < 3; d++) {
+			for (int p = 0; p < k; p++) {
+				double sum = 0.0;
+				for (int q = 0; q < k; q++)
+					sum += b[p * k + q] * vectors[d * k + q];
+				next[d * k + p] = sum;
+			}
+		}
+		// Gram-Schmidt keeps the three vectors spanning distinct eigenspaces. It runs twice: with
+		// a dominant eigenvalue many orders above the rest, one pass leaves enough of it in the
+		// small residuals to swamp them after normalization.
+		for (int d = 0; d < 3; d++) {
+			double *v = next + d * k;
+			for (int pass = 0; pass < 2; pass++) {
+				for (int e = 0; e < d; e++) {
+					const double *u = next + e * k;
+					double dot = 0.0;
+					for (int p = 0; p < k; p++)
+						dot += v[p] * u[p];
+					for (int p = 0; p < k; p++)
+						v[p] -= dot * u[p];
+				}
+			}
+			double norm = 0.0;
+			for (int p = 0; p < k; p++)
+				norm += v[p] * v[p];
+			norm = sqrt(norm);
+			for (int p = 0; p < k; p++)
+				v[p] = norm > 1e-12 ? v[p] / norm : 0.0;
+		}
+		memcpy(vectors, next, sizeof(double) * 3 * k);
+	}
+
+	// Rayleigh quotients, consistent with |C v|^2
+	for (int d = 0; d < 3; d++) {
+		const double *v = vectors + d * k;
+		double quotient = 0.0;
+		for (int p = 0; p < k; p++) {
+			double sum = 0.0;
+			for (int q = 0; q < k; q++)
+				sum += b[p * k + q] * v[q];
+			quotient += v[p] * sum;
+		}
+		values[d] = quotient > 0.0 ? quotient : 0.0;
+	}
+	free(next);
+}
+
+void pivot_mds_distances(uint32_t n, const int *offsets, const int *neighbors, const int *pivots, int k, float *distances)
+{
+#pragma omp parallel
+	{
+		int *queue = malloc(sizeof(int) * n);
+#pragma omp for schedule(dynamic, 1)
+		for (int p = 0; p < k; p++)
+			bfs(n, offsets, neighbors, pivots[p], distances + (size_t)p * n, queue);
+		free(queue);
+	}
+}
+
+bool pivot_mds_project(uint32_t n, int k, const float *distances, float *x, float *y, float *z)
+{
+	// Column p of c holds the double-centered squared distances from pivot p
+	float *c = malloc(sizeof(float) * (size_t)n * k);
+	double *row_mean = calloc(n, sizeof(double));
+	double *col_mean = calloc(k, sizeof(double));
+	double *b = malloc(sizeof(double) * k * k);
+	double *vectors = malloc(sizeof(double) * 3 * k);
+	bool ok = c && row_mean && col_mean && b && vectors;
+	if (ok) {
+		// Double centering of the squared distances: -1/2 (d^2 - row mean - column mean + total mean)
+		double total = 0.0;
+#pragma omp parallel for reduction(+ : total)
+		for (int p = 0; p < k; p++) {
+			const float *dist = distances + (size_t)p * n;
+			float *col = c + (size_t)p * n;
+			double sum = 0.0;
+			for (uint32_t i = 0; i < n; i++) {
+				col[i] = dist[i] * dist[i];
+				sum += col[i];
+			}
+			col_mean[p] = sum / n;
+			total += sum;
+		}
+		total /= (double)n * k;
+#pragma omp parallel for
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			double sum = 0.0;
+			for (int p = 0; p < k; p++)
+				sum += c[(size_t)p * n + i];
+			row_mean[i] = sum / k;
+		}
+#pragma omp parallel for
+		for (int p = 0; p < k; p++) {
+			float *col = c + (size_t)p * n;
+			for (uint32_t i = 0; i < n; i++)
+				col[i] = (float)(-0.5 * (col[i] - row_mean[i] - col_mean[p] + total));
+		}
+
+		// C^T C, k x k
+#pragma omp parallel for schedule(dynamic, 1)
+		for (int p = 0; p < k; p++) {
+			const float *cp = c + (size_t)p * n;
+			for (int q = p; q < k; q++) {
+				const float *cq = c + (size_t)q * n;
+				double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+				for (uint32_t i = 0; i < n; i++)
+					sum += (double)cp[i] * cq[i];
+				b[p * k + q] = sum;
+				b[q * k + p] = sum;
+			}
+		}
+
+		// With pivot rows of the full eigenvectors near sqrt(k/n)-scaled orthonormal, an eigenvalue
+		// mu of C^T C is (k/n) lambda^2 and C v = sqrt(k/n) lambda u. Rescale to the classical MDS
+		// coordinates sqrt(lambda) u, so distances come out in hops.
+		double values[3];
+		pivot_mds_top_eigenvectors(b, k, vectors, values);
+		double scale[3];
+		for (int d = 0; d < 3; d++)
+			scale[d] = values[d] > 1e-12 ? pow((double)n / k / values[d], 0.25) : 0.0;
+
+#pragma omp parallel for
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			double sum[3] = {0.0, 0.0, 0.0};
+			for (int p = 0; p < k; p++) {
+				double v = c[(size_t)p * n + i];
+				sum[0] += v * vectors[p];
+				sum[1] += v * vectors[k + p];
+				sum[2] += v * vectors[2 * k + p];
+			}
+			x[i] = (float)(sum[0] * scale[0]);
+			y[i] = (float)(sum[1] * scale[1]);
+			z[i] = (float)(sum[2] * scale[2]);
+		}
+	}
+
+	free(c);
+	free(row_mean);
+	free(col_mean);
+	free(b);
+	free(vectors);
+	return ok;
+}
+
+bool pivot_mds_layout(uint32_t node_count, const igraph_vector_int_t *edges, int pivot_count, igraph_matrix_t *layout)
+{
+	uint32_t n = node_count;
+	if (igraph_matrix_resize(layout, n, 3) != IGRAPH_SUCCESS)
+		return false;
+	igraph_matrix_null(layout);
+	int k = pivot_count < (int)n ? pivot_count : (int)n;
+	if (k < 2)
+		return true;
+
+	int *offsets = NULL, *neighbors = NULL;
+	if (!pivot_mds_adjacency(n, edges, &offsets, &neighbors))
+		return false;
+
+	int *pivots = malloc(sizeof(int) * k);
+	float *distances = malloc(sizeof(float) * (size_t)n * k);
+	float *coords = malloc(sizeof(float) * 3 * (size_t)n);
+	bool ok = pivots && distances && coords;
+	if (ok) {
+		pivot_mds_choose_pivots(n, k, pivots);
+		pivot_mds_distances(n, offsets, neighbors, pivots, k, distances);
+		ok = pivot_mds_project(n, k, distances, coords, coords + n, coords + 2 * (size_t)n);
+	}
+	if (ok) {
+		for (uint32_t i = 0; i < n; i++) {
+			MATRIX(*layout, i, 0) = coords[i];
+			MATRIX(*layout, i, 1) = coords[n + i];
+			MATRIX(*layout, i, 2) = coords[2 * (size_t)n + i];
+		}
+	}
+
+	free(offsets);
+	free(neighbors);
+	free(pivots);
+	free(distances);
+	free(coords);
+	return ok;
+}
@@ -0,0 +1,57 @@
+#include "graph/layout_scheduler.h"
+#include <time.h>
+
+void layout_scheduler_init(LayoutScheduler *s, float budget_ms)
+{
+	s->budget_ms = budget_ms > 0.0f ? budget_ms : LAYOUT_FRAME_BUDGET_MS;
+	layout_scheduler_reset(s);
+}
+
+void layout_scheduler_reset(LayoutScheduler *s)
+{
+	s->iteration_ms = 0.0f;
+	s->samples = 0;
+	s->iterations_per_frame = 0;
+	s->mode = LAYOUT_SCHEDULE_INLINE;
+}
+
+int layout_scheduler_plan(LayoutScheduler *s)
+{
+	// The first iterations pay one-off costs (allocation, first touch), so a few samples are
+	// needed before giving up on inline unless the overrun is clear
+	if (s->iteration_ms > s->budget_ms && (s->samples >= 3 || s->iteration_ms > 4.0f * s->budget_ms))
+		s->mode = LAYOUT_SCHEDULE_BACKGROUND;
+	if (s->mode == LAYOUT_SCHEDULE_BACKGROUND) {
+		s->iterations_per_frame = 0;
+		return 0;
+	}
+
+	// Probe with a single iteration until there is a measurement
+	int n = 1;
+	if (s->iteration_ms > 0.0f)
+		n = (int)(s->budget_ms / s->iteration_ms);
+	if (n < 1)
+		n = 1;
+	if (n > LAYOUT_MAX_ITERATIONS_PER_FRAME)
+		n = LAYOUT_MAX_ITERATIONS_PER_FRAME;
+	s->iterations_per_frame = n;
+	return n;
+}
+
+void layout_scheduler_record(LayoutScheduler *s, int iterations, double elapsed_ms)
+{
+	if (iterations <= 0)
+		return;
+	float cost = (float)(elapsed_ms / iterations);
+	// Smoothed so a single slow frame doesn't flip the mode; multilevel OpenOrd gets more
+	// expensive as it refines, which the average follows within a few frames
+	s->iteration_ms = s->iteration_ms > 0.0f ? 0.7f * s->iteration_ms + 0.3f * cost : cost;
+	s->samples++;
+}
+
+double layout_scheduler_now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e3 + ts.tv_nsec * 1e-6;
+}
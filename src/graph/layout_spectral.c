@@ -0,0 +1,465 @@
+#include "graph/layout_spectral.h"
+
+#include <math.h>
+#include <omp.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph/graph_rng.h"
+#include "graph/layout_pivot_mds.h"
+
+// Nodes a thread gathers before appending them to the shared next BFS frontier
+#define BFS_CHUNK 1024
+
+static void append_frontier(int *next, int *next_size, const int *local, int count)
+{
+	int at;
+#pragma omp atomic capture
+	{
+		at = *next_size;
+		*next_size += count;
+	}
+	memcpy(next + at, local, sizeof(int) * count);
+}
+
+// Level-synchronous BFS from source: threads claim the nodes of the next level with a
+// compare-and-swap, so each is queued once. Leaves hop counts in dist (-1 where unreachable)
+// and returns the eccentricity of source.
+static int parallel_bfs(uint32_t n, const int *offsets, const int *neighbors, int source, atomic_int *dist, int *frontier, int *next)
+{
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)n; i++)
+		atomic_store_explicit(&dist[i], -1, memory_order_relaxed);
+	atomic_store_explicit(&dist[source], 0, memory_order_relaxed);
+	frontier[0] = source;
+	int size = 1, level = 0;
+	while (size > 0) {
+		int next_size = 0;
+#pragma omp parallel
+		{
+			int local[BFS_CHUNK];
+			int count = 0;
+#pragma omp for schedule(dynamic, 64)
+			for (int f = 0; f < size; f++) {
+				int v = frontier[f];
+				for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+					int w = neighbors[e];
+					int unvisited = -1;
+					if (atomic_load_explicit(&dist[w], memory_order_relaxed) >= 0 || !atomic_compare_exchange_strong_explicit(&dist[w], &unvisited, level + 1, memory_order_relaxed, memory_order_relaxed))
+						continue;
+					local[count++] = w;
+					if (count == BFS_CHUNK) {
+						append_frontier(next, &next_size, local, count);
+						count = 0;
+					}
+				}
+			}
+			append_frontier(next, &next_size, local, count);
+		}
+		int *tmp = frontier;
+		frontier = next;
+		next = tmp;
+		size = next_size;
+		level++;
+	}
+	return level - 1;
+}
+
+// Center coords (three arrays of n) and scale them to a mean edge length of one
+static void normalize_layout(uint32_t n, const int *offsets, const int *neighbors, float *coords)
+{
+	float *x = coords, *y = coords + n, *z = coords + 2 * (size_t)n;
+	double length = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+#pragma omp parallel for reduction(+ : length, cx, cy, cz)
+	for (int64_t i = 0; i < (int64_t)n; i++) {
+		cx += x[i];
+		cy += y[i];
+		cz += z[i];
+		for (int e = offsets[i]; e < offsets[i + 1]; e++) {
+			int j = neighbors[e];
+			length += sqrtf((x[i] - x[j]) * (x[i] - x[j]) + (y[i] - y[j]) * (y[i] - y[j]) + (z[i] - z[j]) * (z[i] - z[j]));
+		}
+	}
+	// Both directions of every edge were summed, matching offsets[n]
+	float scale = length > 1e-12 ? (float)(offsets[n] / length) : 1.0f;
+	float mx = (float)(cx / n), my = (float)(cy / n), mz = (float)(cz / n);
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)n; i++) {
+		x[i] = (x[i] - mx) * scale;
+		y[i] = (y[i] - my) * scale;
+		z[i] = (z[i] - mz) * scale;
+	}
+}
+
+static void write_layout(uint32_t n, const float *coords, igraph_matrix_t *layout)
+{
+	for (uint32_t i = 0; i < n; i++) {
+		MATRIX(*layout, i, 0) = coords[i];
+		MATRIX(*layout, i, 1) = coords[n + i];
+		MATRIX(*layout, i, 2) = coords[2 * (size_t)n + i];
+	}
+}
+
+bool spectral_hde_layout(uint32_t node_count, const igraph_vector_int_t *edges, int pivot_count, igraph_matrix_t *layout)
+{
+	uint32_t n = node_count;
+	if (igraph_matrix_resize(layout, n, 3) != IGRAPH_SUCCESS)
+		return false;
+	igraph_matrix_null(layout);
+	int k = pivot_count < (int)n ? pivot_count : (int)n;
+	if (k < 2)
+		return true;
+
+	int *offsets = NULL, *neighbors = NULL;
+	if (!pivot_mds_adjacency(n, edges, &offsets, &neighbors))
+		return false;
+
+	// Column p holds every node's centered hop distance to pivot p
+	float *columns = malloc(sizeof(float) * (size_t)n * k);
+	atomic_int *dist = malloc(sizeof(atomic_int) * n);
+	int *frontier = malloc(sizeof(int) * n);
+	int *next = malloc(sizeof(int) * n);
+	int *nearest = malloc(sizeof(int) * n); // Hops to the closest pivot so far
+	double *b = malloc(sizeof(double) * k * k);
+	double *vectors = malloc(sizeof(double) * 3 * k);
+	float *coords = malloc(sizeof(float) * 3 * (size_t)n);
+	bool ok = columns && dist && frontier && next && nearest && b && vectors && coords;
+	if (ok) {
+		int pivot = (int)(graph_rng_u64(GRAPH_RNG_STREAM_SPECTRAL, 0, 0) % n);
+		for (int p = 0; p < k; p++) {
+			int unreachable = parallel_bfs(n, offsets, neighbors, pivot, dist, frontier, next) + 1;
+			float *col = columns + (size_t)p * n;
+			double sum = 0.0;
+			int far = -1, far_node = 0;
+#pragma omp parallel
+			{
+				int local_far = -1, local_node = 0;
+#pragma omp for reduction(+ : sum)
+				for (int64_t i = 0; i < (int64_t)n; i++) {
+					int d = atomic_load_explicit(&dist[i], memory_order_relaxed);
+					if (d < 0)
+						d = unreachable;
+					col[i] = (float)d;
+					sum += d;
+					if (p == 0 || d < nearest[i])
+						nearest[i] = d;
+					if (nearest[i] > local_far) {
+						local_far = nearest[i];
+						local_node = (int)i;
+					}
+				}
+#pragma omp critical
+				if (local_far > far || (local_far == far && local_node < far_node)) {
+					far = local_far;
+					far_node = local_node;
+				}
+			}
+			float mean = (float)(sum / n);
+#pragma omp parallel for
+			for (int64_t i = 0; i < (int64_t)n; i++)
+				col[i] -= mean;
+			// Farthest-first: the next pivot is the node farthest from all pivots so far
+			pivot = far_node;
+		}
+
+		// PCA: covariance of the pivot dimensions (up to 1/n), pivots x pivots
+#pragma omp parallel for schedule(dynamic, 1)
+		for (int p = 0; p < k; p++) {
+			const float *cp = columns + (size_t)p * n;
+			for (int q = p; q < k; q++) {
+				const float *cq = columns + (size_t)q * n;
+				double sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+				for (uint32_t i = 0; i < n; i++)
+					sum += (double)cp[i] * cq[i];
+				b[p * k + q] = sum;
+				b[q * k + p] = sum;
+			}
+		}
+		double values[3];
+		pivot_mds_top_eigenvectors(b, k, vectors, values);
+
+#pragma omp parallel for
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			double sum[3] = {0.0, 0.0, 0.0};
+			for (int p = 0; p < k; p++) {
+				double v = columns[(size_t)p * n + i];
+				sum[0] += v * vectors[p];
+				sum[1] += v * vectors[k + p];
+				sum[2] += v * vectors[2 * k + p];
+			}
+			coords[i] = (float)sum[0];
+			coords[n + i] = (float)sum[1];
+			coords[2 * (size_t)n + i] = (float)sum[2];
+		}
+		normalize_layout(n, offsets, neighbors, coords);
+		write_layout(n, coords, layout);
+	}
+
+	free(offsets);
+	free(neighbors);
+	free(columns);
+	free(dist);
+	free(frontier);
+	free(next);
+	free(nearest);
+	free(b);
+	free(vectors);
+	free(coords);
+	return ok;
+}
+
+// y = (x + D^-1/2 A D^-1/2 x) / 2. The shift maps the spectrum into [0, 1], so the smooth
+// eigenvectors are the largest and bipartite structure (eigenvalues near -1) doesn't compete.
+static void apply_operator(uint32_t n, const int *offsets, const int *neighbors, const double *inv_sqrt_degree, const double *x, double *scaled, double *y)
+{
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)n; i++)
+		scaled[i] = inv_sqrt_degree[i] * x[i];
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int64_t i = 0; i < (int64_t)n; i++) {
+		double sum = 0.0;
+		for (int e = offsets[i]; e < offsets[i + 1]; e++)
+			sum += scaled[neighbors[e]];
+		y[i] = 0.5 * (x[i] + inv_sqrt_degree[i] * sum);
+	}
+}
+
+// Remove from w the trivial eigenvector (square roots of the degrees) of every component.
+// Their supports are disjoint, so one pass gathers all coefficients.
+static void deflate(uint32_t n, const int *component, int component_count, const double *sqrt_degree, const double *component_norm, double *coef, double *w)
+{
+	memset(coef, 0, sizeof(double) * component_count);
+	for (uint32_t i = 0; i < n; i++)
+		coef[component[i]] += w[i] * sqrt_degree[i];
+	for (int c = 0; c < component_count; c++)
+		coef[c] = component_norm[c] > 0.0 ? coef[c] / component_norm[c] : 0.0;
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)n; i++)
+		w[i] -= coef[component[i]] * sqrt_degree[i];
+}
+
+// Eigen-decomposition of the symmetric m x m matrix a (row-major, destroyed: its diagonal ends
+// up holding the eigenvalues) by cyclic Jacobi rotations; eigenvectors go to the columns of v
+static void jacobi_eigen(double *a, int m, double *v)
+{
+	for (int p = 0; p < m; p++) {
+		for (int q = 0; q < m; q++)
+			v[p * m + q] = p == q ? 1.0 : 0.0;
+	}
+	for (int sweep = 0; sweep < 64; sweep++) {
+		double off = 0.0;
+		for (int p = 0; p < m; p++) {
+			for (int q = p + 1; q < m; q++)
+				off += a[p * m + q] * a[p * m + q];
+		}
+		if (off < 1e-24)
+			break;
+		for (int p = 0; p < m; p++) {
+			for (int q = p + 1; q < m; q++) {
+				double apq = a[p * m + q];
+				if (fabs(apq) < 1e-300)
+					continue;
+				double theta = (a[q * m + q] - a[p * m + p]) / (2.0 * apq);
+				double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+				double c = 1.0 / sqrt(t * t + 1.0), s = t * c;
+				for (int r = 0; r < m; r++) {
+					double arp = a[r * m + p], arq = a[r * m + q];
+					a[r * m + p] = c * arp - s * arq;
+					a[r * m + q] = s * arp + c * arq;
+				}
+				for (int r = 0; r < m; r++) {
+					double apr = a[p * m + r], aqr = a[q * m + r];
+					a[p * m + r] = c * apr - s * aqr;
+					a[q * m + r] = s * apr + c * aqr;
+				}
+				for (int r = 0; r < m; r++) {
+					double vrp = v[r * m + p], vrq = v[r * m + q];
+					v[r * m + p] = c * vrp - s * vrq;
+					v[r * m + q] = s * vrp + c * vrq;
+				}
+			}
+		}
+	}
+}
+
+static double dot(uint32_t n, const double *a, const double *b)
+{
+	double sum = 0.0;
+#pragma omp parallel for reduction(+ : sum)
+	for (int64_t i = 0; i < (int64_t)n; i++)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+bool spectral_laplacian_layout(uint32_t node_count, const igraph_vector_int_t *edges, igraph_matrix_t *layout)
+{
+	uint32_t n = node_count;
+	if (igraph_matrix_resize(layout, n, 3) != IGRAPH_SUCCESS)
+		return false;
+	igraph_matrix_null(layout);
+	int steps = SPECTRAL_LANCZOS_STEPS < (int)n - 1 ? SPECTRAL_LANCZOS_STEPS : (int)n - 1;
+	if (steps < 4)
+		return true;
+	int keep = SPECTRAL_LANCZOS_KEEP < steps - 1 ? SPECTRAL_LANCZOS_KEEP : steps - 1;
+
+	int *offsets = NULL, *neighbors = NULL;
+	if (!pivot_mds_adjacency(n, edges, &offsets, &neighbors))
+		return false;
+
+	int *component = malloc(sizeof(int) * n);
+	int *queue = malloc(sizeof(int) * n);
+	double *sqrt_degree = malloc(sizeof(double) * n);
+	double *inv_sqrt_degree = malloc(sizeof(double) * n);
+	double *component_norm = calloc(n, sizeof(double));
+	double *coef = malloc(sizeof(double) * n);
+	double *q = malloc(sizeof(double) * n);
+	double *w = malloc(sizeof(double) * n);
+	double *scaled = malloc(sizeof(double) * n);
+	float *basis = malloc(sizeof(float) * (size_t)n * steps); // Krylov basis, one row per vector
+	double *h = calloc((size_t)steps * steps, sizeof(double)); // Projection of the operator onto the basis
+	double *ritz = malloc(sizeof(double) * steps * steps);
+	double *vectors = malloc(sizeof(double) * steps * steps);
+	int *order = malloc(sizeof(int) * steps);
+	float *coords = calloc(3 * (size_t)n, sizeof(float));
+	bool ok = component && queue && sqrt_degree && inv_sqrt_degree && component_norm && coef && q && w && scaled && basis && h && ritz && vectors && order && coords;
+	if (ok) {
+#pragma omp parallel for
+		for (int64_t i = 0; i < (int64_t)n; i++) {
+			int degree = offsets[i + 1] - offsets[i];
+			sqrt_degree[i] = sqrt((double)degree);
+			inv_sqrt_degree[i] = degree > 0 ? 1.0 / sqrt_degree[i] : 0.0;
+			component[i] = -1;
+		}
+		int component_count = 0;
+		for (uint32_t s = 0; s < n; s++) {
+			if (component[s] >= 0)
+				continue;
+			int head = 0, tail = 0;
+			component[s] = component_count;
+			queue[tail++] = (int)s;
+			while (head < tail) {
+				int v = queue[head++];
+				component_norm[component_count] += offsets[v + 1] - offsets[v];
+				for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+					if (component[neighbors[e]] < 0) {
+						component[neighbors[e]] = component_count;
+						queue[tail++] = neighbors[e];
+					}
+				}
+			}
+			component_count++;
+		}
+
+		// Seeded random start, orthogonal to the trivial vectors
+		for (uint32_t i = 0; i < n; i++)
+			w[i] = graph_rng_float(GRAPH_RNG_STREAM_SPECTRAL, 1, i) - 0.5;
+		deflate(n, component, component_count, sqrt_degree, component_norm, coef, w);
+		double norm = sqrt(dot(n, w, w));
+
+		// Thick-restart Lanczos: grow the basis to steps vectors, then keep the best Ritz vectors
+		// and continue from the residual. Mesh-like graphs have tightly clustered eigenvalues
+		// that a single short run can't separate.
+		int count = 0, restarts = 0;
+		while (norm > 1e-9) {
+			int j = count++;
+#pragma omp parallel for
+			for (int64_t i = 0; i < (int64_t)n; i++) {
+				q[i] = w[i] / norm;
+				basis[(size_t)j * n + i] = (float)q[i];
+			}
+			apply_operator(n, offsets, neighbors, inv_sqrt_degree, q, scaled, w);
+			// Full reorthogonalization; its coefficients are the new column of h (tridiagonal in
+			// plain Lanczos steps, an arrowhead right after a restart)
+			for (int r = 0; r <= j; r++) {
+				const float *br = basis + (size_t)r * n;
+				double c = 0.0;
+#pragma omp parallel for reduction(+ : c)
+				for (int64_t i = 0; i < (int64_t)n; i++)
+					c += w[i] * br[i];
+#pragma omp parallel for
+				for (int64_t i = 0; i < (int64_t)n; i++)
+					w[i] -= c * br[i];
+				h[r * steps + j] = h[j * steps + r] = c;
+			}
+			deflate(n, component, component_count, sqrt_degree, component_norm, coef, w);
+			norm = sqrt(dot(n, w, w));
+			if (count < steps && norm > 1e-9)
+				continue;
+
+			// Rayleigh-Ritz on the basis, eigenvalues sorted largest first
+			for (int r = 0; r < count; r++) {
+				for (int c = 0; c < count; c++)
+					ritz[r * count + c] = h[r * steps + c];
+				order[r] = r;
+			}
+			jacobi_eigen(ritz, count, vectors);
+			for (int a = 0; a < count; a++) {
+				for (int b = a + 1; b < count; b++) {
+					if (ritz[order[b] * count + order[b]] > ritz[order[a] * count + order[a]]) {
+						int tmp = order[a];
+						order[a] = order[b];
+						order[b] = tmp;
+					}
+				}
+			}
+			if (norm <= 1e-9 || restarts == SPECTRAL_LANCZOS_RESTARTS)
+				break;
+			restarts++;
+
+			// The kept Ritz vectors replace the basis (per node, in place); the residual w is
+			// orthogonal to all of them and continues the run
+#pragma omp parallel for
+			for (int64_t i = 0; i < (int64_t)n; i++) {
+				float column[SPECTRAL_LANCZOS_STEPS];
+				for (int r = 0; r < count; r++)
+					column[r] = basis[(size_t)r * n + i];
+				for (int c = 0; c < keep; c++) {
+					double sum = 0.0;
+					for (int r = 0; r < count; r++)
+						sum += column[r] * vectors[r * count + order[c]];
+					basis[(size_t)c * n + i] = (float)sum;
+				}
+			}
+			memset(h, 0, sizeof(double) * steps * steps);
+			for (int c = 0; c < keep; c++)
+				h[c * steps + c] = ritz[order[c] * count + order[c]];
+			count = keep;
+		}
+
+		// Degree-normalized Ritz vectors of the three largest eigenvalues
+		if (count > 0) {
+#pragma omp parallel for
+			for (int64_t i = 0; i < (int64_t)n; i++) {
+				for (int d = 0; d < 3 && d < count; d++) {
+					double sum = 0.0;
+					for (int r = 0; r < count; r++)
+						sum += basis[(size_t)r * n + i] * vectors[r * count + order[d]];
+					coords[(size_t)d * n + i] = (float)(sum * inv_sqrt_degree[i]);
+				}
+			}
+			normalize_layout(n, offsets, neighbors, coords);
+		}
+		write_layout(n, coords, layout);
+	}
+
+	free(offsets);
+	free(neighbors);
+	free(component);
+	free(queue);
+	free(sqrt_degree);
+	free(inv_sqrt_degree);
+	free(component_norm);
+	free(coef);
+	free(q);
+	free(w);
+	free(scaled);
+	free(basis);
+	free(h);
+	free(ritz);
+	free(vectors);
+	free(order);
+	free(coords);
+	return ok;
+}
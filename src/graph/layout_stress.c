@@ -0,0 +1,220 @@
+#include "graph/layout_stress.h"
+
+#include <math.h>
+#include <omp.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "graph/layout_pivot_mds.h"
+
+static void free_state(StressContext *ctx)
+{
+	free(ctx->x);
+	free(ctx->y);
+	free(ctx->z);
+	free(ctx->next_x);
+	free(ctx->next_y);
+	free(ctx->next_z);
+	free(ctx->adj_offsets);
+	free(ctx->adj_neighbors);
+	free(ctx->pivots);
+	free(ctx->pivot_dist);
+	free(ctx->pivot_weight);
+}
+
+// Pivot term weights s / d^2, where s counts the nodes of the pivot's region (the nodes closer
+// to it than to any other pivot) that are at most d / 2 from it. Takes distances pivot-major
+// and stores distances and weights node-major for the sweeps.
+static bool init_pivot_terms(StressContext *ctx, const float *distances)
+{
+	uint32_t n = ctx->node_count;
+	int k = ctx->pivot_count;
+	int *region = malloc(sizeof(int) * n);
+	int *region_max = calloc(k, sizeof(int));
+	int *hist_offsets = malloc(sizeof(int) * (k + 1));
+	if (!region || !region_max || !hist_offsets) {
+		free(region);
+		free(region_max);
+		free(hist_offsets);
+		return false;
+	}
+
+	for (uint32_t i = 0; i < n; i++) {
+		int best = 0;
+		for (int p = 1; p < k; p++) {
+			if (distances[(size_t)p * n + i] < distances[(size_t)best * n + i])
+				best = p;
+		}
+		region[i] = best;
+		int d = (int)distances[(size_t)best * n + i];
+		if (d > region_max[best])
+			region_max[best] = d;
+	}
+
+	// Per-pivot cumulative histogram of region distances
+	hist_offsets[0] = 0;
+	for (int p = 0; p < k; p++)
+		hist_offsets[p + 1] = hist_offsets[p] + region_max[p] + 1;
+	int *hist = calloc(hist_offsets[k], sizeof(int));
+	if (!hist) {
+		free(region);
+		free(region_max);
+		free(hist_offsets);
+		return false;
+	}
+	for (uint32_t i = 0; i < n; i++) {
+		int p = region[i];
+		hist[hist_offsets[p] + (int)distances[(size_t)p * n + i]]++;
+	}
+	for (int p = 0; p < k; p++) {
+		for (int d = 1; d <= region_max[p]; d++)
+			hist[hist_offsets[p] + d] += hist[hist_offsets[p] + d - 1];
+	}
+
+#pragma omp parallel for
+	for (int64_t i = 0; i < (int64_t)n; i++) {
+		for (int p = 0; p < k; p++) {
+			float d = distances[(size_t)p * n + i];
+			int half = (int)(d * 0.5f);
+			float s = (float)hist[hist_offsets[p] + (half < region_max[p] ? half : region_max[p])];
+			ctx->pivot_dist[i * k + p] = d;
+			// Neighbors (d = 1) already have an exact term, the node itself none
+			ctx->pivot_weight[i * k + p] = d > 1.0f ? s / (d * d) : 0.0f;
+		}
+	}
+
+	free(hist);
+	free(region);
+	free(region_max);
+	free(hist_offsets);
+	return true;
+}
+
+bool stress_init_edges(StressContext *ctx, uint32_t node_count, const igraph_vector_int_t *edges, const igraph_matrix_t *seed)
+{
+	memset(ctx, 0, sizeof(StressContext));
+	uint32_t n = node_count;
+	ctx->node_count = n;
+	ctx->max_iterations = STRESS_ITERATIONS;
+	ctx->num_threads = omp_get_max_threads();
+	ctx->pivot_count = STRESS_PIVOTS < (int)n ? STRESS_PIVOTS : (int)n;
+	int k = ctx->pivot_count;
+
+	ctx->x = calloc(n + 1, sizeof(float));
+	ctx->y = calloc(n + 1, sizeof(float));
+	ctx->z = calloc(n + 1, sizeof(float));
+	ctx->next_x = malloc(sizeof(float) * (n + 1));
+	ctx->next_y = malloc(sizeof(float) * (n + 1));
+	ctx->next_z = malloc(sizeof(float) * (n + 1));
+	ctx->pivots = malloc(sizeof(int) * (k + 1));
+	ctx->pivot_dist = malloc(sizeof(float) * ((size_t)n * k + 1));
+	ctx->pivot_weight = malloc(sizeof(float) * ((size_t)n * k + 1));
+	float *distances = malloc(sizeof(float) * ((size_t)n * k + 1));
+	bool ok = ctx->x && ctx->y && ctx->z && ctx->next_x && ctx->next_y && ctx->next_z && ctx->pivots && ctx->pivot_dist && ctx->pivot_weight && distances;
+	ok = ok && pivot_mds_adjacency(n, edges, &ctx->adj_offsets, &ctx->adj_neighbors);
+
+	if (ok && k > 0) {
+		pivot_mds_choose_pivots(n, k, ctx->pivots);
+		pivot_mds_distances(n, ctx->adj_offsets, ctx->adj_neighbors, ctx->pivots, k, distances);
+		ok = init_pivot_terms(ctx, distances);
+	}
+
+	if (ok && seed) {
+		for (uint32_t i = 0; i < n; i++) {
+			ctx->x[i] = (float)MATRIX(*seed, i, 0);
+			ctx->y[i] = (float)MATRIX(*seed, i, 1);
+			ctx->z[i] = (float)MATRIX(*seed, i, 2);
+		}
+	} else if (ok && k >= 2) {
+		// Cold start from the Pivot MDS embedding of the same distances
+		ok = pivot_mds_project(n, k, distances, ctx->x, ctx->y, ctx->z);
+	}
+	free(distances);
+
+	if (!ok) {
+		stress_cleanup(ctx);
+		return false;
+	}
+	return true;
+}
+
+void stress_cleanup(StressContext *ctx)
+{
+	free_state(ctx);
+	memset(ctx, 0, sizeof(StressContext));
+}
+
+bool stress_iterate(StressContext *ctx)
+{
+	if (ctx->iteration >= ctx->max_iterations || ctx->node_count == 0)
+		return false;
+
+	uint32_t n = ctx->node_count;
+	int k = ctx->pivot_count;
+	const float *x = ctx->x, *y = ctx->y, *z = ctx->z;
+	double moved = 0.0;
+
+	// Localized majorization: each node moves to the weighted mean of where each of its terms
+	// would put it, all from the previous positions (Jacobi), so nodes update independently
+#pragma omp parallel for schedule(dynamic, 256) reduction(+ : moved)
+	for (int64_t i = 0; i < (int64_t)n; i++) {
+		float xi = x[i], yi = y[i], zi = z[i];
+		float sx = 0.0f, sy = 0.0f, sz = 0.0f, sw = 0.0f;
+
+		for (int e = ctx->adj_offsets[i]; e < ctx->adj_offsets[i + 1]; e++) {
+			int j = ctx->adj_neighbors[e];
+			float dx = xi - x[j], dy = yi - y[j], dz = zi - z[j];
+			float len = sqrtf(dx * dx + dy * dy + dz * dz);
+			float s = len > 1e-6f ? 1.0f / len : 0.0f; // Target length 1, weight 1
+			sx += x[j] + dx * s;
+			sy += y[j] + dy * s;
+			sz += z[j] + dz * s;
+			sw += 1.0f;
+		}
+
+		const float *dist = ctx->pivot_dist + (size_t)i * k;
+		const float *weight = ctx->pivot_weight + (size_t)i * k;
+		for (int p = 0; p < k; p++) {
+			float w = weight[p];
+			if (w == 0.0f)
+				continue;
+			int j = ctx->pivots[p];
+			float dx = xi - x[j], dy = yi - y[j], dz = zi - z[j];
+			float len = sqrtf(dx * dx + dy * dy + dz * dz);
+			float s = len > 1e-6f ? dist[p] / len : 0.0f;
+			sx += w * (x[j] + dx * s);
+			sy += w * (y[j] + dy * s);
+			sz += w * (z[j] + dz * s);
+			sw += w;
+		}
+
+		float nx = xi, ny = yi, nz = zi;
+		if (sw > 0.0f) {
+			nx = sx / sw;
+			ny = sy / sw;
+			nz = sz / sw;
+		}
+		ctx->next_x[i] = nx;
+		ctx->next_y[i] = ny;
+		ctx->next_z[i] = nz;
+		moved += sqrtf((nx - xi) * (nx - xi) + (ny - yi) * (ny - yi) + (nz - zi) * (nz - zi));
+	}
+
+	float *tmp;
+	tmp = ctx->x, ctx->x = ctx->next_x, ctx->next_x = tmp;
+	tmp = ctx->y, ctx->y = ctx->next_y, ctx->next_y = tmp;
+	tmp = ctx->z, ctx->z = ctx->next_z, ctx->next_z = tmp;
+
+	ctx->iteration++;
+	ctx->last_move = (float)(moved / n);
+	return ctx->last_move >= STRESS_TOLERANCE && ctx->iteration < ctx->max_iterations;
+}
+
+void stress_get_positions(const StressContext *ctx, float (*out)[3])
+{
+	for (uint32_t i = 0; i < ctx->node_count; i++) {
+		out[i][0] = ctx->x[i];
+		out[i][1] = ctx->y[i];
+		out[i][2] = ctx->z[i];
+	}
+}
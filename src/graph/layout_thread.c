@@ -0,0 +1,320 @@
+#include "graph/layout_thread.h"
+#include "graph/graph_rng.h"
+#include "graph/layered_sphere.h"
+#include "graph/layout_barnes_hut.h"
+#include "graph/layout_openord.h"
+#include <igraph.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The layout thread, for the igraph interruption handler
+static _Thread_local LayoutThread *tls_layout_thread = NULL;
+
+// Lets a stop request interrupt a long igraph call (UMAP) instead of waiting for it to return
+static igraph_error_t layout_thread_interruption_handler(void *data)
+{
+	(void)data;
+	if (tls_layout_thread && atomic_load_explicit(&tls_layout_thread->stop_requested, memory_order_acquire))
+		return IGRAPH_INTERRUPTED;
+	return IGRAPH_SUCCESS;
+}
+
+// Advance the job by one step on the thread's private state; false once it's done
+static bool layout_thread_iterate(LayoutThread *lt)
+{
+	GraphData *graph = lt->graph;
+	switch (lt->layout) {
+	case LAYOUT_OPENORD_3D: {
+		OpenOrdContext *ctx = graph->openord;
+		bool more = openord_iterate(ctx);
+		atomic_store_explicit(&lt->stage_id, ctx->stage_id, memory_order_relaxed);
+		atomic_store_explicit(&lt->current_iter, ctx->current_iter, memory_order_relaxed);
+		atomic_store_explicit(&lt->level, ctx->level, memory_order_relaxed);
+		return more;
+	}
+	case LAYOUT_BARNES_HUT_3D: {
+		bool more = barnes_hut_iterate(graph->barnes_hut);
+		atomic_store_explicit(&lt->current_iter, graph->barnes_hut->iteration, memory_order_relaxed);
+		return more;
+	}
+	case LAYOUT_LAYERED_SPHERE_3D: {
+		bool more = layered_sphere_iterate_run(graph);
+		atomic_store_explicit(&lt->current_iter, layered_sphere_run_iteration(graph), memory_order_relaxed);
+		return more;
+	}
+	case LAYOUT_FR_3D: {
+		// Chunks cool linearly over the run, as one long call would
+		igraph_real_t start_temp = (igraph_real_t)graph->node_count * (1.0 - (double)lt->iterations_done / LAYOUT_THREAD_ITERATIONS);
+		igraph_layout_fruchterman_reingold_3d(&graph->g, &lt->work, lt->work_seeded, LAYOUT_THREAD_CHUNK, start_temp, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+		break;
+	}
+	case LAYOUT_UMAP_3D:
+		// One call: each call rebuilds the fuzzy graph and restarts the learning rate schedule, so
+		// UMAP can't be chunked like FR. igraph reports no progress from it, so the positions
+		// arrive when it returns (or is interrupted by a stop)
+		igraph_layout_umap_3d(&graph->g, &lt->work, lt->work_seeded, NULL, 0.1, LAYOUT_THREAD_ITERATIONS, 0);
+		lt->work_seeded = true;
+		lt->iterations_done = LAYOUT_THREAD_ITERATIONS;
+		return false;
+	default:
+		return false;
+	}
+	lt->work_seeded = true;
+	lt->iterations_done += LAYOUT_THREAD_CHUNK;
+	return lt->iterations_done < LAYOUT_THREAD_ITERATIONS;
+}
+
+// Copy the job's current layout into out (one position per node)
+static void layout_thread_read(LayoutThread *lt, vec3 *out)
+{
+	if (lt->layout == LAYOUT_OPENORD_3D) {
+		openord_get_positions(lt->graph->openord, out);
+		return;
+	}
+	if (lt->layout == LAYOUT_BARNES_HUT_3D) {
+		barnes_hut_get_positions(lt->graph->barnes_hut, out);
+		return;
+	}
+	if (lt->layout == LAYOUT_LAYERED_SPHERE_3D) {
+		layered_sphere_get_positions(lt->graph, out);
+		return;
+	}
+	for (uint32_t i = 0; i < lt->position_count; i++) {
+		out[i][0] = (float)MATRIX(lt->work, i, 0);
+		out[i][1] = (float)MATRIX(lt->work, i, 1);
+		out[i][2] = (float)MATRIX(lt->work, i, 2);
+	}
+}
+
+// Fill the back buffer and swap it to the front, unless the main thread still has to take
+// the previous front; the layout keeps iterating either way
+static void layout_thread_publish(LayoutThread *lt)
+{
+	if (atomic_load_explicit(&lt->fresh, memory_order_acquire))
+		return;
+	int back = 1 - atomic_load_explicit(&lt->front, memory_order_relaxed);
+	layout_thread_read(lt, lt->positions[back]);
+	atomic_store_explicit(&lt->front, back, memory_order_relaxed);
+	atomic_store_explicit(&lt->fresh, true, memory_order_release);
+}
+
+static void write_positions(GraphData *graph, const vec3 *positions, uint32_t count)
+{
+	bool has_z = igraph_matrix_ncol(&graph->current_layout) > 2;
+	for (uint32_t i = 0; i < count; i++) {
+		glm_vec3_copy((float *)positions[i], graph->nodes[i].position);
+		MATRIX(graph->current_layout, i, 0) = positions[i][0];
+		MATRIX(graph->current_layout, i, 1) = positions[i][1];
+		if (has_z)
+			MATRIX(graph->current_layout, i, 2) = positions[i][2];
+	}
+}
+
+// Main thread, thread idle: take the last state of the run directly from its source
+static void layout_thread_finish(LayoutThread *lt, GraphData *graph)
+{
+	lt->pending_final = false;
+	atomic_store_explicit(&lt->fresh, false, memory_order_relaxed);
+	if (graph != lt->graph || graph->node_count != lt->position_count)
+		return;
+	layout_thread_read(lt, lt->positions[0]);
+	write_positions(graph, lt->positions[0], lt->position_count);
+}
+
+static void *layout_thread_func(void *arg)
+{
+	LayoutThread *lt = (LayoutThread *)arg;
+
+	// igraph layouts draw from the default RNG; seed it like the worker thread does
+	igraph_rng_t thread_rng;
+	igraph_rng_init(&thread_rng, &igraph_rngtype_mt19937);
+	igraph_rng_seed(&thread_rng, (igraph_uint_t)graph_rng_get_seed());
+	igraph_rng_set_default(&thread_rng);
+
+	// An interrupted call must return instead of aborting; its matrix keeps the last positions
+	tls_layout_thread = lt;
+	igraph_set_interruption_handler(layout_thread_interruption_handler);
+	igraph_set_error_handler(igraph_error_handler_ignore);
+
+	pthread_mutex_lock(&lt->mutex);
+	while (lt->running) {
+		while (lt->running && !lt->has_job)
+			pthread_cond_wait(&lt->cond, &lt->mutex);
+		if (!lt->running)
+			break;
+		pthread_mutex_unlock(&lt->mutex);
+
+		while (!atomic_load_explicit(&lt->stop_requested, memory_order_acquire)) {
+			bool more = layout_thread_iterate(lt);
+			if (!more)
+				break;
+			layout_thread_publish(lt);
+		}
+
+		pthread_mutex_lock(&lt->mutex);
+		lt->has_job = false;
+		atomic_store_explicit(&lt->busy, false, memory_order_release);
+		pthread_cond_broadcast(&lt->cond);
+	}
+	pthread_mutex_unlock(&lt->mutex);
+
+	igraph_rng_destroy(&thread_rng);
+	return NULL;
+}
+
+int layout_thread_init(LayoutThread *lt)
+{
+	memset(lt, 0, sizeof(LayoutThread));
+	atomic_init(&lt->busy, false);
+	atomic_init(&lt->stop_requested, false);
+	atomic_init(&lt->front, 0);
+	atomic_init(&lt->fresh, false);
+
+	if (pthread_mutex_init(&lt->mutex, NULL) != 0)
+		return -1;
+	if (pthread_cond_init(&lt->cond, NULL) != 0) {
+		pthread_mutex_destroy(&lt->mutex);
+		return -1;
+	}
+
+	lt->running = true;
+	if (pthread_create(&lt->thread, NULL, layout_thread_func, lt) != 0) {
+		pthread_cond_destroy(&lt->cond);
+		pthread_mutex_destroy(&lt->mutex);
+		return -1;
+	}
+	lt->thread_running = true;
+	return 0;
+}
+
+bool layout_thread_supports(LayoutType layout)
+{
+	return layout == LAYOUT_OPENORD_3D || layout == LAYOUT_BARNES_HUT_3D || layout == LAYOUT_LAYERED_SPHERE_3D || layout == LAYOUT_FR_3D || layout == LAYOUT_UMAP_3D;
+}
+
+bool layout_thread_start(LayoutThread *lt, GraphData *graph, LayoutType layout)
+{
+	if (!lt->thread_running || !graph->graph_initialized || graph->node_count == 0 || !layout_thread_supports(layout))
+		return false;
+	layout_thread_stop(lt, graph);
+
+	graph->active_layout = layout;
+	if (layout == LAYOUT_OPENORD_3D) {
+		if (!graph->openord) {
+			graph->openord = malloc(sizeof(OpenOrdContext));
+			openord_init(graph->openord, graph, 0);
+		}
+		if (graph->openord->stage_id >= 5)
+			return false;
+		// Hierarchy rebuilds and position pickup happen here, while the thread is idle
+		openord_sync(graph->openord, graph);
+		atomic_store_explicit(&lt->stage_id, graph->openord->stage_id, memory_order_relaxed);
+		atomic_store_explicit(&lt->current_iter, graph->openord->current_iter, memory_order_relaxed);
+		atomic_store_explicit(&lt->level, graph->openord->level, memory_order_relaxed);
+	} else if (layout == LAYOUT_BARNES_HUT_3D) {
+		if (!graph->barnes_hut) {
+			graph->barnes_hut = malloc(sizeof(BarnesHutContext));
+			barnes_hut_init(graph->barnes_hut, graph);
+		}
+		if (graph->barnes_hut->iteration >= graph->barnes_hut->max_iterations)
+			return false;
+		barnes_hut_sync(graph->barnes_hut, graph);
+		atomic_store_explicit(&lt->current_iter, graph->barnes_hut->iteration, memory_order_relaxed);
+	} else if (layout == LAYOUT_LAYERED_SPHERE_3D) {
+		if (!layered_sphere_start(graph) || !layered_sphere_unfinished(graph))
+			return false;
+		atomic_store_explicit(&lt->current_iter, layered_sphere_run_iteration(graph), memory_order_relaxed);
+	} else {
+		// The 3D igraph layouts need n x 3; anything else starts from a random layout
+		lt->work_seeded = igraph_matrix_ncol(&graph->current_layout) == 3 && igraph_matrix_nrow(&graph->current_layout) == graph->node_count;
+		if (!lt->work_seeded)
+			igraph_matrix_resize(&graph->current_layout, graph->node_count, 3);
+		if (lt->work_initialized)
+			igraph_matrix_destroy(&lt->work);
+		igraph_matrix_init_copy(&lt->work, &graph->current_layout);
+		lt->work_initialized = true;
+	}
+
+	if (graph->node_count > lt->position_capacity) {
+		for (int b = 0; b < 2; b++) {
+			free(lt->positions[b]);
+			lt->positions[b] = malloc(sizeof(vec3) * graph->node_count);
+		}
+		lt->position_capacity = graph->node_count;
+	}
+	lt->graph = graph;
+	lt->layout = layout;
+	lt->iterations_done = 0;
+	lt->position_count = graph->node_count;
+	atomic_store_explicit(&lt->front, 0, memory_order_relaxed);
+	atomic_store_explicit(&lt->fresh, false, memory_order_relaxed);
+
+	pthread_mutex_lock(&lt->mutex);
+	lt->has_job = true;
+	lt->pending_final = true;
+	atomic_store_explicit(&lt->busy, true, memory_order_release);
+	pthread_cond_signal(&lt->cond);
+	pthread_mutex_unlock(&lt->mutex);
+	return true;
+}
+
+void layout_thread_stop(LayoutThread *lt, GraphData *graph)
+{
+	if (!lt->thread_running)
+		return;
+
+	pthread_mutex_lock(&lt->mutex);
+	if (lt->has_job) {
+		atomic_store_explicit(&lt->stop_requested, true, memory_order_release);
+		while (lt->has_job)
+			pthread_cond_wait(&lt->cond, &lt->mutex);
+		atomic_store_explicit(&lt->stop_requested, false, memory_order_relaxed);
+	}
+	pthread_mutex_unlock(&lt->mutex);
+
+	if (lt->pending_final)
+		layout_thread_finish(lt, graph);
+}
+
+bool layout_thread_consume(LayoutThread *lt, GraphData *graph)
+{
+	if (!atomic_load_explicit(&lt->busy, memory_order_acquire)) {
+		if (!lt->pending_final)
+			return false;
+		layout_thread_finish(lt, graph);
+		return true;
+	}
+
+	if (!atomic_load_explicit(&lt->fresh, memory_order_acquire))
+		return false;
+	int front = atomic_load_explicit(&lt->front, memory_order_relaxed);
+	write_positions(graph, lt->positions[front], lt->position_count);
+	// Only now may the thread reuse this buffer
+	atomic_store_explicit(&lt->fresh, false, memory_order_release);
+	return true;
+}
+
+bool layout_thread_is_busy(LayoutThread *lt)
+{
+	return atomic_load_explicit(&lt->busy, memory_order_acquire);
+}
+
+void layout_thread_cleanup(LayoutThread *lt)
+{
+	if (lt->thread_running) {
+		pthread_mutex_lock(&lt->mutex);
+		lt->running = false;
+		atomic_store_explicit(&lt->stop_requested, true, memory_order_release);
+		pthread_cond_broadcast(&lt->cond);
+		pthread_mutex_unlock(&lt->mutex);
+		pthread_join(lt->thread, NULL);
+		lt->thread_running = false;
+		pthread_cond_destroy(&lt->cond);
+		pthread_mutex_destroy(&lt->mutex);
+	}
+	if (lt->work_initialized)
+		igraph_matrix_destroy(&lt->work);
+	free(lt->positions[0]);
+	free(lt->positions[1]);
+	memset(lt, 0, sizeof(LayoutThread));
+}
@@ -1,5 +1,7 @@
 #include "graph/worker_thread.h"
+#include "app_state.h"
 #include "graph/command_registry.h"
+#include "graph/graph_rng.h"
 #include <igraph.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,18 +18,84 @@ static igraph_error_t igraph_progress_handler(const char *message, igraph_real_t
 	if (tls_current_job) {
 		float p = (float)percent / 100.0f;
 		atomic_store_explicit(&tls_current_job->progress, p, memory_order_release);
+		if (tls_current_job->snapshots.watched)
+			worker_thread_publish_layout(tls_current_job->snapshots.watched);
 	}
 	return IGRAPH_SUCCESS;
 }
 
+static double now_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+float *worker_thread_snapshot_begin(uint32_t count)
+{
+	if (!tls_current_job || count == 0)
+		return NULL;
+	WorkerSnapshots *snap = &tls_current_job->snapshots;
+	double now = now_ms();
+	if (snap->slots[0] && now - snap->last_publish_ms < WORKER_SNAPSHOT_INTERVAL_MS)
+		return NULL;
+	// The layout size is fixed per job, so the slots are allocated once, before the first swap
+	if (!snap->slots[0]) {
+		for (int i = 0; i < 3; i++) {
+			snap->slots[i] = malloc(sizeof(float) * 3 * count);
+			if (!snap->slots[i]) {
+				for (int j = 0; j < i; j++) {
+					free(snap->slots[j]);
+					snap->slots[j] = NULL;
+				}
+				return NULL;
+			}
+		}
+		snap->count = count;
+	}
+	if (count != snap->count)
+		return NULL;
+	snap->last_publish_ms = now;
+	return snap->slots[snap->back];
+}
+
+void worker_thread_snapshot_end(void)
+{
+	WorkerSnapshots *snap = &tls_current_job->snapshots;
+	int old = atomic_exchange_explicit(&snap->middle, snap->back | WORKER_SNAPSHOT_FRESH, memory_order_acq_rel);
+	snap->back = old & ~WORKER_SNAPSHOT_FRESH;
+}
+
+void worker_thread_publish_layout(const igraph_matrix_t *layout)
+{
+	uint32_t count = (uint32_t)igraph_matrix_nrow(layout);
+	float *out = worker_thread_snapshot_begin(count);
+	if (!out)
+		return;
+	bool has_z = igraph_matrix_ncol(layout) > 2;
+	for (uint32_t i = 0; i < count; i++) {
+		out[3 * i + 0] = (float)MATRIX(*layout, i, 0);
+		out[3 * i + 1] = (float)MATRIX(*layout, i, 1);
+		out[3 * i + 2] = has_z ? (float)MATRIX(*layout, i, 2) : 0.0f;
+	}
+	worker_thread_snapshot_end();
+}
+
+void worker_thread_watch_layout(const igraph_matrix_t *layout)
+{
+	if (tls_current_job)
+		tls_current_job->snapshots.watched = layout;
+}
+
 // Worker thread function
 static void *worker_thread_func(void *arg)
 {
 	WorkerThreadContext *context = (WorkerThreadContext *)arg;
 
-	// Initialize thread-local RNG
+	// Initialize thread-local RNG from the global seed so igraph commands are reproducible
 	igraph_rng_t thread_rng;
 	igraph_rng_init(&thread_rng, &igraph_rngtype_mt19937);
+	igraph_rng_seed(&thread_rng, (igraph_uint_t)graph_rng_get_seed());
 	igraph_rng_set_default(&thread_rng);
 
 	// Set progress handler for this thread
@@ -136,7 +204,7 @@ int worker_thread_init(WorkerThreadContext *context, int max_queue_size)
 }
 
 // Submit a job to worker thread
-WorkerJob *worker_thread_submit_job(WorkerThreadContext *context, CommandDef *cmd, ExecutionContext *ctx)
+WorkerJob *worker_thread_submit_job(WorkerThreadContext *context, CommandDef *cmd, ExecutionContext *ctx, const igraph_matrix_t *seed_layout)
 {
 	if (!context || !cmd || !ctx) {
 		return NULL;
@@ -173,13 +241,29 @@ WorkerJob *worker_thread_submit_job(WorkerThreadContext *context, CommandDef *cm
 	job->ctx = ctx_copy;
 	atomic_init(&job->progress, 0.0f);
 	job->result_data = NULL;
+	// Worker starts on slot 0, the main thread holds slot 2, slot 1 waits in the middle
+	atomic_init(&job->snapshots.middle, 1);
+	job->snapshots.front = 2;
 
 	// Store dynamic function pointers from CommandDef
 	job->worker_func = cmd->worker_func;
 	job->apply_func = cmd->apply_func;
 	job->free_func = cmd->free_func;
 
+	// Snapshot the seed now: the main thread keeps changing the layout while the job runs
+	if (seed_layout) {
+		job->seed_layout = malloc(sizeof(igraph_matrix_t));
+		if (!job->seed_layout || igraph_matrix_init_copy(job->seed_layout, seed_layout) != IGRAPH_SUCCESS) {
+			free(job->seed_layout);
+			job->seed_layout = NULL;
+		}
+	}
+
 	if (pthread_mutex_init(&job->mutex, NULL) != 0) {
+		if (job->seed_layout) {
+			igraph_matrix_destroy(job->seed_layout);
+			free(job->seed_layout);
+		}
 		free(ctx_copy);
 		free(job);
 		pthread_mutex_unlock(&context->queue_mutex);
@@ -215,6 +299,54 @@ WorkerJobStatus worker_thread_get_job_status(WorkerJob *job, float *progress)
 	return status;
 }
 
+const igraph_matrix_t *worker_thread_seed_layout(void)
+{
+	return tls_current_job ? tls_current_job->seed_layout : NULL;
+}
+
+GraphData *worker_thread_graph(void)
+{
+	if (!tls_current_job || !tls_current_job->ctx || !tls_current_job->ctx->app_state)
+		return NULL;
+	return &tls_current_job->ctx->app_state->current_graph;
+}
+
+bool worker_thread_consume_snapshot(WorkerJob *job, GraphData *graph)
+{
+	if (!job || !(atomic_load_explicit(&job->snapshots.middle, memory_order_acquire) & WORKER_SNAPSHOT_FRESH))
+		return false;
+	WorkerSnapshots *snap = &job->snapshots;
+	snap->front = atomic_exchange_explicit(&snap->middle, snap->front, memory_order_acq_rel) & ~WORKER_SNAPSHOT_FRESH;
+	if (!graph->nodes || snap->count != graph->node_count)
+		return false;
+	const float *in = snap->slots[snap->front];
+	for (uint32_t i = 0; i < snap->count; i++) {
+		graph->nodes[i].position[0] = in[3 * i + 0];
+		graph->nodes[i].position[1] = in[3 * i + 1];
+		graph->nodes[i].position[2] = in[3 * i + 2];
+	}
+	return true;
+}
+
+void worker_thread_destroy_job(WorkerJob *job)
+{
+	if (!job) {
+		return;
+	}
+	pthread_mutex_destroy(&job->mutex);
+	if (job->ctx) {
+		free(job->ctx);
+	}
+	if (job->seed_layout) {
+		igraph_matrix_destroy(job->seed_layout);
+		free(job->seed_layout);
+	}
+	for (int i = 0; i < 3; i++) {
+		free(job->snapshots.slots[i]);
+	}
+	free(job);
+}
+
 // Wait for job completion (blocking)
 // Clean up worker thread system
 void worker_thread_cleanup(WorkerThreadContext *context)
@@ -243,11 +375,7 @@ void worker_thread_cleanup(WorkerThreadContext *context)
 			if (job->result_data && job->free_func) {
 				job->free_func(job->result_data);
 			}
-			if (job->ctx) {
-				free(job->ctx);
-			}
-			pthread_mutex_destroy(&job->mutex);
-			free(job);
+			worker_thread_destroy_job(job);
 		}
 	}
 
@@ -255,11 +383,7 @@ void worker_thread_cleanup(WorkerThreadContext *context)
 		if (context->current_job->result_data && context->current_job->free_func) {
 			context->current_job->free_func(context->current_job->result_data);
 		}
-		if (context->current_job->ctx) {
-			free(context->current_job->ctx);
-		}
-		pthread_mutex_destroy(&context->current_job->mutex);
-		free(context->current_job);
+		worker_thread_destroy_job(context->current_job);
 	}
 
 	free(context->job_queue);
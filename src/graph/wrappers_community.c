@@ -1,5 +1,6 @@
 #include "graph/wrappers_community.h"
 #include "app_state.h"
+#include "graph/graph_aggregate.h"
 #include "interaction/state.h"
 #include "vulkan/renderer.h"
 #include <igraph.h>
@@ -430,6 +431,9 @@ void apply_community_membership(ExecutionContext *ctx, void *result_data)
 	free(colors);
 	free(cluster_sizes);
 
+	// Cache the quotient graph for semantic zoom (built after colors so meta-nodes match)
+	graph_aggregate_set(data, membership);
+
 	// Refresh renderer
 	renderer_update_graph(renderer, data);
 
@@ -1,5 +1,6 @@
 #include "graph/wrappers_constructors.h"
 #include "app_state.h"
+#include "graph/graph_actions.h"
 #include "graph/graph_io.h"
 #include "interaction/state.h"
 #include "vulkan/animation_manager.h"
@@ -355,8 +356,8 @@ void *compute_igraph_nearest_neighbor_graph(igraph_t *graph)
 	igraph_matrix_t points;
 	igraph_matrix_init(&points, 25, 2);
 	for (int i = 0; i < 25; i++) {
-		igraph_matrix_set(&points, i, 0, (igraph_real_t)rand() / RAND_MAX);
-		igraph_matrix_set(&points, i, 1, (igraph_real_t)rand() / RAND_MAX);
+		igraph_matrix_set(&points, i, 0, igraph_rng_get_unif01(igraph_rng_default()));
+		igraph_matrix_set(&points, i, 1, igraph_rng_get_unif01(igraph_rng_default()));
 	}
 
 	// Parameters: points, metric=L2 (Euclidean), k=-1 (use cutoff), cutoff=0.2, undirected
@@ -383,8 +384,8 @@ void *compute_igraph_gabriel_graph(igraph_t *graph)
 	igraph_matrix_t points;
 	igraph_matrix_init(&points, 20, 2);
 	for (int i = 0; i < 20; i++) {
-		igraph_matrix_set(&points, i, 0, (igraph_real_t)rand() / RAND_MAX);
-		igraph_matrix_set(&points, i, 1, (igraph_real_t)rand() / RAND_MAX);
+		igraph_matrix_set(&points, i, 0, igraph_rng_get_unif01(igraph_rng_default()));
+		igraph_matrix_set(&points, i, 1, igraph_rng_get_unif01(igraph_rng_default()));
 	}
 
 	// Parameters: points, (other parameters have defaults)
@@ -455,6 +456,8 @@ void apply_new_graph(ExecutionContext *ctx, void *result_data)
 	// Reinitialize animation manager with new graph data
 	animation_manager_init(&state->anim_manager, renderer, data);
 
+	graph_action_update_hubs(state);
+
 	// Refresh renderer
 	renderer_update_graph(renderer, data);
 
@@ -2,6 +2,12 @@
 
 #include "graph/wrappers_layout.h"
 #include "app_state.h"
+#include "graph/graph_actions.h"
+#include "graph/layout_barnes_hut.h"
+#include "graph/layout_pivot_mds.h"
+#include "graph/layout_spectral.h"
+#include "graph/layout_stress.h"
+#include "graph/worker_thread.h"
 #include "interaction/state.h"
 #include "vulkan/renderer.h"
 #include <float.h>
@@ -15,6 +21,41 @@
 #include <omp.h>
 #include <sched.h>
 
+// Warm starts run this fraction of a layout's cold iteration budget
+#define WARM_START_DIVISOR 4
+
+static igraph_integer_t warm_budget(igraph_integer_t cold, bool warm)
+{
+	igraph_integer_t budget = warm ? cold / WARM_START_DIVISOR : cold;
+	return budget > 0 ? budget : 1;
+}
+
+// Load the job's seed layout (the current positions) into result as an n x cols matrix.
+// A 2D seed gets a small z jitter so 3D forces can pull it out of the plane.
+// Returns false for a cold start: no seed, or one of a different size.
+static bool seed_from_current_layout(igraph_matrix_t *result, igraph_integer_t cols)
+{
+	const igraph_matrix_t *seed = worker_thread_seed_layout();
+	igraph_integer_t n = igraph_matrix_nrow(result);
+	if (!seed || igraph_matrix_nrow(seed) != n || igraph_matrix_ncol(seed) < 2)
+		return false;
+	if (igraph_matrix_resize(result, n, cols) != IGRAPH_SUCCESS)
+		return false;
+
+	igraph_integer_t seed_cols = igraph_matrix_ncol(seed);
+	igraph_real_t min_x = DBL_MAX, max_x = -DBL_MAX;
+	for (igraph_integer_t i = 0; i < n; i++) {
+		min_x = fmin(min_x, MATRIX(*seed, i, 0));
+		max_x = fmax(max_x, MATRIX(*seed, i, 0));
+	}
+	igraph_real_t jitter = n > 0 ? 0.01 * fmax(max_x - min_x, 1.0) : 0.0;
+	for (igraph_integer_t i = 0; i < n; i++) {
+		for (igraph_integer_t c = 0; c < cols; c++)
+			MATRIX(*result, i, c) = c < seed_cols ? MATRIX(*seed, i, c) : igraph_rng_get_unif(igraph_rng_default(), -jitter, jitter);
+	}
+	return true;
+}
+
 // Pure worker function - no UI or state dependencies
 void *compute_igraph_layout_fruchterman_reingold_3d(igraph_t *graph)
 {
@@ -25,7 +66,11 @@ void *compute_igraph_layout_fruchterman_reingold_3d(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_fruchterman_reingold_3d(graph, result, 1, 300, (igraph_real_t)vcount, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+	// Always seeded: a cold start begins from the zero matrix. A warm start only refines,
+	// so it also starts much cooler
+	bool warm = seed_from_current_layout(result, 3);
+	igraph_real_t start_temp = warm ? sqrt((igraph_real_t)vcount) : (igraph_real_t)vcount;
+	igraph_error_t code = igraph_layout_fruchterman_reingold_3d(graph, result, 1, warm_budget(300, warm), start_temp, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -45,7 +90,8 @@ void *compute_igraph_layout_kamada_kawai_3d(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_kamada_kawai_3d(graph, result, 0, vcount * 10, 0.0, (igraph_real_t)vcount, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+	bool warm = seed_from_current_layout(result, 3);
+	igraph_error_t code = igraph_layout_kamada_kawai_3d(graph, result, warm, warm_budget(vcount * 10, warm), 0.0, (igraph_real_t)vcount, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -65,10 +111,12 @@ void *compute_igraph_layout_drl_3d(igraph_t *graph)
 		return NULL;
 	}
 
+	// DrL's refine schedule skips the expansion phases for a seeded layout
+	bool warm = seed_from_current_layout(result, 3);
 	igraph_layout_drl_options_t options;
-	igraph_layout_drl_options_init(&options, IGRAPH_LAYOUT_DRL_DEFAULT);
+	igraph_layout_drl_options_init(&options, warm ? IGRAPH_LAYOUT_DRL_REFINE : IGRAPH_LAYOUT_DRL_DEFAULT);
 
-	igraph_error_t code = igraph_layout_drl_3d(graph, result, 0, &options, NULL);
+	igraph_error_t code = igraph_layout_drl_3d(graph, result, warm, &options, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -98,7 +146,8 @@ void *compute_igraph_layout_davidson_harel(igraph_t *graph)
 	igraph_real_t w_edge_cross = 1.0 - sqrt(density);
 	igraph_real_t w_node_edge = (1.0 - density) / 5.0;
 
-	igraph_error_t code = igraph_layout_davidson_harel(graph, result, 0, 10, fineiter, coolfact, w_dist, w_border, w_edge_len, w_edge_cross, w_node_edge);
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_error_t code = igraph_layout_davidson_harel(graph, result, warm, warm_budget(10, warm), fineiter, coolfact, w_dist, w_border, w_edge_len, w_edge_cross, w_node_edge);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -384,53 +433,91 @@ void *compute_igraph_layout_random_3d(igraph_t *graph)
 	return result;
 }
 
-// MDS layout (2D)
-void *compute_igraph_layout_mds(igraph_t *graph)
+// Pivot MDS layout (3D)
+void *compute_layout_pivot_mds_3d(igraph_t *graph)
 {
 	igraph_integer_t vcount = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return NULL;
+	if (igraph_get_edgelist(graph, &edges, 0) != IGRAPH_SUCCESS) {
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
+
+	// BFS from a fixed set of pivots: O(n * pivots) memory instead of an all-pairs matrix
 	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
 	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
 		free(result);
+		igraph_vector_int_destroy(&edges);
 		return NULL;
 	}
+	bool ok = pivot_mds_layout((uint32_t)vcount, &edges, PIVOT_MDS_PIVOTS, result);
+	igraph_vector_int_destroy(&edges);
 
-	// Compute distances first
-	igraph_matrix_t dist_matrix;
-	if (igraph_matrix_init(&dist_matrix, vcount, vcount) != IGRAPH_SUCCESS) {
+	if (!ok) {
 		igraph_matrix_destroy(result);
 		free(result);
 		return NULL;
 	}
+	return result;
+}
 
-	igraph_vs_t all_vs;
-	igraph_vs_all(&all_vs);
-
-	igraph_error_t dist_result = igraph_distances_dijkstra(graph, &dist_matrix, all_vs, all_vs, NULL, IGRAPH_ALL);
+// High-dimensional embedding layout (3D)
+void *compute_layout_hde_3d(igraph_t *graph)
+{
+	igraph_integer_t vcount = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return NULL;
+	if (igraph_get_edgelist(graph, &edges, 0) != IGRAPH_SUCCESS) {
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
 
-	igraph_vs_destroy(&all_vs);
+	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
+	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
+		free(result);
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
+	bool ok = spectral_hde_layout((uint32_t)vcount, &edges, SPECTRAL_HDE_PIVOTS, result);
+	igraph_vector_int_destroy(&edges);
 
-	if (dist_result != IGRAPH_SUCCESS) {
-		igraph_matrix_destroy(&dist_matrix);
+	if (!ok) {
 		igraph_matrix_destroy(result);
 		free(result);
 		return NULL;
 	}
+	return result;
+}
 
-	// Compute MDS in 2D (fills only first 2 columns of the 3D matrix)
-	igraph_error_t code = igraph_layout_mds(graph, result, &dist_matrix, 2);
-	igraph_matrix_destroy(&dist_matrix);
+// Laplacian spectral layout (3D)
+void *compute_layout_spectral_3d(igraph_t *graph)
+{
+	igraph_integer_t vcount = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return NULL;
+	if (igraph_get_edgelist(graph, &edges, 0) != IGRAPH_SUCCESS) {
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
 
-	if (code != IGRAPH_SUCCESS) {
-		igraph_matrix_destroy(result);
+	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
+	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
 		free(result);
+		igraph_vector_int_destroy(&edges);
 		return NULL;
 	}
+	bool ok = spectral_laplacian_layout((uint32_t)vcount, &edges, result);
+	igraph_vector_int_destroy(&edges);
 
-	// Set Z coordinate to 0 to convert 2D to 3D
-	for (igraph_integer_t i = 0; i < vcount; i++) {
-		igraph_matrix_set(result, i, 2, 0.0);
+	if (!ok) {
+		igraph_matrix_destroy(result);
+		free(result);
+		return NULL;
 	}
-
 	return result;
 }
 
@@ -481,7 +568,8 @@ void *compute_igraph_layout_umap_3d(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_umap_3d(graph, result, 0, NULL, 0.5, 500, 0);
+	bool warm = seed_from_current_layout(result, 3);
+	igraph_error_t code = igraph_layout_umap_3d(graph, result, warm, NULL, 0.5, warm_budget(500, warm), 0);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -501,7 +589,8 @@ void *compute_igraph_layout_fruchterman_reingold(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_fruchterman_reingold(graph, result, 0, 500, 50.0, IGRAPH_LAYOUT_AUTOGRID, NULL, NULL, NULL, NULL, NULL);
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_error_t code = igraph_layout_fruchterman_reingold(graph, result, warm, warm_budget(500, warm), warm ? 50.0 / WARM_START_DIVISOR : 50.0, IGRAPH_LAYOUT_AUTOGRID, NULL, NULL, NULL, NULL, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -521,7 +610,8 @@ void *compute_igraph_layout_kamada_kawai(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_kamada_kawai(graph, result, 0, vcount * 10, 0.0, (igraph_real_t)vcount, NULL, NULL, NULL, NULL, NULL);
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_error_t code = igraph_layout_kamada_kawai(graph, result, warm, warm_budget(vcount * 10, warm), 0.0, (igraph_real_t)vcount, NULL, NULL, NULL, NULL, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -541,10 +631,12 @@ void *compute_igraph_layout_drl(igraph_t *graph)
 		return NULL;
 	}
 
+	// DrL's refine schedule skips the expansion phases for a seeded layout
+	bool warm = seed_from_current_layout(result, 2);
 	igraph_layout_drl_options_t options;
-	igraph_layout_drl_options_init(&options, IGRAPH_LAYOUT_DRL_DEFAULT);
+	igraph_layout_drl_options_init(&options, warm ? IGRAPH_LAYOUT_DRL_REFINE : IGRAPH_LAYOUT_DRL_DEFAULT);
 
-	igraph_error_t code = igraph_layout_drl(graph, result, 0, &options, NULL);
+	igraph_error_t code = igraph_layout_drl(graph, result, warm, &options, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -628,7 +720,8 @@ void *compute_igraph_layout_umap(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_umap(graph, result, 0, NULL, 0.5, 500, 0);
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_error_t code = igraph_layout_umap(graph, result, warm, NULL, 0.5, warm_budget(500, warm), 0);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -648,7 +741,10 @@ void *compute_igraph_layout_graphopt(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_graphopt(graph, result, 500, 0.001, 30.0, 0.0, 1.0, 5.0, 0);
+	bool warm = seed_from_current_layout(result, 2);
+	worker_thread_watch_layout(result);
+	igraph_error_t code = igraph_layout_graphopt(graph, result, warm_budget(500, warm), 0.001, 30.0, 0.0, 1.0, 5.0, warm);
+	worker_thread_watch_layout(NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -701,12 +797,14 @@ void *compute_igraph_layout_gem(igraph_t *graph)
 	// temp_max: number of vertices
 	// temp_min: 0.1
 	// temp_init: sqrt(number of vertices)
-	igraph_int_t maxiter = 40 * vcount * vcount;
+	// Warm starts: fewer rounds from a lower initial temperature
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_int_t maxiter = warm_budget(40 * vcount * vcount, warm);
 	igraph_real_t temp_max = (igraph_real_t)vcount;
 	igraph_real_t temp_min = 0.1;
-	igraph_real_t temp_init = sqrt((igraph_real_t)vcount);
+	igraph_real_t temp_init = sqrt((igraph_real_t)vcount) / (warm ? WARM_START_DIVISOR : 1);
 
-	igraph_error_t code = igraph_layout_gem(graph, result, /*use_seed=*/0, maxiter, temp_max, temp_min, temp_init);
+	igraph_error_t code = igraph_layout_gem(graph, result, /*use_seed=*/warm, maxiter, temp_max, temp_min, temp_init);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -727,7 +825,8 @@ void *compute_igraph_layout_yifan_hu(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_yifan_hu(graph, result, 0, 500, -1.0, -1.0, 0.1, 1, 0.001, IGRAPH_QUADTREE_NONE, 10, 0, NULL, NULL, NULL, NULL, NULL);
+	bool warm = seed_from_current_layout(result, 2);
+	igraph_error_t code = igraph_layout_yifan_hu(graph, result, warm, warm_budget(500, warm), -1.0, -1.0, 0.1, 1, 0.001, IGRAPH_QUADTREE_NONE, 10, 0, NULL, NULL, NULL, NULL, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -748,7 +847,8 @@ void *compute_igraph_layout_yifan_hu_3d(igraph_t *graph)
 		return NULL;
 	}
 
-	igraph_error_t code = igraph_layout_yifan_hu_3d(graph, result, 0, 500, -1.0, -1.0, 0.1, 1, 0.001, IGRAPH_QUADTREE_NORMAL, 10, 0, NULL);
+	bool warm = seed_from_current_layout(result, 3);
+	igraph_error_t code = igraph_layout_yifan_hu_3d(graph, result, warm, warm_budget(500, warm), -1.0, -1.0, 0.1, 1, 0.001, IGRAPH_QUADTREE_NORMAL, 10, 0, NULL);
 
 	if (code != IGRAPH_SUCCESS) {
 		igraph_matrix_destroy(result);
@@ -759,6 +859,99 @@ void *compute_igraph_layout_yifan_hu_3d(igraph_t *graph)
 	return result;
 }
 
+// Native Barnes-Hut layout (3D), run to completion from the current layout or a seeded random start
+void *compute_layout_barnes_hut_3d(igraph_t *graph)
+{
+	igraph_integer_t vcount = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return NULL;
+	if (igraph_get_edgelist(graph, &edges, 0) != IGRAPH_SUCCESS) {
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
+
+	BarnesHutContext ctx;
+	const igraph_matrix_t *seed = worker_thread_seed_layout();
+	bool warm = seed && igraph_matrix_nrow(seed) == vcount && igraph_matrix_ncol(seed) == 3;
+	barnes_hut_init_edges(&ctx, (uint32_t)vcount, &edges, warm ? seed : NULL);
+	igraph_vector_int_destroy(&edges);
+	if (warm) {
+		// Refine: a short run whose moves stay around the spring length
+		ctx.max_iterations = (int)warm_budget(ctx.max_iterations, true);
+		ctx.start_temperature = ctx.ideal_length;
+	}
+	// Stepped in chunks of one iteration so the main thread can show the layout converging; the
+	// positions are only read out when a snapshot is due, straight into its buffer
+	while (barnes_hut_iterate(&ctx)) {
+		float *snapshot = worker_thread_snapshot_begin((uint32_t)vcount);
+		if (snapshot) {
+			barnes_hut_get_positions(&ctx, (vec3 *)snapshot);
+			worker_thread_snapshot_end();
+		}
+	}
+
+	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
+	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
+		free(result);
+		barnes_hut_cleanup(&ctx);
+		return NULL;
+	}
+	for (igraph_integer_t i = 0; i < vcount; i++) {
+		MATRIX(*result, i, 0) = ctx.x[i];
+		MATRIX(*result, i, 1) = ctx.y[i];
+		MATRIX(*result, i, 2) = ctx.z[i];
+	}
+	barnes_hut_cleanup(&ctx);
+	return result;
+}
+
+// Sparse stress majorization layout (3D)
+void *compute_layout_stress_3d(igraph_t *graph)
+{
+	igraph_integer_t vcount = igraph_vcount(graph);
+	igraph_vector_int_t edges;
+	if (igraph_vector_int_init(&edges, 0) != IGRAPH_SUCCESS)
+		return NULL;
+	if (igraph_get_edgelist(graph, &edges, 0) != IGRAPH_SUCCESS) {
+		igraph_vector_int_destroy(&edges);
+		return NULL;
+	}
+
+	// Cold starts come from Pivot MDS, warm starts refine the current layout
+	StressContext ctx;
+	const igraph_matrix_t *seed = worker_thread_seed_layout();
+	bool warm = seed && igraph_matrix_nrow(seed) == vcount && igraph_matrix_ncol(seed) == 3;
+	bool ok = stress_init_edges(&ctx, (uint32_t)vcount, &edges, warm ? seed : NULL);
+	igraph_vector_int_destroy(&edges);
+	if (!ok)
+		return NULL;
+	if (warm)
+		ctx.max_iterations = (int)warm_budget(ctx.max_iterations, true);
+
+	while (stress_iterate(&ctx)) {
+		float *snapshot = worker_thread_snapshot_begin((uint32_t)vcount);
+		if (snapshot) {
+			stress_get_positions(&ctx, (float (*)[3])snapshot);
+			worker_thread_snapshot_end();
+		}
+	}
+
+	igraph_matrix_t *result = malloc(sizeof(igraph_matrix_t));
+	if (igraph_matrix_init(result, vcount, 3) != IGRAPH_SUCCESS) {
+		free(result);
+		stress_cleanup(&ctx);
+		return NULL;
+	}
+	for (igraph_integer_t i = 0; i < vcount; i++) {
+		MATRIX(*result, i, 0) = ctx.x[i];
+		MATRIX(*result, i, 1) = ctx.y[i];
+		MATRIX(*result, i, 2) = ctx.z[i];
+	}
+	stress_cleanup(&ctx);
+	return result;
+}
+
 
 
 
@@ -781,10 +974,12 @@ void *compute_igraph_layout_forceatlas2_3d(igraph_t *graph)
 		return NULL;
 	}
 
+	bool warm = seed_from_current_layout(result, 3);
 	igraph_integer_t iterations = (igraph_integer_t)(50 + sqrt((double)vcount) * 2);
 	if (iterations > 1500) {
         iterations = 1500;
 	}
+	iterations = warm_budget(iterations, warm);
 	igraph_real_t scaling_ratio = (igraph_real_t)(1.0 + log1p((double)ecount) / 10.0);
 	igraph_real_t gravity = (igraph_real_t)(1.0 + sqrt((double)vcount) / 100.0);
 
@@ -803,7 +998,7 @@ void *compute_igraph_layout_forceatlas2_3d(igraph_t *graph)
         }
     }
 
-	igraph_error_t code = igraph_layout_forceatlas2_3d(graph, result, iterations, 0, 1.0, 1.0, 1, 1.2, scaling_ratio, 0, gravity, NULL);
+	igraph_error_t code = igraph_layout_forceatlas2_3d(graph, result, iterations, warm, 1.0, 1.0, 1, 1.2, scaling_ratio, 0, gravity, NULL);
 
 	printf("[ForceAtlas2] After layout: code=%d\n", code);
 	fflush(stdout);
@@ -862,6 +1057,12 @@ void free_layout_matrix(void *result_data)
 
 // Apply function - bridge to update graph state
 void apply_layout_matrix(ExecutionContext *ctx, void *result_data)
+{
+	// A plain layout has no layered sphere shells
+	apply_layout_matrix_with_shells(ctx, result_data, NULL, 0);
+}
+
+void apply_layout_matrix_with_shells(ExecutionContext *ctx, void *result_data, const float *shell_radii, uint32_t shell_count)
 {
 	if (!ctx || !ctx->app_state || !ctx->current_graph || !result_data) {
 		fprintf(stderr, "[apply_layout_matrix] Error: Invalid parameters\n");
@@ -920,6 +1121,10 @@ void apply_layout_matrix(ExecutionContext *ctx, void *result_data)
 		printf("[Layout Bounds] X: [%.3f, %.3f] Y: [%.3f, %.3f] Z: [%.3f, %.3f]\n", min_x, max_x, min_y, max_y, min_z, max_z);
 	}
 
+	// Shells go in before post-processing, which keeps nodes on them
+	renderer_update_spheres(renderer, (vec3){0.0f, 0.0f, 0.0f}, shell_radii, shell_count);
+	graph_action_post_process_layout(state);
+
 	// Trigger renderer update to display new layout
 	renderer_update_graph(renderer, data);
 
@@ -1031,6 +1236,9 @@ void apply_layout_matrix_centered(ExecutionContext *ctx, void *result_data)
 		printf("[Layout Bounds (centered)] X: [%.3f, %.3f] Y: [%.3f, %.3f] Z: [%.3f, %.3f]\n", min_x, max_x, min_y, max_y, min_z, max_z);
 	}
 
+	renderer_update_spheres(renderer, (vec3){0.0f, 0.0f, 0.0f}, NULL, 0);
+	graph_action_post_process_layout(state);
+
 	// Trigger renderer update to display new layout
 	renderer_update_graph(renderer, data);
 
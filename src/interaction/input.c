@@ -14,7 +14,7 @@
 #define max(a, b) ((a) > (b) ? (a) : (b))
 
 // Edge routing mode count (must match renderer.h enum count)
-#define EDGE_ROUTING_COUNT 2
+#define EDGE_ROUTING_COUNT 3
 
 static void key_callback(GLFWwindow *window, int key, int scancode, int action, int mods);
 static void mouse_button_callback(GLFWwindow *window, int button, int action, int mods);
@@ -128,6 +128,7 @@ static void key_callback(GLFWwindow *window, int key, int scancode, int action,
 	case GLFW_KEY_M:
 		// Cycle through edge routing modes
 		state->renderer.currentRoutingMode = (state->renderer.currentRoutingMode + 1) % EDGE_ROUTING_COUNT;
+		graph_action_update_hubs(state);
 		renderer_update_graph(&state->renderer, &state->current_graph);
 		break;
 	case GLFW_KEY_R:
@@ -136,6 +137,19 @@ static void key_callback(GLFWwindow *window, int key, int scancode, int action,
 	case GLFW_KEY_H:
 		state->renderer.showUI = !state->renderer.showUI;
 		break;
+	case GLFW_KEY_O:
+		state->renderer.singlePassNodes = !state->renderer.singlePassNodes;
+		break;
+	case GLFW_KEY_V:
+		state->renderer.edgeLod = !state->renderer.edgeLod;
+		break;
+	case GLFW_KEY_Z:
+		state->renderer.semanticZoom = !state->renderer.semanticZoom;
+		break;
+	case GLFW_KEY_G:
+		// Cycle density overview: auto (by node count) -> off -> on
+		state->renderer.densityMode = (state->renderer.densityMode + 1) % DENSITY_MODE_COUNT;
+		break;
 	case GLFW_KEY_SPACE:
 		if (state->app_ctx.current_state == STATE_GRAPH_VIEW && state->app_ctx.root_menu->current_radius < 0.01f) {
 			state->app_ctx.current_state = STATE_MENU_OPEN;
@@ -179,6 +193,13 @@ static void key_callback(GLFWwindow *window, int key, int scancode, int action,
 	case GLFW_KEY_J:
 		graph_action_highlight_infrastructure(state);
 		break;
+	case GLFW_KEY_U:
+		// Shift+U toggles overlap removal after every layout, U removes overlaps now
+		if (mods & GLFW_MOD_SHIFT)
+			state->remove_overlaps = !state->remove_overlaps;
+		else
+			graph_action_remove_overlaps(state);
+		break;
 	case GLFW_KEY_KP_ADD:
 	case GLFW_KEY_EQUAL:
 		state->renderer.layoutScale *= 1.2f;
@@ -1,5 +1,6 @@
 #include "interaction/state.h"
 #include "app_state.h"
+#include "graph/graph_actions.h"
 #include "graph/graph_core.h"
 #include "graph/worker_thread.h"
 #include "interaction/menu.h"
@@ -135,9 +136,20 @@ void update_app_state(AppState *state)
 				exec_ctx.update_visuals_callback = NULL;
 				exec_ctx.app_state = state;
 
+				// Seedable layouts warm-start from the current layout unless a cold start was requested.
+				// A running layout is stopped first: it would fight the job's intermediate layouts.
+				const igraph_matrix_t *seed_layout = NULL;
+				const GraphData *graph = &state->current_graph;
+				if (app->pending_command->cmd_def->seedable)
+					graph_action_stop_layout(state);
+				if (app->pending_command->cmd_def->seedable && !(app->pending_command->num_params > 0 && app->pending_command->params[0].value.b_val)) {
+					if (graph->graph_initialized && app->target_graph == &graph->g && igraph_matrix_nrow(&graph->current_layout) == igraph_vcount(&graph->g))
+						seed_layout = &graph->current_layout;
+				}
+
 				// Submit job to worker thread
 				if (state->worker_ctx.thread_running) {
-					state->current_worker_job = worker_thread_submit_job(&state->worker_ctx, (CommandDef *)app->pending_command->cmd_def, &exec_ctx);
+					state->current_worker_job = worker_thread_submit_job(&state->worker_ctx, (CommandDef *)app->pending_command->cmd_def, &exec_ctx, seed_layout);
 
 					if (state->current_worker_job) {
 						state->job_in_progress = true;
@@ -167,7 +179,8 @@ void update_app_state(AppState *state)
 				exec_ctx.update_visuals_callback = NULL;
 				exec_ctx.app_state = state;
 
-				// Execute immediately on main thread
+				// Execute immediately on main thread; it may replace the graph or its layout
+				graph_action_stop_layout(state);
 				app->pending_command->execute(&exec_ctx);
 
 				// Reset and return to menu
@@ -196,6 +209,7 @@ void update_app_state(AppState *state)
 				if (job) {
 					// Apply dynamic result if available
 					if (job->apply_func && job->result_data) {
+						graph_action_stop_layout(state);
 						job->apply_func(job->ctx, job->result_data);
 					}
 
@@ -211,11 +225,7 @@ void update_app_state(AppState *state)
 					}
 					pthread_mutex_unlock(&state->worker_ctx.queue_mutex);
 
-					pthread_mutex_destroy(&job->mutex);
-					if (job->ctx) {
-						free(job->ctx);
-					}
-					free(job);
+					worker_thread_destroy_job(job);
 				}
 
 				state->job_in_progress = false;
@@ -241,17 +251,16 @@ void update_app_state(AppState *state)
 					}
 					pthread_mutex_unlock(&state->worker_ctx.queue_mutex);
 
-					pthread_mutex_destroy(&job->mutex);
-					if (job->ctx) {
-						free(job->ctx);
-					}
-					free(job);
+					worker_thread_destroy_job(job);
 				}
 
 				state->job_in_progress = false;
 				state->current_worker_job = NULL;
 				app->pending_command = NULL;
 				app->current_state = STATE_MENU_OPEN;
+			} else if (status == JOB_STATUS_RUNNING && worker_thread_consume_snapshot(state->current_worker_job, &state->current_graph)) {
+				// Show the layout converging; the job's result replaces it when done
+				renderer_update_graph(&state->renderer, &state->current_graph);
 			}
 			// If still running, continue polling
 		}
@@ -365,6 +374,15 @@ void handle_menu_selection(AppContext *app, MenuNode *selected_node)
 		}
 	} else if (selected_node->type == NODE_INPUT_TOGGLE) {
 		selected_node->toggle_state = !selected_node->toggle_state;
+		// A toggle bound to a command sets its boolean parameter
+		if (selected_node->command) {
+			for (int i = 0; i < selected_node->command->num_params; i++) {
+				if (selected_node->command->params[i].type == PARAM_TYPE_BOOL) {
+					selected_node->command->params[i].value.b_val = selected_node->toggle_state;
+					break;
+				}
+			}
+		}
 	}
 }
 
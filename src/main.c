@@ -1,6 +1,7 @@
 #include "app_state.h"
 #include "graph/graph_actions.h"
 #include "graph/graph_io.h"
+#include "graph/graph_rng.h"
 #include "interaction/camera.h"
 #include "interaction/input.h"
 #include "interaction/state.h"
@@ -27,14 +28,17 @@ int main(int argc, char **argv)
 {
 	// Parse command line arguments
 	int opt;
-	static struct option long_options[] = {{"layout", 1, 0, 'l'}, {"node-attr", 1, 0, 1}, {"edge-attr", 1, 0, 2}, {0, 0, 0, 0}};
+	static struct option long_options[] = {{"layout", 1, 0, 'l'}, {"node-attr", 1, 0, 1}, {"edge-attr", 1, 0, 2}, {"seed", 1, 0, 3}, {"layout-budget", 1, 0, 4}, {"initial", 1, 0, 5}, {"remove-overlaps", 0, 0, 6}, {0, 0, 0, 0}};
 
 	AppState app = {0};
+	uint64_t seed = graph_rng_get_seed();
+	float layout_budget_ms = LAYOUT_FRAME_BUDGET_MS;
 
 	// Set defaults
 	app.current_layout = LAYOUT_OPENORD_3D;
 	app.current_cluster = CLUSTER_FASTGREEDY;
 	app.current_comm_arrangement = COMMUNITY_ARRANGEMENT_NONE;
+	app.initial_layout = INITIAL_LAYOUT_DEFAULT;
 	app.last_picked_node = -1;
 	app.last_picked_edge = -1;
 	app.win_w = 3440;
@@ -49,6 +53,12 @@ int main(int argc, char **argv)
 				app.current_layout = LAYOUT_KK_3D;
 			else if (strcmp(optarg, "umap") == 0)
 				app.current_layout = LAYOUT_UMAP_3D;
+			else if (strcmp(optarg, "bh") == 0)
+				app.current_layout = LAYOUT_BARNES_HUT_3D;
+			else if (strcmp(optarg, "gpu") == 0)
+				app.current_layout = LAYOUT_GPU_FORCE_3D;
+			else if (strcmp(optarg, "layered") == 0)
+				app.current_layout = LAYOUT_LAYERED_SPHERE_3D;
 			break;
 		case 1:
 			app.node_attr = optarg;
@@ -56,22 +66,39 @@ int main(int argc, char **argv)
 		case 2:
 			app.edge_attr = optarg;
 			break;
+		case 3:
+			seed = strtoull(optarg, NULL, 10);
+			break;
+		case 4:
+			layout_budget_ms = strtof(optarg, NULL);
+			break;
+		case 5:
+			if (strcmp(optarg, "hde") == 0)
+				app.initial_layout = INITIAL_LAYOUT_HDE;
+			else if (strcmp(optarg, "spectral") == 0)
+				app.initial_layout = INITIAL_LAYOUT_SPECTRAL;
+			break;
+		case 6:
+			app.remove_overlaps = true;
+			break;
 		}
 	}
 
 	if (optind >= argc) {
 		fprintf(stderr,
-				"Usage: %s [--layout <fr|kk|umap>] [--node-attr <attr>] "
-				"[--edge-attr <attr>] <graph.graphml>\n",
+				"Usage: %s [--layout <fr|kk|umap|bh|gpu|layered>] [--node-attr <attr>] "
+				"[--edge-attr <attr>] [--seed <n>] [--layout-budget <ms>] "
+				"[--initial <hde|spectral>] [--remove-overlaps] <graph.graphml>\n",
 				argv[0]);
 		return EXIT_FAILURE;
 	}
 
 	app.current_filename = argv[optind];
+	graph_rng_set_seed(seed);
 
 	// Initialize graph data
 	app.current_graph.graph_initialized = false;
-	if (graph_load_graphml(app.current_filename, &app.current_graph, app.current_layout, app.node_attr, app.edge_attr) != 0) {
+	if (graph_load_graphml(app.current_filename, &app.current_graph, app.current_layout, app.initial_layout, app.node_attr, app.edge_attr) != 0) {
 		fprintf(stderr, "Failed to load graph: %s\n", app.current_filename);
 		return EXIT_FAILURE;
 	}
@@ -132,6 +159,9 @@ int main(int argc, char **argv)
 		glfwTerminate();
 		return EXIT_FAILURE;
 	}
+	layout_scheduler_init(&app.layout_scheduler, layout_budget_ms);
+	if (layout_thread_init(&app.layout_thread) != 0)
+		fprintf(stderr, "Failed to start layout thread, iterative layouts run on the main thread\n");
 	app.current_worker_job = NULL;
 	app.job_in_progress = false;
 	app.job_progress = 0.0f;
@@ -193,6 +223,7 @@ int main(int argc, char **argv)
 	}
 
 	// Cleanup
+	layout_thread_cleanup(&app.layout_thread);
 	worker_thread_cleanup(&app.worker_ctx);
 	app_context_destroy(&app.app_ctx);
 	destroy_menu_tree(root_menu);
@@ -1,5 +1,9 @@
 #include "ui/hud.h"
+#include "graph/layered_sphere.h"
+#include "graph/layout_barnes_hut.h"
 #include "graph/layout_openord.h"
+#include "graph/layout_thread.h"
+#include "vulkan/renderer_density.h"
 #include "vulkan/renderer_ui.h"
 #include <stdio.h>
 #include <string.h>
@@ -7,7 +11,7 @@
 /**
  * Layout type names for UI display.
  */
-static const char *layout_names[] = {"Fruchterman-Reingold", "Kamada-Kawai", "Random", "Sphere", "Grid", "UMAP", "DrL", "OpenOrd"};
+static const char *layout_names[] = {"Fruchterman-Reingold", "Kamada-Kawai", "Random", "Sphere", "Grid", "UMAP", "DrL", "OpenOrd", "Barnes-Hut", "GPU Force", "Layered Sphere"};
 
 /**
  * Cluster algorithm names for UI display.
@@ -19,6 +23,11 @@ static const char *cluster_names[] = {"Fast Greedy", "Walktrap", "Label Propagat
  */
 static const char *comm_arrangement_names[] = {"None", "Kececi 2D", "Kececi Tetra 3D", "Compact Ortho 2D", "Compact Ortho 3D"};
 
+/**
+ * Density overview mode names for UI display.
+ */
+static const char *density_mode_names[] = {"AUTO", "OFF", "ON"};
+
 void ui_hud_init(void)
 {
 	// No initialization needed currently
@@ -30,7 +39,46 @@ void ui_hud_update(AppState *state, float fps)
 
 	// Get stage info for OpenOrd layout
 	if (state->current_layout == LAYOUT_OPENORD_3D && state->current_graph.openord) {
-		snprintf(stage_info, sizeof(stage_info), " [%s:%d]", openord_get_stage_name(state->current_graph.openord->stage_id), state->current_graph.openord->current_iter);
+		OpenOrdContext *openord = state->current_graph.openord;
+		LayoutThread *lt = &state->layout_thread;
+		// While the layout thread owns the context, read the progress it publishes
+		bool busy = layout_thread_is_busy(lt) && lt->layout == LAYOUT_OPENORD_3D;
+		int stage_id = busy ? atomic_load_explicit(&lt->stage_id, memory_order_relaxed) : openord->stage_id;
+		int current_iter = busy ? atomic_load_explicit(&lt->current_iter, memory_order_relaxed) : openord->current_iter;
+		int level = busy ? atomic_load_explicit(&lt->level, memory_order_relaxed) : openord->level;
+		char level_info[16] = "";
+		if (openord->level_count > 1)
+			snprintf(level_info, sizeof(level_info), " L%d", level);
+		// Scheduler choice: inline iterations per frame, or the background thread
+		char sched_info[16] = "";
+		if (busy)
+			strcpy(sched_info, " BG");
+		else if (stage_id < 5)
+			snprintf(sched_info, sizeof(sched_info), " %dit/f", state->layout_scheduler.iterations_per_frame);
+		snprintf(stage_info, sizeof(stage_info), " [%s:%d%s%s]", openord_get_stage_name(stage_id), current_iter, level_info, sched_info);
+	} else if (state->current_layout == LAYOUT_BARNES_HUT_3D && state->current_graph.barnes_hut) {
+		BarnesHutContext *bh = state->current_graph.barnes_hut;
+		LayoutThread *lt = &state->layout_thread;
+		bool busy = layout_thread_is_busy(lt) && lt->layout == LAYOUT_BARNES_HUT_3D;
+		int iteration = busy ? atomic_load_explicit(&lt->current_iter, memory_order_relaxed) : bh->iteration;
+		char sched_info[16] = "";
+		if (busy)
+			strcpy(sched_info, " BG");
+		else if (iteration < bh->max_iterations)
+			snprintf(sched_info, sizeof(sched_info), " %dit/f", state->layout_scheduler.iterations_per_frame);
+		snprintf(stage_info, sizeof(stage_info), " [%d/%d%s]", iteration, bh->max_iterations, sched_info);
+	} else if (state->current_layout == LAYOUT_LAYERED_SPHERE_3D && state->current_graph.layered_sphere_run) {
+		LayoutThread *lt = &state->layout_thread;
+		bool busy = layout_thread_is_busy(lt) && lt->layout == LAYOUT_LAYERED_SPHERE_3D;
+		int iteration = busy ? atomic_load_explicit(&lt->current_iter, memory_order_relaxed) : layered_sphere_run_iteration(&state->current_graph);
+		char sched_info[16] = "";
+		if (busy)
+			strcpy(sched_info, " BG");
+		else if (layered_sphere_unfinished(&state->current_graph))
+			snprintf(sched_info, sizeof(sched_info), " %dit/f", state->layout_scheduler.iterations_per_frame);
+		snprintf(stage_info, sizeof(stage_info), " [pass %d%s]", iteration, sched_info);
+	} else if (state->current_layout == LAYOUT_GPU_FORCE_3D && state->renderer.forceRunning) {
+		snprintf(stage_info, sizeof(stage_info), " [GPU:%d/%d]", state->renderer.forceIteration, FORCE_LAYOUT_ITERATIONS);
 	}
 
 	char buf[1024];
@@ -49,9 +97,9 @@ void ui_hud_update(AppState *state, float fps)
 
 	snprintf(buf, sizeof(buf),
 			 "[L]ayout:%s%s [Y]SubGraph:%s [I]terate [C]ommunity:%s "
-			 "[T]ext:%s [N]ode:%d [E]dge:%d Filter:1-9 [K]Core:%d "
+			 "[T]ext:%s [O]utline:%s [G]Density:%s%s [V]EdgeLOD:%s:%d%% [Z]oomAgg:%s:%d%% [N]ode:%d [E]dge:%d Filter:1-9 [K]Core:%d "
 			 "[R]eset [H]ide FPS:%.1f%s",
-			 layout_names[state->current_layout], stage_info, comm_arrangement_names[state->current_comm_arrangement], cluster_names[state->current_cluster], state->renderer.showLabels ? "ON" : "OFF", state->current_graph.props.node_count, state->current_graph.props.edge_count, state->current_graph.props.coreness_filter, fps, menu_state);
+			 layout_names[state->current_layout], stage_info, comm_arrangement_names[state->current_comm_arrangement], cluster_names[state->current_cluster], state->renderer.showLabels ? "ON" : "OFF", state->renderer.singlePassNodes ? "1-PASS" : "2-PASS", density_mode_names[state->renderer.densityMode], renderer_density_active(&state->renderer) ? "*" : "", state->renderer.edgeLod ? "ON" : "OFF", (int)(100 * state->renderer.edgeLodLevel / EDGE_LOD_BUCKETS), state->renderer.semanticZoom ? "ON" : "OFF", (int)(100.0f * state->renderer.aggregateBlend), state->current_graph.props.node_count, state->current_graph.props.edge_count, state->current_graph.props.coreness_filter, fps, menu_state);
 
 	renderer_update_ui(&state->renderer, buf);
 }
@@ -109,12 +109,26 @@ void init_menu_tree(MenuNode *root)
 		}
 
 		MenuNode *leaf = create_menu_node(cmd_def->display_name, NODE_LEAF_COMMAND);
-		leaf->command = create_command(cmd_def->command_id, cmd_def->display_name, NULL, 0);
+		leaf->command = create_command(cmd_def->command_id, cmd_def->display_name, NULL, cmd_def->seedable ? 1 : 0);
 		leaf->command->cmd_def = cmd_def;
 
 		current_parent->children = (MenuNode **)realloc(current_parent->children, sizeof(MenuNode *) * (current_parent->num_children + 1));
 		current_parent->children[current_parent->num_children] = leaf;
 		current_parent->num_children++;
+
+		// Seedable layouts start from the current positions; a toggle below the command forces a cold start
+		if (cmd_def->seedable) {
+			leaf->command->params[0] = (CommandParameter){.name = "Cold Start", .type = PARAM_TYPE_BOOL, .value.b_val = false};
+
+			char toggle_label[256];
+			snprintf(toggle_label, sizeof(toggle_label), "Cold Start: %s", cmd_def->display_name);
+			MenuNode *toggle = create_menu_node(toggle_label, NODE_INPUT_TOGGLE);
+			toggle->command = leaf->command; // Shared, owned by the leaf
+
+			current_parent->children = (MenuNode **)realloc(current_parent->children, sizeof(MenuNode *) * (current_parent->num_children + 1));
+			current_parent->children[current_parent->num_children] = toggle;
+			current_parent->num_children++;
+		}
 	}
 
 	assign_menu_icons(root);
@@ -135,7 +149,7 @@ void destroy_menu_tree(MenuNode *node)
 	if (node->label)
 		free((void *)node->label);
 
-	if (node->command) {
+	if (node->command && node->type == NODE_LEAF_COMMAND) {
 		if (node->command->id_name)
 			free((void *)node->command->id_name);
 		if (node->command->display_name)
@@ -185,6 +199,10 @@ static void calculate_card_dimensions(MenuNode *node)
 				child_w += 0.15f;
 			}
 
+			if (child->type == NODE_INPUT_TOGGLE) {
+				child_w += measure_text_width("[x] ");
+			}
+
 			if (child_w > max_width) {
 				max_width = child_w;
 			}
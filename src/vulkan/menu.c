@@ -3,6 +3,7 @@
 #include "vulkan/text.h"
 #include "vulkan/utils.h"
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -132,6 +133,9 @@ void generate_vulkan_menu_buffers(AppContext *ctx, Renderer *r)
 					input_display[1] = '\0';
 				}
 				display_text = input_display;
+			} else if (current->type == NODE_INPUT_TOGGLE) {
+				snprintf(input_display, sizeof(input_display), "[%c] %s", current->toggle_state ? 'x' : ' ', current->label);
+				display_text = input_display;
 			}
 
 			if (display_text && display_text[0]) {
@@ -17,6 +17,7 @@ static void add_tri(Vertex *vs, uint32_t *is, int *v, vec3 p1, vec3 p2, vec3 p3)
 	glm_vec3_cross(e1, e2, n);
 	glm_vec3_normalize(n);
 
+	// Vertices are never shared, so shader.vert derives barycentrics from gl_VertexIndex % 3
 	for (int i = 0; i < 3; i++) {
 		memcpy(vs[*v + i].normal, n, 12);
 		vs[*v + i].texCoord[0] = 0;
@@ -105,3 +106,93 @@ void polyhedron_generate_platonic(PlatonicType type, Vertex **vertices, uint32_t
 		break;
 	}
 }
+
+// Midpoint lookup for icosphere subdivision; open addressing keyed on the sorted edge
+typedef struct
+{
+	uint64_t key;
+	uint32_t index;
+} EdgeMidpoint;
+
+static uint32_t icosphere_midpoint(EdgeMidpoint *table, uint32_t table_size, vec3 *pos, uint32_t *pos_count, uint32_t a, uint32_t b)
+{
+	uint64_t lo = a < b ? a : b;
+	uint64_t hi = a < b ? b : a;
+	uint64_t key = (lo << 32) | hi;
+	uint32_t slot = (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (table_size - 1);
+	while (table[slot].key != UINT64_MAX) {
+		if (table[slot].key == key)
+			return table[slot].index;
+		slot = (slot + 1) & (table_size - 1);
+	}
+	uint32_t idx = (*pos_count)++;
+	glm_vec3_add(pos[a], pos[b], pos[idx]);
+	glm_vec3_normalize(pos[idx]);
+	table[slot].key = key;
+	table[slot].index = idx;
+	return idx;
+}
+
+void polyhedron_generate_icosphere(int subdivisions, Vertex **vertices, uint32_t *vertexCount, uint32_t **indices, uint32_t *indexCount)
+{
+	float phi = (1.0f + sqrtf(5.0f)) / 2.0f;
+	vec3 base[12] = {{0, 1, phi}, {0, 1, -phi}, {0, -1, phi}, {0, -1, -phi}, {1, phi, 0}, {1, -phi, 0}, {-1, phi, 0}, {-1, -phi, 0}, {phi, 0, 1}, {-phi, 0, 1}, {phi, 0, -1}, {-phi, 0, -1}};
+	uint32_t faces[20][3] = {{0, 4, 1}, {0, 9, 4}, {9, 5, 4}, {4, 5, 8}, {4, 8, 1}, {8, 10, 1}, {8, 3, 10}, {5, 3, 8}, {5, 2, 3}, {2, 7, 3}, {7, 10, 3}, {7, 6, 10}, {7, 11, 6}, {11, 0, 6}, {0, 1, 6}, {6, 1, 10}, {9, 0, 11}, {9, 11, 2}, {9, 2, 5}, {7, 2, 11}};
+
+	if (subdivisions < 0)
+		subdivisions = 0;
+
+	// Each level quadruples the faces: F = 20 * 4^s, V = 10 * 4^s + 2
+	uint32_t max_faces = 20u << (2 * subdivisions);
+	uint32_t max_verts = 10u * (1u << (2 * subdivisions)) + 2u;
+
+	vec3 *pos = malloc(sizeof(vec3) * max_verts);
+	uint32_t *tris = malloc(sizeof(uint32_t) * 3 * max_faces);
+	uint32_t *next = malloc(sizeof(uint32_t) * 3 * max_faces);
+	uint32_t pos_count = 12;
+	uint32_t face_count = 20;
+
+	for (int i = 0; i < 12; i++)
+		glm_vec3_normalize_to(base[i], pos[i]);
+	memcpy(tris, faces, sizeof(faces));
+
+	uint32_t table_size = 1;
+	while (table_size < max_faces * 2)
+		table_size <<= 1;
+	EdgeMidpoint *table = malloc(sizeof(EdgeMidpoint) * table_size);
+
+	for (int s = 0; s < subdivisions; s++) {
+		memset(table, 0xFF, sizeof(EdgeMidpoint) * table_size);
+		for (uint32_t f = 0; f < face_count; f++) {
+			uint32_t a = tris[f * 3 + 0], b = tris[f * 3 + 1], c = tris[f * 3 + 2];
+			uint32_t ab = icosphere_midpoint(table, table_size, pos, &pos_count, a, b);
+			uint32_t bc = icosphere_midpoint(table, table_size, pos, &pos_count, b, c);
+			uint32_t ca = icosphere_midpoint(table, table_size, pos, &pos_count, c, a);
+			uint32_t *o = &next[f * 12];
+			o[0] = a, o[1] = ab, o[2] = ca;
+			o[3] = b, o[4] = bc, o[5] = ab;
+			o[6] = c, o[7] = ca, o[8] = bc;
+			o[9] = ab, o[10] = bc, o[11] = ca;
+		}
+		face_count *= 4;
+		uint32_t *tmp = tris;
+		tris = next;
+		next = tmp;
+	}
+
+	// Shared vertices: on a unit sphere the smooth normal is the position itself
+	*vertexCount = pos_count;
+	*vertices = calloc(pos_count, sizeof(Vertex));
+	for (uint32_t i = 0; i < pos_count; i++) {
+		memcpy((*vertices)[i].pos, pos[i], 12);
+		memcpy((*vertices)[i].normal, pos[i], 12);
+	}
+	*indexCount = face_count * 3;
+	*indices = malloc(sizeof(uint32_t) * face_count * 3);
+	memcpy(*indices, tris, sizeof(uint32_t) * face_count * 3);
+
+	free(table);
+	free(next);
+	free(tris);
+	free(pos);
+}
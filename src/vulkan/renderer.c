@@ -1,10 +1,15 @@
 #include "vulkan/renderer.h"
 
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "interaction/state.h"
+#include "vulkan/renderer_density.h"
+#include "vulkan/renderer_edge_lod.h"
+#include "vulkan/renderer_force.h"
 #include "vulkan/renderer_geometry.h"
 #include "vulkan/renderer_pipelines.h"
 #include "vulkan/text.h"
@@ -29,12 +34,22 @@ int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph)
 	r->showUI = true;
 	r->showSpheres = true;
 	r->layoutScale = 1.0f;
+	r->singlePassNodes = true;
+	r->edgeLod = true;
+	r->semanticZoom = true;
+	r->cameraMoving = false;
+	r->edgeLodMovingLevel = EDGE_LOD_BUCKETS / 10;
+	r->edgeLodRefineStep = EDGE_LOD_BUCKETS / 16;
+	r->edgeLodLevel = EDGE_LOD_BUCKETS;
 	r->numSpheres = 0;
-	r->sphereIndexCounts = NULL;
-	r->sphereIndexOffsets = NULL;
+	r->sphereInstances = NULL;
+	r->sphereInstanceCapacity = 0;
 	r->currentRoutingMode = ROUTING_MODE_SPHERICAL_PCB;
 	r->sphereVertexBuffer = VK_NULL_HANDLE;
 	r->sphereIndexBuffer = VK_NULL_HANDLE;
+	r->sphereInstanceBuffer = VK_NULL_HANDLE;
+	r->densityDescriptorSet = VK_NULL_HANDLE;
+	r->edgeCompositeDescriptorSet = VK_NULL_HANDLE;
 
 	// Get actual window size for swapchain
 	int width, height;
@@ -92,7 +107,7 @@ int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph)
 	VkPushConstantRange pushConstantRange = {
 		.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
 		.offset = 0,
-		.size = sizeof(float) // For alpha value
+		.size = sizeof(float) * 2 // alpha value + node wireframe flag
 	};
 
 	VkPipelineLayoutCreateInfo plyLayInfo = {.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, .setLayoutCount = 1, .pSetLayouts = &r->descriptorSetLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pushConstantRange};
@@ -142,6 +157,9 @@ int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph)
 
 	// Call out to the newly split pipelines file
 	renderer_create_pipelines(r);
+	renderer_density_init(r);
+	renderer_edge_lod_init(r);
+	renderer_force_init(r);
 
 	r->framebuffers = malloc(sizeof(VkFramebuffer) * r->swapchainImageCount);
 	for (uint32_t i = 0; i < r->swapchainImageCount; i++) {
@@ -162,6 +180,36 @@ int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph)
 		free(idx);
 	}
 
+	// Shared unit icosphere for the layered sphere shells, all LODs in one vertex/index buffer
+	{
+		static const int lodSubdivisions[SPHERE_LOD_COUNT] = {1, 2, 4};
+		Vertex *lodVerts[SPHERE_LOD_COUNT];
+		uint32_t *lodIdx[SPHERE_LOD_COUNT];
+		uint32_t lodVc[SPHERE_LOD_COUNT];
+		uint32_t totalVerts = 0, totalIdx = 0;
+		for (int l = 0; l < SPHERE_LOD_COUNT; l++) {
+			polyhedron_generate_icosphere(lodSubdivisions[l], &lodVerts[l], &lodVc[l], &lodIdx[l], &r->sphereLodIndexCounts[l]);
+			r->sphereLodVertexOffset[l] = (int32_t)totalVerts;
+			r->sphereLodFirstIndex[l] = totalIdx;
+			totalVerts += lodVc[l];
+			totalIdx += r->sphereLodIndexCounts[l];
+		}
+		Vertex *allVerts = malloc(sizeof(Vertex) * totalVerts);
+		uint32_t *allIdx = malloc(sizeof(uint32_t) * totalIdx);
+		for (int l = 0; l < SPHERE_LOD_COUNT; l++) {
+			memcpy(allVerts + r->sphereLodVertexOffset[l], lodVerts[l], sizeof(Vertex) * lodVc[l]);
+			memcpy(allIdx + r->sphereLodFirstIndex[l], lodIdx[l], sizeof(uint32_t) * r->sphereLodIndexCounts[l]);
+			free(lodVerts[l]);
+			free(lodIdx[l]);
+		}
+		createBuffer(r->device, r->physicalDevice, sizeof(Vertex) * totalVerts, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->sphereVertexBuffer, &r->sphereVertexBufferMemory);
+		updateBuffer(r->device, r->sphereVertexBufferMemory, sizeof(Vertex) * totalVerts, allVerts);
+		createBuffer(r->device, r->physicalDevice, sizeof(uint32_t) * totalIdx, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->sphereIndexBuffer, &r->sphereIndexBufferMemory);
+		updateBuffer(r->device, r->sphereIndexBufferMemory, sizeof(uint32_t) * totalIdx, allIdx);
+		free(allVerts);
+		free(allIdx);
+	}
+
 	LabelVertex lvs[] = {{{0, 0, 0}, {0, 0}}, {{1, 0, 0}, {1, 0}}, {{0, 1, 0}, {0, 1}}, {{1, 1, 0}, {1, 1}}};
 	createBuffer(r->device, r->physicalDevice, sizeof(lvs), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->labelVertexBuffer, &r->labelVertexBufferMemory);
 	updateBuffer(r->device, r->labelVertexBufferMemory, sizeof(lvs), lvs);
@@ -265,8 +313,51 @@ int renderer_init(Renderer *r, GLFWwindow *window, GraphData *graph)
 void renderer_update_view(Renderer *r, vec3 pos, vec3 front, vec3 up)
 {
 	vec3 c;
+	mat4 view;
 	glm_vec3_add(pos, front, c);
-	glm_lookat(pos, c, up, r->ubo.view);
+	glm_lookat(pos, c, up, view);
+	r->cameraMoving = memcmp(view, r->ubo.view, sizeof(mat4)) != 0;
+	glm_mat4_copy(view, r->ubo.view);
+}
+
+// Split the radius-sorted sphere instances into LOD ranges by projected screen height
+static void renderer_select_sphere_lods(Renderer *r, uint32_t *lodFirst, uint32_t *lodCount)
+{
+	// Pixel heights above which the next finer LOD is used
+	static const float lodThresholds[SPHERE_LOD_COUNT - 1] = {96.0f, 384.0f};
+
+	mat4 invView;
+	glm_mat4_inv(r->ubo.view, invView);
+	vec3 eye = {invView[3][0], invView[3][1], invView[3][2]};
+	float focal = fabsf(r->ubo.proj[1][1]) * 0.5f * (float)r->swapchainExtent.height;
+
+	int lod = 0;
+	for (uint32_t s = 0; s < r->numSpheres; s++) {
+		const SphereInstance *si = &r->sphereInstances[s];
+		float radius = si->radius * r->layoutScale;
+		vec3 c;
+		glm_vec3_scale((float *)si->center, r->layoutScale, c);
+		float dist = glm_vec3_distance(eye, c) - radius;
+		float pixels = (dist > 0.1f) ? (radius * focal / dist) : FLT_MAX;
+		while (lod < SPHERE_LOD_COUNT - 1 && pixels > lodThresholds[lod])
+			lod++;
+		if (lodCount[lod] == 0)
+			lodFirst[lod] = s;
+		lodCount[lod]++;
+	}
+}
+
+// Cross-fade factor between detail (0) and community aggregate (1) from camera distance
+static float renderer_semantic_zoom_blend(Renderer *r)
+{
+	if (!r->semanticZoom || r->aggregateNodeCount == 0 || r->graphRadius <= 0.0f)
+		return 0.0f;
+	mat4 invView;
+	glm_mat4_inv(r->ubo.view, invView);
+	vec3 eye = {invView[3][0], invView[3][1], invView[3][2]};
+	float radii = glm_vec3_distance(eye, r->graphCenter) / r->graphRadius;
+	float t = glm_clamp((radii - SEMANTIC_ZOOM_NEAR) / (SEMANTIC_ZOOM_FAR - SEMANTIC_ZOOM_NEAR), 0.0f, 1.0f);
+	return t * t * (3.0f - 2.0f * t);
 }
 
 void renderer_draw_frame(Renderer *r)
@@ -282,19 +373,53 @@ void renderer_draw_frame(Renderer *r)
 	vkResetCommandBuffer(r->commandBuffers[r->currentFrame], 0);
 	VkCommandBufferBeginInfo bi = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	vkBeginCommandBuffer(r->commandBuffers[r->currentFrame], &bi);
+	bool densityOverview = renderer_density_active(r);
+	renderer_force_record(r, r->commandBuffers[r->currentFrame]);
+	if (densityOverview)
+		renderer_density_record_splat(r, r->commandBuffers[r->currentFrame]);
+	// Semantic zoom: detail fades out as the aggregate fades in; either side is skipped when invisible
+	float aggregateBlend = densityOverview ? 0.0f : renderer_semantic_zoom_blend(r);
+	bool drawDetail = aggregateBlend < 0.999f;
+	bool drawAggregate = aggregateBlend > 0.001f;
+	r->aggregateBlend = aggregateBlend;
+	bool drawEdges = !densityOverview && drawDetail && r->showEdges && r->edgeCount > 0;
+	// Large edge sets go through the LOD accumulation image, drawing only the buckets it lacks
+	bool edgeLodActive = drawEdges && r->edgeLod && r->edgeCount > EDGE_LOD_MIN_EDGES && r->edgeCompositeDescriptorSet != VK_NULL_HANDLE;
+	if (edgeLodActive) {
+		renderer_edge_lod_record_accumulate(r, r->commandBuffers[r->currentFrame], r->descriptorSets[r->currentFrame]);
+	} else {
+		// The image is not kept up to date with the view meanwhile
+		r->edgeLodLevel = EDGE_LOD_BUCKETS;
+		renderer_edge_lod_invalidate(r);
+	}
 	VkClearValue cv = {{{0.01f, 0.01f, 0.02f, 1.0f}}};
 	VkRenderPassBeginInfo rpi = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO, NULL, r->renderPass, r->framebuffers[ii], {{0, 0}, {3440, 1440}}, 1, &cv};
 	vkCmdBeginRenderPass(r->commandBuffers[r->currentFrame], &rpi, VK_SUBPASS_CONTENTS_INLINE);
 	vkCmdBindDescriptorSets(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipelineLayout, 0, 1, &r->descriptorSets[r->currentFrame], 0, NULL);
-	if (r->showEdges && r->edgeCount > 0) {
+	if (densityOverview) {
+		// Heatmap replaces discrete edges, nodes and labels
+		renderer_density_record_resolve(r, r->commandBuffers[r->currentFrame]);
+		vkCmdBindDescriptorSets(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipelineLayout, 0, 1, &r->descriptorSets[r->currentFrame], 0, NULL);
+	}
+	if (edgeLodActive) {
+		renderer_edge_lod_record_composite(r, r->commandBuffers[r->currentFrame], 1.0f - aggregateBlend);
+		vkCmdBindDescriptorSets(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipelineLayout, 0, 1, &r->descriptorSets[r->currentFrame], 0, NULL);
+	} else if (drawEdges) {
+		float edgeAlpha = EDGE_ALPHA * (1.0f - aggregateBlend);
+		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &edgeAlpha);
 		vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->edgePipeline);
 		VkDeviceSize off = 0;
 		vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 1, &r->edgeVertexBuffer, &off);
 		vkCmdDraw(r->commandBuffers[r->currentFrame], r->edgeVertexCount, 1, 0, 0);
 	}
-	if (r->showNodes && r->nodeCount > 0) {
-		float alpha_face = 0.5f;
-		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &alpha_face);
+	if (!densityOverview && drawDetail && r->showNodes && r->nodeCount > 0) {
+		// Single-pass: faces and shader wireframe together. Two-pass: faces, then polygon-mode outlines.
+		struct
+		{
+			float alpha;
+			float wireframe;
+		} nodePc = {0.5f * (1.0f - aggregateBlend), r->singlePassNodes ? 1.0f : 0.0f};
+		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(nodePc), &nodePc);
 		vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->graphicsPipeline);
 		for (int i = 0; i < PLATONIC_COUNT; i++) {
 			if (r->platonicDrawCalls[i].count == 0)
@@ -306,20 +431,48 @@ void renderer_draw_frame(Renderer *r)
 			vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->platonicIndexCounts[i], r->platonicDrawCalls[i].count, 0, 0, r->platonicDrawCalls[i].firstInstance);
 		}
 
-		float alpha_edge = 1.0f;
-		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &alpha_edge);
-		vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->nodeEdgePipeline);
-		for (int i = 0; i < PLATONIC_COUNT; i++) {
-			if (r->platonicDrawCalls[i].count == 0)
-				continue;
-			VkBuffer vbs[] = {r->vertexBuffers[i], r->instanceBuffer};
+		if (!r->singlePassNodes) {
+			nodePc.alpha = 1.0f - aggregateBlend;
+			nodePc.wireframe = 0.0f;
+			vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(nodePc), &nodePc);
+			vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->nodeEdgePipeline);
+			for (int i = 0; i < PLATONIC_COUNT; i++) {
+				if (r->platonicDrawCalls[i].count == 0)
+					continue;
+				VkBuffer vbs[] = {r->vertexBuffers[i], r->instanceBuffer};
+				VkDeviceSize vos[] = {0, 0};
+				vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 2, vbs, vos);
+				vkCmdBindIndexBuffer(r->commandBuffers[r->currentFrame], r->indexBuffers[i], 0, VK_INDEX_TYPE_UINT32);
+				vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->platonicIndexCounts[i], r->platonicDrawCalls[i].count, 0, 0, r->platonicDrawCalls[i].firstInstance);
+			}
+		}
+	}
+	if (drawAggregate) {
+		float aggregateEdgeAlpha = EDGE_ALPHA * aggregateBlend;
+		if (r->showEdges && r->aggregateEdgeVertexCount > 0) {
+			vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &aggregateEdgeAlpha);
+			vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->edgePipeline);
+			VkDeviceSize off = 0;
+			vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 1, &r->aggregateEdgeBuffer, &off);
+			vkCmdDraw(r->commandBuffers[r->currentFrame], r->aggregateEdgeVertexCount, 1, 0, 0);
+		}
+		if (r->showNodes) {
+			struct
+			{
+				float alpha;
+				float wireframe;
+			} metaPc = {0.5f * aggregateBlend, 1.0f};
+			vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(metaPc), &metaPc);
+			vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->graphicsPipeline);
+			VkBuffer vbs[] = {r->vertexBuffers[PLATONIC_ICOSAHEDRON], r->aggregateNodeBuffer};
 			VkDeviceSize vos[] = {0, 0};
 			vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 2, vbs, vos);
-			vkCmdBindIndexBuffer(r->commandBuffers[r->currentFrame], r->indexBuffers[i], 0, VK_INDEX_TYPE_UINT32);
-			vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->platonicIndexCounts[i], r->platonicDrawCalls[i].count, 0, 0, r->platonicDrawCalls[i].firstInstance);
+			vkCmdBindIndexBuffer(r->commandBuffers[r->currentFrame], r->indexBuffers[PLATONIC_ICOSAHEDRON], 0, VK_INDEX_TYPE_UINT32);
+			vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->platonicIndexCounts[PLATONIC_ICOSAHEDRON], r->aggregateNodeCount, 0, 0, 0);
 		}
 	}
-	if (r->showLabels && r->labelCharCount > 0 && r->labelInstanceBuffer != VK_NULL_HANDLE) {
+	// Labels have no alpha; they follow whichever side of the cross-fade dominates
+	if (!densityOverview && aggregateBlend < 0.5f && r->showLabels && r->labelCharCount > 0 && r->labelInstanceBuffer != VK_NULL_HANDLE) {
 		vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->labelPipeline);
 		VkBuffer lbs[] = {r->labelVertexBuffer, r->labelInstanceBuffer};
 		VkDeviceSize los[] = {0, 0};
@@ -366,20 +519,24 @@ void renderer_draw_frame(Renderer *r)
 	}
 
 	// Draw Transparent Spheres (Last for blending)
-	if (r->showSpheres && r->numSpheres > 0 && r->sphereVertexBuffer != VK_NULL_HANDLE) {
-		float alpha_sphere = 0.2f / (float)r->numSpheres; // Scale transparency
-		if (alpha_sphere < 0.02f)
-			alpha_sphere = 0.02f;
-
-		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &alpha_sphere);
+	// Instances are sorted by radius, so each LOD covers a contiguous instance range
+	if (r->showSpheres && r->numSpheres > 0 && r->sphereInstanceBuffer != VK_NULL_HANDLE) {
+		uint32_t lodFirst[SPHERE_LOD_COUNT] = {0};
+		uint32_t lodCount[SPHERE_LOD_COUNT] = {0};
+		renderer_select_sphere_lods(r, lodFirst, lodCount);
+
+		float scale = r->layoutScale;
+		vkCmdPushConstants(r->commandBuffers[r->currentFrame], r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &scale);
 		vkCmdBindPipeline(r->commandBuffers[r->currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS, r->spherePipeline);
-		VkBuffer vbs[] = {r->sphereVertexBuffer};
-		VkDeviceSize vos[] = {0};
-		vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 1, vbs, vos);
+		VkBuffer vbs[] = {r->sphereVertexBuffer, r->sphereInstanceBuffer};
+		VkDeviceSize vos[] = {0, 0};
+		vkCmdBindVertexBuffers(r->commandBuffers[r->currentFrame], 0, 2, vbs, vos);
 		vkCmdBindIndexBuffer(r->commandBuffers[r->currentFrame], r->sphereIndexBuffer, 0, VK_INDEX_TYPE_UINT32);
 
-		for (int s = 0; s < r->numSpheres; s++) {
-			vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->sphereIndexCounts[s], 1, r->sphereIndexOffsets[s], 0, 0);
+		for (int l = 0; l < SPHERE_LOD_COUNT; l++) {
+			if (lodCount[l] == 0)
+				continue;
+			vkCmdDrawIndexed(r->commandBuffers[r->currentFrame], r->sphereLodIndexCounts[l], lodCount[l], r->sphereLodFirstIndex[l], r->sphereLodVertexOffset[l], lodFirst[l]);
 		}
 	}
 
@@ -427,6 +584,14 @@ void renderer_cleanup(Renderer *r)
 	vkFreeMemory(r->device, r->edgeVertexBufferMemory, NULL);
 	vkDestroyBuffer(r->device, r->instanceBuffer, NULL);
 	vkFreeMemory(r->device, r->instanceBufferMemory, NULL);
+	if (r->aggregateNodeBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->aggregateNodeBuffer, NULL);
+		vkFreeMemory(r->device, r->aggregateNodeBufferMemory, NULL);
+	}
+	if (r->aggregateEdgeBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->aggregateEdgeBuffer, NULL);
+		vkFreeMemory(r->device, r->aggregateEdgeBufferMemory, NULL);
+	}
 	for (int i = 0; i < PLATONIC_COUNT; i++) {
 		vkDestroyBuffer(r->device, r->vertexBuffers[i], NULL);
 		vkFreeMemory(r->device, r->vertexBufferMemories[i], NULL);
@@ -481,6 +646,25 @@ void renderer_cleanup(Renderer *r)
 		vkFreeMemory(r->device, r->numericInstanceBufferMemory, NULL);
 	}
 
+	// Cleanup layered sphere buffers
+	if (r->sphereVertexBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->sphereVertexBuffer, NULL);
+		vkFreeMemory(r->device, r->sphereVertexBufferMemory, NULL);
+	}
+	if (r->sphereIndexBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->sphereIndexBuffer, NULL);
+		vkFreeMemory(r->device, r->sphereIndexBufferMemory, NULL);
+	}
+	if (r->sphereInstanceBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->sphereInstanceBuffer, NULL);
+		vkFreeMemory(r->device, r->sphereInstanceBufferMemory, NULL);
+	}
+	free(r->sphereInstances);
+
+	renderer_density_cleanup(r);
+	renderer_edge_lod_cleanup(r);
+	renderer_force_cleanup(r);
+
 	vkDestroyCommandPool(r->device, r->commandPool, NULL);
 	vkDestroyDescriptorPool(r->device, r->descriptorPool, NULL);
 	vkDestroySampler(r->device, r->textureSampler, NULL);
@@ -496,7 +680,9 @@ void renderer_cleanup(Renderer *r)
 	vkDestroyDescriptorSetLayout(r->device, r->computeDescriptorSetLayout, NULL);
 	vkDestroyPipeline(r->device, r->uiPipeline, NULL);
 	vkDestroyPipeline(r->device, r->labelPipeline, NULL);
+	vkDestroyPipeline(r->device, r->edgeAccumPipeline, NULL);
 	vkDestroyPipeline(r->device, r->edgePipeline, NULL);
+	vkDestroyPipeline(r->device, r->spherePipeline, NULL);
 	vkDestroyPipeline(r->device, r->nodeEdgePipeline, NULL);
 	vkDestroyPipeline(r->device, r->graphicsPipeline, NULL);
 	vkDestroyPipelineLayout(r->device, r->pipelineLayout, NULL);
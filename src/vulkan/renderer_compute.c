@@ -11,6 +11,10 @@ VkResult renderer_dispatch_edge_routing(Renderer *r, GraphData *graph, CompEdge
 		return VK_SUCCESS;
 	}
 
+	// Hub-spoke routing bundles edges through the graph's hubs (graph_action_update_hubs); until
+	// there are hubs for the current edges it falls back to the spherical route
+	int numHubs = r->currentRoutingMode == ROUTING_MODE_HUB_SPOKE && graph->edge_hubs ? graph->hub_count : 0;
+
 	// Prepare compute shader input data
 	CompNode *cNodes = malloc(sizeof(CompNode) * graph->node_count);
 	CompEdge *cEdges = malloc(sizeof(CompEdge) * graph->edge_count);
@@ -28,7 +32,12 @@ VkResult renderer_dispatch_edge_routing(Renderer *r, GraphData *graph, CompEdge
 		cEdges[i].targetId = graph->edges[i].to;
 		cEdges[i].elevationLevel = 0;
 		cEdges[i].pathLength = 0;
+		cEdges[i].hubId = numHubs > 0 ? graph->edge_hubs[i] : -1;
 	}
+	CompHub *cHubs = malloc(sizeof(CompHub) * (numHubs > 0 ? numHubs : 1));
+	memset(cHubs, 0, sizeof(CompHub) * (numHubs > 0 ? numHubs : 1));
+	for (int h = 0; h < numHubs; h++)
+		glm_vec3_scale(graph->hubs[h].position, r->layoutScale, cHubs[h].position);
 
 	// Create storage buffers for compute shader
 	VkBuffer nBuf, eBuf, hBuf;
@@ -36,11 +45,13 @@ VkResult renderer_dispatch_edge_routing(Renderer *r, GraphData *graph, CompEdge
 
 	createBuffer(r->device, r->physicalDevice, sizeof(CompNode) * graph->node_count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &nBuf, &nMem);
 	createBuffer(r->device, r->physicalDevice, sizeof(CompEdge) * graph->edge_count, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &eBuf, &eMem);
-	createBuffer(r->device, r->physicalDevice, sizeof(CompHub), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &hBuf, &hMem);
+	createBuffer(r->device, r->physicalDevice, sizeof(CompHub) * (numHubs > 0 ? numHubs : 1), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &hBuf, &hMem);
 
-	// Upload node and edge data to GPU
+	// Upload node, edge and hub data to GPU
 	updateBuffer(r->device, nMem, sizeof(CompNode) * graph->node_count, cNodes);
 	updateBuffer(r->device, eMem, sizeof(CompEdge) * graph->edge_count, cEdges);
+	updateBuffer(r->device, hMem, sizeof(CompHub) * (numHubs > 0 ? numHubs : 1), cHubs);
+	free(cHubs);
 
 	// Create transient descriptor pool and set for compute
 	VkDescriptorPoolSize dps = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3};
@@ -93,7 +104,7 @@ VkResult renderer_dispatch_edge_routing(Renderer *r, GraphData *graph, CompEdge
 		int maxE;
 		float baseR;
 		int numHubs;
-	} pcVals = {graph->edge_count, 5.0f * r->layoutScale, 0};
+	} pcVals = {graph->edge_count, 5.0f * r->layoutScale, numHubs};
 	vkCmdPushConstants(cBuf, r->computePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pcVals), &pcVals);
 
 	// Dispatch compute shader
@@ -0,0 +1,158 @@
+#include "vulkan/renderer_density.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "vulkan/utils.h"
+
+// Fixed-point scale for the uint accumulation buffer (portable atomics, no float atomics needed)
+#define DENSITY_FIXED_POINT 256.0f
+
+typedef struct
+{
+	mat4 viewProj;
+	uint32_t width;
+	uint32_t height;
+	uint32_t nodeCount;
+	uint32_t nodeStride; // sizeof(Node) in floats
+	float exposure;
+	float fixedPoint;
+} DensityPushConstants;
+
+void renderer_density_init(Renderer *r)
+{
+	r->densityMode = DENSITY_MODE_AUTO;
+	r->densityExposure = 0.35f;
+	r->densityWidth = r->swapchainExtent.width / DENSITY_DOWNSAMPLE;
+	r->densityHeight = r->swapchainExtent.height / DENSITY_DOWNSAMPLE;
+
+	createBuffer(r->device, r->physicalDevice, sizeof(uint32_t) * r->densityWidth * r->densityHeight, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &r->densityAccumBuffer, &r->densityAccumBufferMemory);
+
+	// Binding 0: node instance buffer, binding 1: accumulation buffer
+	VkDescriptorSetLayoutBinding bindings[] = {{0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, NULL}, {1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, NULL}};
+	VkDescriptorSetLayoutCreateInfo dslInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, .bindingCount = 2, .pBindings = bindings};
+	vkCreateDescriptorSetLayout(r->device, &dslInfo, NULL, &r->densityDescriptorSetLayout);
+
+	VkPushConstantRange pcRange = {.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, .offset = 0, .size = sizeof(DensityPushConstants)};
+	VkPipelineLayoutCreateInfo plInfo = {.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, .setLayoutCount = 1, .pSetLayouts = &r->densityDescriptorSetLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pcRange};
+	vkCreatePipelineLayout(r->device, &plInfo, NULL, &r->densityPipelineLayout);
+
+	VkDescriptorPoolSize dps = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2};
+	VkDescriptorPoolCreateInfo dpInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, .maxSets = 1, .poolSizeCount = 1, .pPoolSizes = &dps};
+	vkCreateDescriptorPool(r->device, &dpInfo, NULL, &r->densityDescriptorPool);
+	VkDescriptorSetAllocateInfo dsAlloc = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, .descriptorPool = r->densityDescriptorPool, .descriptorSetCount = 1, .pSetLayouts = &r->densityDescriptorSetLayout};
+	vkAllocateDescriptorSets(r->device, &dsAlloc, &r->densityDescriptorSet);
+
+	VkDescriptorBufferInfo abi = {r->densityAccumBuffer, 0, VK_WHOLE_SIZE};
+	VkWriteDescriptorSet aw = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, r->densityDescriptorSet, 1, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &abi, NULL};
+	vkUpdateDescriptorSets(r->device, 1, &aw, 0, NULL);
+
+	// --- SPLAT COMPUTE PIPELINE ---
+	VkShaderModule splatMod;
+	create_shader_module(r->device, DENSITY_SPLAT_COMP_SHADER_PATH, &splatMod);
+	VkPipelineShaderStageCreateInfo cStage = {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_COMPUTE_BIT, .module = splatMod, .pName = "main"};
+	VkComputePipelineCreateInfo cpInfo = {.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO, .stage = cStage, .layout = r->densityPipelineLayout};
+	vkCreateComputePipelines(r->device, VK_NULL_HANDLE, 1, &cpInfo, NULL, &r->densitySplatPipeline);
+	vkDestroyShaderModule(r->device, splatMod, NULL);
+
+	// --- RESOLVE (TONE-MAP) PIPELINE ---
+	VkShaderModule rvMod, rfMod;
+	create_shader_module(r->device, DENSITY_RESOLVE_VERT_SHADER_PATH, &rvMod);
+	create_shader_module(r->device, DENSITY_RESOLVE_FRAG_SHADER_PATH, &rfMod);
+	VkPipelineShaderStageCreateInfo stages[] = {{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_VERTEX_BIT, rvMod, "main", NULL}, {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_FRAGMENT_BIT, rfMod, "main", NULL}};
+
+	// Full-screen triangle generated from gl_VertexIndex, no vertex buffers
+	VkPipelineVertexInputStateCreateInfo vi = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+	VkPipelineInputAssemblyStateCreateInfo ia = {.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+	VkViewport vp = {0, 0, (float)r->swapchainExtent.width, (float)r->swapchainExtent.height, 0, 1};
+	VkRect2D sc = {{0, 0}, r->swapchainExtent};
+	VkPipelineViewportStateCreateInfo vpS = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, .viewportCount = 1, .pViewports = &vp, .scissorCount = 1, .pScissors = &sc};
+	VkPipelineRasterizationStateCreateInfo ras = {.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, .polygonMode = VK_POLYGON_MODE_FILL, .lineWidth = 1.0f, .cullMode = VK_CULL_MODE_NONE, .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE};
+	VkPipelineMultisampleStateCreateInfo mul = {.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT};
+	VkPipelineColorBlendAttachmentState colB = {.colorWriteMask = 0xF, .blendEnable = VK_TRUE, .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA, .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, .colorBlendOp = VK_BLEND_OP_ADD, .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE, .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO, .alphaBlendOp = VK_BLEND_OP_ADD};
+	VkPipelineColorBlendStateCreateInfo colS = {.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, .attachmentCount = 1, .pAttachments = &colB};
+	VkGraphicsPipelineCreateInfo gpInfo = {.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, .stageCount = 2, .pStages = stages, .pVertexInputState = &vi, .pInputAssemblyState = &ia, .pViewportState = &vpS, .pRasterizationState = &ras, .pMultisampleState = &mul, .pColorBlendState = &colS, .layout = r->densityPipelineLayout, .renderPass = r->renderPass};
+	vkCreateGraphicsPipelines(r->device, VK_NULL_HANDLE, 1, &gpInfo, NULL, &r->densityResolvePipeline);
+	vkDestroyShaderModule(r->device, rfMod, NULL);
+	vkDestroyShaderModule(r->device, rvMod, NULL);
+
+	renderer_density_bind_nodes(r);
+}
+
+void renderer_density_bind_nodes(Renderer *r)
+{
+	if (r->densityDescriptorSet == VK_NULL_HANDLE || r->instanceBuffer == VK_NULL_HANDLE || r->nodeCount == 0)
+		return;
+	VkDescriptorBufferInfo nbi = {r->instanceBuffer, 0, VK_WHOLE_SIZE};
+	VkWriteDescriptorSet nw = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, r->densityDescriptorSet, 0, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &nbi, NULL};
+	vkUpdateDescriptorSets(r->device, 1, &nw, 0, NULL);
+}
+
+bool renderer_density_active(const Renderer *r)
+{
+	if (r->densityDescriptorSet == VK_NULL_HANDLE || r->nodeCount == 0)
+		return false;
+	if (r->densityMode == DENSITY_MODE_ON)
+		return true;
+	return r->densityMode == DENSITY_MODE_AUTO && r->nodeCount > DENSITY_AUTO_NODE_THRESHOLD;
+}
+
+static void density_fill_push_constants(Renderer *r, DensityPushConstants *pc)
+{
+	mat4 viewModel;
+	glm_mat4_mul(r->ubo.view, r->ubo.model, viewModel);
+	glm_mat4_mul(r->ubo.proj, viewModel, pc->viewProj);
+	pc->width = r->densityWidth;
+	pc->height = r->densityHeight;
+	pc->nodeCount = r->nodeCount;
+	pc->nodeStride = sizeof(Node) / sizeof(float);
+	pc->exposure = r->densityExposure;
+	pc->fixedPoint = DENSITY_FIXED_POINT;
+}
+
+void renderer_density_record_splat(Renderer *r, VkCommandBuffer cmd)
+{
+	DensityPushConstants pc;
+	density_fill_push_constants(r, &pc);
+
+	// The previous frame's resolve may still be reading the buffer
+	VkBufferMemoryBarrier toClear = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, NULL, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, r->densityAccumBuffer, 0, VK_WHOLE_SIZE};
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, NULL, 1, &toClear, 0, NULL);
+	vkCmdFillBuffer(cmd, r->densityAccumBuffer, 0, VK_WHOLE_SIZE, 0);
+
+	VkBufferMemoryBarrier toSplat = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, NULL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, r->densityAccumBuffer, 0, VK_WHOLE_SIZE};
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, NULL, 1, &toSplat, 0, NULL);
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, r->densitySplatPipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, r->densityPipelineLayout, 0, 1, &r->densityDescriptorSet, 0, NULL);
+	vkCmdPushConstants(cmd, r->densityPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pc), &pc);
+	vkCmdDispatch(cmd, (r->nodeCount + 255) / 256, 1, 1);
+
+	VkBufferMemoryBarrier toResolve = {VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER, NULL, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED, r->densityAccumBuffer, 0, VK_WHOLE_SIZE};
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, NULL, 1, &toResolve, 0, NULL);
+}
+
+void renderer_density_record_resolve(Renderer *r, VkCommandBuffer cmd)
+{
+	DensityPushConstants pc;
+	density_fill_push_constants(r, &pc);
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->densityResolvePipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->densityPipelineLayout, 0, 1, &r->densityDescriptorSet, 0, NULL);
+	vkCmdPushConstants(cmd, r->densityPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pc), &pc);
+	vkCmdDraw(cmd, 3, 1, 0, 0);
+}
+
+void renderer_density_cleanup(Renderer *r)
+{
+	if (r->densityDescriptorSet == VK_NULL_HANDLE)
+		return;
+	vkDestroyPipeline(r->device, r->densityResolvePipeline, NULL);
+	vkDestroyPipeline(r->device, r->densitySplatPipeline, NULL);
+	vkDestroyDescriptorPool(r->device, r->densityDescriptorPool, NULL);
+	vkDestroyPipelineLayout(r->device, r->densityPipelineLayout, NULL);
+	vkDestroyDescriptorSetLayout(r->device, r->densityDescriptorSetLayout, NULL);
+	vkDestroyBuffer(r->device, r->densityAccumBuffer, NULL);
+	vkFreeMemory(r->device, r->densityAccumBufferMemory, NULL);
+	r->densityDescriptorSet = VK_NULL_HANDLE;
+}
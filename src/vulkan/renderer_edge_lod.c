@@ -0,0 +1,151 @@
+#include "vulkan/renderer_edge_lod.h"
+
+#include "vulkan/utils.h"
+
+typedef struct
+{
+	float fraction;
+	float fade;
+} EdgeCompositePushConstants;
+
+void renderer_edge_lod_init(Renderer *r)
+{
+	r->edgeAccumLevel = 0;
+
+	// Same format and sample count as the swapchain, so the accumulation pass is compatible
+	// with the main render pass and edgeAccumPipeline works in either
+	createImage(r->device, r->physicalDevice, r->swapchainExtent.width, r->swapchainExtent.height, r->swapchainFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &r->edgeAccumImage, &r->edgeAccumImageMemory);
+	transitionImageLayout(r->device, r->commandPool, r->graphicsQueue, r->edgeAccumImage, r->swapchainFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkImageViewCreateInfo viewInfo = {.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO, .image = r->edgeAccumImage, .viewType = VK_IMAGE_VIEW_TYPE_2D, .format = r->swapchainFormat, .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1}};
+	vkCreateImageView(r->device, &viewInfo, NULL, &r->edgeAccumImageView);
+
+	// The image keeps its contents between frames and rests in the sampled layout;
+	// the composite of the previous frame must finish reading before new edges land
+	VkAttachmentDescription att = {.format = r->swapchainFormat, .samples = VK_SAMPLE_COUNT_1_BIT, .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD, .storeOp = VK_ATTACHMENT_STORE_OP_STORE, .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE, .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE, .initialLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, .finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+	VkAttachmentReference attRef = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+	VkSubpassDescription sub = {.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS, .colorAttachmentCount = 1, .pColorAttachments = &attRef};
+	VkSubpassDependency deps[] = {{VK_SUBPASS_EXTERNAL, 0, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_SHADER_READ_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, 0}, {0, VK_SUBPASS_EXTERNAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, 0}};
+	VkRenderPassCreateInfo rpInfo = {.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO, .attachmentCount = 1, .pAttachments = &att, .subpassCount = 1, .pSubpasses = &sub, .dependencyCount = 2, .pDependencies = deps};
+	vkCreateRenderPass(r->device, &rpInfo, NULL, &r->edgeAccumRenderPass);
+	VkFramebufferCreateInfo fbInfo = {.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO, .renderPass = r->edgeAccumRenderPass, .attachmentCount = 1, .pAttachments = &r->edgeAccumImageView, .width = r->swapchainExtent.width, .height = r->swapchainExtent.height, .layers = 1};
+	vkCreateFramebuffer(r->device, &fbInfo, NULL, &r->edgeAccumFramebuffer);
+
+	// Binding 0: the accumulation image
+	VkDescriptorSetLayoutBinding binding = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, NULL};
+	VkDescriptorSetLayoutCreateInfo dslInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, .bindingCount = 1, .pBindings = &binding};
+	vkCreateDescriptorSetLayout(r->device, &dslInfo, NULL, &r->edgeCompositeDescriptorSetLayout);
+
+	VkPushConstantRange pcRange = {.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT, .offset = 0, .size = sizeof(EdgeCompositePushConstants)};
+	VkPipelineLayoutCreateInfo plInfo = {.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, .setLayoutCount = 1, .pSetLayouts = &r->edgeCompositeDescriptorSetLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pcRange};
+	vkCreatePipelineLayout(r->device, &plInfo, NULL, &r->edgeCompositePipelineLayout);
+
+	VkDescriptorPoolSize dps = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1};
+	VkDescriptorPoolCreateInfo dpInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, .maxSets = 1, .poolSizeCount = 1, .pPoolSizes = &dps};
+	vkCreateDescriptorPool(r->device, &dpInfo, NULL, &r->edgeCompositeDescriptorPool);
+	VkDescriptorSetAllocateInfo dsAlloc = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, .descriptorPool = r->edgeCompositeDescriptorPool, .descriptorSetCount = 1, .pSetLayouts = &r->edgeCompositeDescriptorSetLayout};
+	vkAllocateDescriptorSets(r->device, &dsAlloc, &r->edgeCompositeDescriptorSet);
+
+	VkDescriptorImageInfo ii = {r->textureSampler, r->edgeAccumImageView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+	VkWriteDescriptorSet iw = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, r->edgeCompositeDescriptorSet, 0, 0, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &ii, NULL, NULL};
+	vkUpdateDescriptorSets(r->device, 1, &iw, 0, NULL);
+
+	// --- COMPOSITE PIPELINE ---
+	// Full-screen triangle from the density overview's vertex shader
+	VkShaderModule vMod, fMod;
+	create_shader_module(r->device, DENSITY_RESOLVE_VERT_SHADER_PATH, &vMod);
+	create_shader_module(r->device, EDGE_COMPOSITE_FRAG_SHADER_PATH, &fMod);
+	VkPipelineShaderStageCreateInfo stages[] = {{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_VERTEX_BIT, vMod, "main", NULL}, {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_FRAGMENT_BIT, fMod, "main", NULL}};
+
+	VkPipelineVertexInputStateCreateInfo vi = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+	VkPipelineInputAssemblyStateCreateInfo ia = {.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST};
+	VkViewport vp = {0, 0, (float)r->swapchainExtent.width, (float)r->swapchainExtent.height, 0, 1};
+	VkRect2D sc = {{0, 0}, r->swapchainExtent};
+	VkPipelineViewportStateCreateInfo vpS = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, .viewportCount = 1, .pViewports = &vp, .scissorCount = 1, .pScissors = &sc};
+	VkPipelineRasterizationStateCreateInfo ras = {.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, .polygonMode = VK_POLYGON_MODE_FILL, .lineWidth = 1.0f, .cullMode = VK_CULL_MODE_NONE, .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE};
+	VkPipelineMultisampleStateCreateInfo mul = {.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT};
+	// Premultiplied "over": the same result as blending the edges straight into the frame
+	VkPipelineColorBlendAttachmentState colB = {.colorWriteMask = 0xF, .blendEnable = VK_TRUE, .srcColorBlendFactor = VK_BLEND_FACTOR_ONE, .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, .colorBlendOp = VK_BLEND_OP_ADD, .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE, .dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, .alphaBlendOp = VK_BLEND_OP_ADD};
+	VkPipelineColorBlendStateCreateInfo colS = {.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, .attachmentCount = 1, .pAttachments = &colB};
+	VkGraphicsPipelineCreateInfo gpInfo = {.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, .stageCount = 2, .pStages = stages, .pVertexInputState = &vi, .pInputAssemblyState = &ia, .pViewportState = &vpS, .pRasterizationState = &ras, .pMultisampleState = &mul, .pColorBlendState = &colS, .layout = r->edgeCompositePipelineLayout, .renderPass = r->renderPass};
+	vkCreateGraphicsPipelines(r->device, VK_NULL_HANDLE, 1, &gpInfo, NULL, &r->edgeCompositePipeline);
+	vkDestroyShaderModule(r->device, fMod, NULL);
+	vkDestroyShaderModule(r->device, vMod, NULL);
+}
+
+// Drop to the moving subset on camera motion, refine by a step per still frame
+static void edge_lod_step(Renderer *r)
+{
+	if (r->cameraMoving) {
+		r->edgeLodLevel = r->edgeLodMovingLevel;
+		r->edgeAccumLevel = 0;
+	} else if (r->edgeLodLevel < EDGE_LOD_BUCKETS) {
+		r->edgeLodLevel += r->edgeLodRefineStep;
+	}
+	if (r->edgeLodLevel > EDGE_LOD_BUCKETS)
+		r->edgeLodLevel = EDGE_LOD_BUCKETS;
+	if (r->edgeLodLevel < 1)
+		r->edgeLodLevel = 1;
+}
+
+void renderer_edge_lod_record_accumulate(Renderer *r, VkCommandBuffer cmd, VkDescriptorSet frameSet)
+{
+	edge_lod_step(r);
+	// The GPU force layout moves the edge vertices in place every frame it runs
+	if (r->forceRunning)
+		r->edgeAccumLevel = 0;
+	if (r->edgeAccumLevel >= r->edgeLodLevel)
+		return;
+
+	VkRenderPassBeginInfo rpi = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO, NULL, r->edgeAccumRenderPass, r->edgeAccumFramebuffer, {{0, 0}, r->swapchainExtent}, 0, NULL};
+	vkCmdBeginRenderPass(cmd, &rpi, VK_SUBPASS_CONTENTS_INLINE);
+	if (r->edgeAccumLevel == 0) {
+		VkClearAttachment clear = {VK_IMAGE_ASPECT_COLOR_BIT, 0, {{{0.0f, 0.0f, 0.0f, 0.0f}}}};
+		VkClearRect rect = {{{0, 0}, r->swapchainExtent}, 0, 1};
+		vkCmdClearAttachments(cmd, 1, &clear, 1, &rect);
+	}
+
+	// Buckets are contiguous in the vertex buffer, so the missing ones are a single range
+	uint32_t first = r->edgeLodVertexOffsets[r->edgeAccumLevel];
+	uint32_t count = r->edgeLodVertexOffsets[r->edgeLodLevel] - first;
+	if (count > 0) {
+		float alpha = EDGE_ALPHA;
+		vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->pipelineLayout, 0, 1, &frameSet, 0, NULL);
+		vkCmdPushConstants(cmd, r->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(float), &alpha);
+		vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->edgeAccumPipeline);
+		VkDeviceSize off = 0;
+		vkCmdBindVertexBuffers(cmd, 0, 1, &r->edgeVertexBuffer, &off);
+		vkCmdDraw(cmd, count, 1, first, 0);
+	}
+	vkCmdEndRenderPass(cmd);
+	r->edgeAccumLevel = r->edgeLodLevel;
+}
+
+void renderer_edge_lod_record_composite(Renderer *r, VkCommandBuffer cmd, float fade)
+{
+	EdgeCompositePushConstants pc = {(float)r->edgeLodLevel / (float)EDGE_LOD_BUCKETS, fade};
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->edgeCompositePipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, r->edgeCompositePipelineLayout, 0, 1, &r->edgeCompositeDescriptorSet, 0, NULL);
+	vkCmdPushConstants(cmd, r->edgeCompositePipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pc), &pc);
+	vkCmdDraw(cmd, 3, 1, 0, 0);
+}
+
+void renderer_edge_lod_invalidate(Renderer *r)
+{
+	r->edgeAccumLevel = 0;
+}
+
+void renderer_edge_lod_cleanup(Renderer *r)
+{
+	if (r->edgeCompositeDescriptorSet == VK_NULL_HANDLE)
+		return;
+	vkDestroyPipeline(r->device, r->edgeCompositePipeline, NULL);
+	vkDestroyDescriptorPool(r->device, r->edgeCompositeDescriptorPool, NULL);
+	vkDestroyPipelineLayout(r->device, r->edgeCompositePipelineLayout, NULL);
+	vkDestroyDescriptorSetLayout(r->device, r->edgeCompositeDescriptorSetLayout, NULL);
+	vkDestroyFramebuffer(r->device, r->edgeAccumFramebuffer, NULL);
+	vkDestroyRenderPass(r->device, r->edgeAccumRenderPass, NULL);
+	vkDestroyImageView(r->device, r->edgeAccumImageView, NULL);
+	vkDestroyImage(r->device, r->edgeAccumImage, NULL);
+	vkFreeMemory(r->device, r->edgeAccumImageMemory, NULL);
+	r->edgeCompositeDescriptorSet = VK_NULL_HANDLE;
+}
@@ -0,0 +1,361 @@
+#include "vulkan/renderer_force.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vulkan/renderer_geometry.h"
+#include "vulkan/utils.h"
+
+// Must match the stage defines in force_layout.comp
+enum { FORCE_STAGE_COUNT, FORCE_STAGE_SCAN, FORCE_STAGE_SCATTER, FORCE_STAGE_FORCES, FORCE_STAGE_MOVE, FORCE_STAGE_EDGES };
+
+#define FORCE_BINDING_COUNT 7
+#define FORCE_GRID_CELLS (FORCE_GRID_DIM * FORCE_GRID_DIM * FORCE_GRID_DIM)
+
+// Matches struct ForceNode in force_layout.comp (std430)
+typedef struct
+{
+	vec4 position;
+	vec4 displacement;
+	uint32_t cell;
+	uint32_t rank;
+	uint32_t instance;
+	uint32_t pad;
+} ForceNode;
+
+typedef struct
+{
+	uint32_t stage;
+	uint32_t nodeCount;
+	uint32_t edgeVertexCount;
+	uint32_t gridDim;
+	uint32_t nodeStride;	   // sizeof(Node) in floats
+	uint32_t edgeVertexStride; // sizeof(EdgeVertex) in floats
+	float idealLength;
+	float temperature;
+	float layoutScale;
+} ForcePushConstants;
+
+// Order-preserving int encoding of a float, as decoded by the shader
+static int32_t encode_ordered(float f)
+{
+	int32_t v;
+	memcpy(&v, &f, sizeof(v));
+	return v >= 0 ? v : v ^ 0x7fffffff;
+}
+
+static void destroy_buffer(Renderer *r, VkBuffer *buffer, VkDeviceMemory *memory)
+{
+	if (*buffer == VK_NULL_HANDLE)
+		return;
+	vkDestroyBuffer(r->device, *buffer, NULL);
+	vkFreeMemory(r->device, *memory, NULL);
+	*buffer = VK_NULL_HANDLE;
+}
+
+static void destroy_run_buffers(Renderer *r)
+{
+	destroy_buffer(r, &r->forceNodeBuffer, &r->forceNodeBufferMemory);
+	destroy_buffer(r, &r->forceAdjacencyBuffer, &r->forceAdjacencyBufferMemory);
+	destroy_buffer(r, &r->forceGridBuffer, &r->forceGridBufferMemory);
+	destroy_buffer(r, &r->forceBoundsBuffer, &r->forceBoundsBufferMemory);
+	destroy_buffer(r, &r->forceEdgeVertexNodeBuffer, &r->forceEdgeVertexNodeBufferMemory);
+	r->forceRunning = false;
+	r->forceDirty = false;
+	r->forceNodeCount = 0;
+}
+
+// Destroy whatever part of the pipeline exists; the descriptor set goes with its pool
+static void destroy_pipeline(Renderer *r)
+{
+	if (r->forcePipeline != VK_NULL_HANDLE)
+		vkDestroyPipeline(r->device, r->forcePipeline, NULL);
+	if (r->forceDescriptorPool != VK_NULL_HANDLE)
+		vkDestroyDescriptorPool(r->device, r->forceDescriptorPool, NULL);
+	if (r->forcePipelineLayout != VK_NULL_HANDLE)
+		vkDestroyPipelineLayout(r->device, r->forcePipelineLayout, NULL);
+	if (r->forceDescriptorSetLayout != VK_NULL_HANDLE)
+		vkDestroyDescriptorSetLayout(r->device, r->forceDescriptorSetLayout, NULL);
+	r->forcePipeline = VK_NULL_HANDLE;
+	r->forceDescriptorPool = VK_NULL_HANDLE;
+	r->forcePipelineLayout = VK_NULL_HANDLE;
+	r->forceDescriptorSetLayout = VK_NULL_HANDLE;
+	r->forceDescriptorSet = VK_NULL_HANDLE;
+}
+
+void renderer_force_init(Renderer *r)
+{
+	r->forceRunning = false;
+	r->forceDirty = false;
+	r->forceIteration = 0;
+	r->forceNodeCount = 0;
+	r->forceEdgeVertexCount = 0;
+	r->nodeInstanceSlots = NULL;
+	r->edgeVertexNodes = NULL;
+	r->forceNodeBuffer = VK_NULL_HANDLE;
+	r->forceAdjacencyBuffer = VK_NULL_HANDLE;
+	r->forceGridBuffer = VK_NULL_HANDLE;
+	r->forceBoundsBuffer = VK_NULL_HANDLE;
+	r->forceEdgeVertexNodeBuffer = VK_NULL_HANDLE;
+	r->forcePipeline = VK_NULL_HANDLE;
+	r->forceDescriptorPool = VK_NULL_HANDLE;
+	r->forcePipelineLayout = VK_NULL_HANDLE;
+	r->forceDescriptorSetLayout = VK_NULL_HANDLE;
+	r->forceDescriptorSet = VK_NULL_HANDLE;
+
+	// 0 nodes, 1 adjacency, 2 grid, 3 bounds, 4 node instances, 5 edge vertices, 6 edge vertex -> node
+	VkDescriptorSetLayoutBinding bindings[FORCE_BINDING_COUNT];
+	for (uint32_t b = 0; b < FORCE_BINDING_COUNT; b++)
+		bindings[b] = (VkDescriptorSetLayoutBinding){b, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT, NULL};
+	VkDescriptorSetLayoutCreateInfo dslInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, .bindingCount = FORCE_BINDING_COUNT, .pBindings = bindings};
+	VkResult result = vkCreateDescriptorSetLayout(r->device, &dslInfo, NULL, &r->forceDescriptorSetLayout);
+
+	VkPushConstantRange pcRange = {.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .offset = 0, .size = sizeof(ForcePushConstants)};
+	VkPipelineLayoutCreateInfo plInfo = {.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, .setLayoutCount = 1, .pSetLayouts = &r->forceDescriptorSetLayout, .pushConstantRangeCount = 1, .pPushConstantRanges = &pcRange};
+	if (result == VK_SUCCESS)
+		result = vkCreatePipelineLayout(r->device, &plInfo, NULL, &r->forcePipelineLayout);
+
+	VkDescriptorPoolSize dps = {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, FORCE_BINDING_COUNT};
+	VkDescriptorPoolCreateInfo dpInfo = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, .maxSets = 1, .poolSizeCount = 1, .pPoolSizes = &dps};
+	if (result == VK_SUCCESS)
+		result = vkCreateDescriptorPool(r->device, &dpInfo, NULL, &r->forceDescriptorPool);
+	VkDescriptorSetAllocateInfo dsAlloc = {.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, .descriptorPool = r->forceDescriptorPool, .descriptorSetCount = 1, .pSetLayouts = &r->forceDescriptorSetLayout};
+	if (result == VK_SUCCESS)
+		result = vkAllocateDescriptorSets(r->device, &dsAlloc, &r->forceDescriptorSet);
+
+	VkShaderModule mod = VK_NULL_HANDLE;
+	if (result == VK_SUCCESS)
+		result = create_shader_module(r->device, FORCE_LAYOUT_COMP_SHADER_PATH, &mod);
+	if (result == VK_SUCCESS) {
+		VkPipelineShaderStageCreateInfo cStage = {.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, .stage = VK_SHADER_STAGE_COMPUTE_BIT, .module = mod, .pName = "main"};
+		VkComputePipelineCreateInfo cpInfo = {.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO, .stage = cStage, .layout = r->forcePipelineLayout};
+		result = vkCreateComputePipelines(r->device, VK_NULL_HANDLE, 1, &cpInfo, NULL, &r->forcePipeline);
+		vkDestroyShaderModule(r->device, mod, NULL);
+	}
+
+	// Without the pipeline, renderer_force_start refuses and the layout falls back to the CPU
+	if (result != VK_SUCCESS) {
+		fprintf(stderr, "Failed to create GPU force layout pipeline (%d), using the CPU layout\n", result);
+		destroy_pipeline(r);
+	}
+}
+
+bool renderer_force_start(Renderer *r, GraphData *graph)
+{
+	if (r->forcePipeline == VK_NULL_HANDLE || graph->node_count == 0 || graph->node_count != r->nodeCount || !r->nodeInstanceSlots)
+		return false;
+	vkDeviceWaitIdle(r->device);
+	destroy_run_buffers(r);
+	uint32_t n = graph->node_count;
+
+	ForceNode *nodes = calloc(n, sizeof(ForceNode));
+	float lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+	for (uint32_t i = 0; i < n; i++) {
+		for (int a = 0; a < 3; a++) {
+			nodes[i].position[a] = graph->nodes[i].position[a];
+			lo[a] = fminf(lo[a], graph->nodes[i].position[a]);
+			hi[a] = fmaxf(hi[a], graph->nodes[i].position[a]);
+		}
+		nodes[i].instance = r->nodeInstanceSlots[i];
+	}
+	createBuffer(r->device, r->physicalDevice, sizeof(ForceNode) * n, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->forceNodeBuffer, &r->forceNodeBufferMemory);
+	updateBuffer(r->device, r->forceNodeBufferMemory, sizeof(ForceNode) * n, nodes);
+	free(nodes);
+
+	// CSR adjacency in one buffer: offsets, then neighbors (both directions, self-loops dropped)
+	uint32_t *adjacency = calloc(n + 1 + 2 * (size_t)graph->edge_count, sizeof(uint32_t));
+	for (uint32_t e = 0; e < graph->edge_count; e++) {
+		if (graph->edges[e].from == graph->edges[e].to)
+			continue;
+		adjacency[graph->edges[e].from + 1]++;
+		adjacency[graph->edges[e].to + 1]++;
+	}
+	for (uint32_t i = 0; i < n; i++)
+		adjacency[i + 1] += adjacency[i];
+	uint32_t *fill = malloc(sizeof(uint32_t) * n);
+	memcpy(fill, adjacency, sizeof(uint32_t) * n);
+	uint32_t *neighbors = adjacency + n + 1;
+	for (uint32_t e = 0; e < graph->edge_count; e++) {
+		uint32_t a = graph->edges[e].from, b = graph->edges[e].to;
+		if (a == b)
+			continue;
+		neighbors[fill[a]++] = b;
+		neighbors[fill[b]++] = a;
+	}
+	free(fill);
+	VkDeviceSize adjacencySize = sizeof(uint32_t) * (n + 1 + adjacency[n] + 1);
+	createBuffer(r->device, r->physicalDevice, adjacencySize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->forceAdjacencyBuffer, &r->forceAdjacencyBufferMemory);
+	updateBuffer(r->device, r->forceAdjacencyBufferMemory, sizeof(uint32_t) * (n + 1 + adjacency[n]), adjacency);
+	free(adjacency);
+
+	// Cell counts, cell starts and the sorted node ids only ever live on the GPU
+	createBuffer(r->device, r->physicalDevice, sizeof(uint32_t) * (2 * (VkDeviceSize)FORCE_GRID_CELLS + 1 + n), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &r->forceGridBuffer, &r->forceGridBufferMemory);
+
+	int32_t bounds[12];
+	for (int a = 0; a < 3; a++) {
+		bounds[a] = encode_ordered(lo[a]);
+		bounds[3 + a] = encode_ordered(hi[a]);
+		bounds[6 + a] = INT32_MAX;
+		bounds[9 + a] = INT32_MIN;
+	}
+	createBuffer(r->device, r->physicalDevice, sizeof(bounds), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->forceBoundsBuffer, &r->forceBoundsBufferMemory);
+	updateBuffer(r->device, r->forceBoundsBufferMemory, sizeof(bounds), bounds);
+
+	// Same force model and schedule as the Barnes-Hut engine, scaled to the starting layout
+	float size = fmaxf(fmaxf(hi[0] - lo[0], hi[1] - lo[1]), hi[2] - lo[2]);
+	float k = cbrtf(size * size * size / (float)n);
+	r->forceIdealLength = k > 1e-6f ? k : 1.0f;
+	r->forceStartTemperature = fmaxf(0.1f * size, r->forceIdealLength);
+	r->forceIteration = 0;
+	r->forceNodeCount = n;
+	r->forceRunning = true;
+
+	renderer_force_bind_geometry(r);
+	return true;
+}
+
+void renderer_force_bind_geometry(Renderer *r)
+{
+	if (r->forceNodeBuffer == VK_NULL_HANDLE)
+		return;
+	if (r->forceNodeCount != r->nodeCount || !r->nodeInstanceSlots) {
+		destroy_run_buffers(r);
+		return;
+	}
+
+	// Instances are regrouped by shape on every upload
+	ForceNode *nodes;
+	vkMapMemory(r->device, r->forceNodeBufferMemory, 0, VK_WHOLE_SIZE, 0, (void **)&nodes);
+	for (uint32_t i = 0; i < r->forceNodeCount; i++)
+		nodes[i].instance = r->nodeInstanceSlots[i];
+	vkUnmapMemory(r->device, r->forceNodeBufferMemory);
+
+	destroy_buffer(r, &r->forceEdgeVertexNodeBuffer, &r->forceEdgeVertexNodeBufferMemory);
+	uint32_t mapCount = r->forceEdgeVertexCount > 0 ? r->forceEdgeVertexCount : 1;
+	createBuffer(r->device, r->physicalDevice, sizeof(uint32_t) * mapCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->forceEdgeVertexNodeBuffer, &r->forceEdgeVertexNodeBufferMemory);
+	if (r->forceEdgeVertexCount > 0)
+		updateBuffer(r->device, r->forceEdgeVertexNodeBufferMemory, sizeof(uint32_t) * r->forceEdgeVertexCount, r->edgeVertexNodes);
+
+	// Routed edges keep their baked paths; the map buffer stands in for the edge vertices
+	VkBuffer edgeVertices = r->forceEdgeVertexCount > 0 ? r->edgeVertexBuffer : r->forceEdgeVertexNodeBuffer;
+	VkBuffer buffers[FORCE_BINDING_COUNT] = {r->forceNodeBuffer, r->forceAdjacencyBuffer, r->forceGridBuffer, r->forceBoundsBuffer, r->instanceBuffer, edgeVertices, r->forceEdgeVertexNodeBuffer};
+	VkDescriptorBufferInfo infos[FORCE_BINDING_COUNT];
+	VkWriteDescriptorSet writes[FORCE_BINDING_COUNT];
+	for (uint32_t b = 0; b < FORCE_BINDING_COUNT; b++) {
+		infos[b] = (VkDescriptorBufferInfo){buffers[b], 0, VK_WHOLE_SIZE};
+		writes[b] = (VkWriteDescriptorSet){VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, NULL, r->forceDescriptorSet, b, 0, 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, NULL, &infos[b], NULL};
+	}
+	vkUpdateDescriptorSets(r->device, FORCE_BINDING_COUNT, writes, 0, NULL);
+}
+
+static void force_barrier(VkCommandBuffer cmd, VkPipelineStageFlags src, VkAccessFlags srcAccess, VkPipelineStageFlags dst, VkAccessFlags dstAccess)
+{
+	VkMemoryBarrier b = {VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL, srcAccess, dstAccess};
+	vkCmdPipelineBarrier(cmd, src, dst, 0, 1, &b, 0, NULL, 0, NULL);
+}
+
+static void force_dispatch(Renderer *r, VkCommandBuffer cmd, ForcePushConstants *pc, uint32_t stage, uint32_t groups)
+{
+	pc->stage = stage;
+	vkCmdPushConstants(cmd, r->forcePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(*pc), pc);
+	vkCmdDispatch(cmd, groups, 1, 1);
+}
+
+void renderer_force_record(Renderer *r, VkCommandBuffer cmd)
+{
+	if (!r->forceRunning || r->forcePipeline == VK_NULL_HANDLE)
+		return;
+
+	const VkAccessFlags shaderRW = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+	const VkAccessFlags transferRW = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+	uint32_t nodeGroups = (r->forceNodeCount + 255) / 256;
+	ForcePushConstants pc = {0, r->forceNodeCount, r->forceEdgeVertexCount, FORCE_GRID_DIM, sizeof(Node) / sizeof(float), sizeof(EdgeVertex) / sizeof(float), r->forceIdealLength, 0.0f, r->layoutScale};
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, r->forcePipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, r->forcePipelineLayout, 0, 1, &r->forceDescriptorSet, 0, NULL);
+
+	// Earlier frames may still draw from the instances and edge vertices written below
+	force_barrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, shaderRW | transferRW);
+
+	for (int i = 0; i < FORCE_LAYOUT_ITERATIONS_PER_FRAME && r->forceIteration < FORCE_LAYOUT_ITERATIONS; i++) {
+		// Displacement cap cools linearly over the run
+		pc.temperature = r->forceStartTemperature * (1.0f - (float)r->forceIteration / (float)FORCE_LAYOUT_ITERATIONS);
+
+		vkCmdFillBuffer(cmd, r->forceGridBuffer, 0, sizeof(uint32_t) * FORCE_GRID_CELLS, 0);
+		force_barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW);
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_COUNT, nodeGroups);
+		force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW);
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_SCAN, 1);
+		force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW);
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_SCATTER, nodeGroups);
+		force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW);
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_FORCES, nodeGroups);
+		force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, shaderRW);
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_MOVE, nodeGroups);
+
+		// The bounds gathered by this move become the next iteration's grid; reset the gather
+		force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, transferRW);
+		VkBufferCopy copy = {6 * sizeof(int32_t), 0, 6 * sizeof(int32_t)};
+		vkCmdCopyBuffer(cmd, r->forceBoundsBuffer, r->forceBoundsBuffer, 1, &copy);
+		force_barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+		vkCmdFillBuffer(cmd, r->forceBoundsBuffer, 6 * sizeof(int32_t), 3 * sizeof(int32_t), (uint32_t)INT32_MAX);
+		vkCmdFillBuffer(cmd, r->forceBoundsBuffer, 9 * sizeof(int32_t), 3 * sizeof(int32_t), (uint32_t)INT32_MIN);
+		force_barrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, shaderRW | transferRW);
+
+		r->forceIteration++;
+	}
+
+	if (r->forceEdgeVertexCount > 0)
+		force_dispatch(r, cmd, &pc, FORCE_STAGE_EDGES, (r->forceEdgeVertexCount + 255) / 256);
+
+	// Draws read the moved instances; read-back maps the nodes after the device is idle
+	force_barrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_HOST_READ_BIT);
+
+	r->forceDirty = true;
+	if (r->forceIteration >= FORCE_LAYOUT_ITERATIONS)
+		r->forceRunning = false;
+}
+
+void renderer_force_read_back(Renderer *r, GraphData *graph)
+{
+	if (!r->forceDirty)
+		return;
+	if (graph->node_count != r->forceNodeCount) {
+		r->forceRunning = false;
+		r->forceDirty = false;
+		return;
+	}
+	vkDeviceWaitIdle(r->device);
+
+	ForceNode *nodes;
+	vkMapMemory(r->device, r->forceNodeBufferMemory, 0, VK_WHOLE_SIZE, 0, (void **)&nodes);
+	bool has_z = igraph_matrix_ncol(&graph->current_layout) > 2;
+	for (uint32_t i = 0; i < graph->node_count; i++) {
+		glm_vec3_copy(nodes[i].position, graph->nodes[i].position);
+		MATRIX(graph->current_layout, i, 0) = nodes[i].position[0];
+		MATRIX(graph->current_layout, i, 1) = nodes[i].position[1];
+		if (has_z)
+			MATRIX(graph->current_layout, i, 2) = nodes[i].position[2];
+	}
+	vkUnmapMemory(r->device, r->forceNodeBufferMemory);
+	r->forceDirty = false;
+}
+
+void renderer_force_stop(Renderer *r, GraphData *graph)
+{
+	renderer_force_read_back(r, graph);
+	r->forceRunning = false;
+}
+
+void renderer_force_cleanup(Renderer *r)
+{
+	destroy_run_buffers(r);
+	destroy_pipeline(r);
+	free(r->nodeInstanceSlots);
+	free(r->edgeVertexNodes);
+	r->nodeInstanceSlots = NULL;
+	r->edgeVertexNodes = NULL;
+}
@@ -1,10 +1,14 @@
 #include "vulkan/renderer_geometry.h"
 #include "vulkan/renderer_compute.h"
+#include "vulkan/renderer_density.h"
+#include "vulkan/renderer_edge_lod.h"
+#include "vulkan/renderer_force.h"
 
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include "graph/graph_aggregate.h"
 #include "interaction/camera.h"
 #include "interaction/state.h"
 #include "vulkan/text.h"
@@ -12,9 +16,110 @@
 
 extern FontAtlas globalAtlas;
 
+// Deterministic LOD bucket from the endpoints, so it is stable across relayouts
+static uint8_t edge_lod_bucket(const Edge *e)
+{
+	// Selected and animating edges always fall in the first (always drawn) bucket
+	if (e->selected > 0.5f || e->is_animating)
+		return 0;
+	uint32_t lo = e->from < e->to ? e->from : e->to;
+	uint32_t hi = e->from < e->to ? e->to : e->from;
+	uint64_t h = ((uint64_t)lo << 32) | hi;
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return (uint8_t)(h & (EDGE_LOD_BUCKETS - 1));
+}
+
+// Rebuild the semantic zoom buffers from the graph's cached community aggregate
+static void renderer_update_aggregate(Renderer *r, GraphData *graph)
+{
+	if (r->aggregateNodeBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->aggregateNodeBuffer, NULL);
+		vkFreeMemory(r->device, r->aggregateNodeBufferMemory, NULL);
+		r->aggregateNodeBuffer = VK_NULL_HANDLE;
+	}
+	if (r->aggregateEdgeBuffer != VK_NULL_HANDLE) {
+		vkDestroyBuffer(r->device, r->aggregateEdgeBuffer, NULL);
+		vkFreeMemory(r->device, r->aggregateEdgeBufferMemory, NULL);
+		r->aggregateEdgeBuffer = VK_NULL_HANDLE;
+	}
+	r->aggregateNodeCount = 0;
+	r->aggregateEdgeVertexCount = 0;
+
+	// Bounding sphere of the layout, used for the zoom-dependent cross-fade
+	glm_vec3_zero(r->graphCenter);
+	r->graphRadius = 0.0f;
+	for (uint32_t i = 0; i < graph->node_count; i++)
+		glm_vec3_add(r->graphCenter, graph->nodes[i].position, r->graphCenter);
+	if (graph->node_count > 0)
+		glm_vec3_scale(r->graphCenter, r->layoutScale / (float)graph->node_count, r->graphCenter);
+	for (uint32_t i = 0; i < graph->node_count; i++) {
+		vec3 p;
+		glm_vec3_scale(graph->nodes[i].position, r->layoutScale, p);
+		float d = glm_vec3_distance(p, r->graphCenter);
+		if (d > r->graphRadius)
+			r->graphRadius = d;
+	}
+
+	// Centroids follow the layout; the quotient topology is cached per membership result
+	CommunityAggregate *agg = graph->aggregate;
+	if (!graph_aggregate_update(agg, graph) || agg->community_count == 0)
+		return;
+
+	int maxPopulation = 1;
+	for (int c = 0; c < agg->community_count; c++)
+		if (agg->population[c] > maxPopulation)
+			maxPopulation = agg->population[c];
+
+	Node *metaNodes = malloc(sizeof(Node) * agg->community_count);
+	uint32_t n = 0;
+	for (int c = 0; c < agg->community_count; c++) {
+		if (agg->population[c] == 0)
+			continue;
+		Node *mn = &metaNodes[n++];
+		memset(mn, 0, sizeof(Node));
+		glm_vec3_scale(agg->centroids[c], r->layoutScale, mn->position);
+		glm_vec3_copy(agg->colors[c], mn->color);
+		// Area grows with population; never smaller than a regular node
+		mn->size = fmaxf(1.0f, 2.0f * agg->spread[c] * r->layoutScale * sqrtf((float)agg->population[c] / (float)maxPopulation));
+		mn->degree = 12;
+		mn->glow = 0.5f;
+	}
+	r->aggregateNodeCount = n;
+	createBuffer(r->device, r->physicalDevice, sizeof(Node) * n, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->aggregateNodeBuffer, &r->aggregateNodeBufferMemory);
+	updateBuffer(r->device, r->aggregateNodeBufferMemory, sizeof(Node) * n, metaNodes);
+	free(metaNodes);
+
+	if (agg->meta_edge_count == 0)
+		return;
+	r->aggregateEdgeVertexCount = agg->meta_edge_count * 2;
+	EdgeVertex *evs = calloc(r->aggregateEdgeVertexCount, sizeof(EdgeVertex));
+	for (int e = 0; e < agg->meta_edge_count; e++) {
+		const MetaEdge *me = &agg->meta_edges[e];
+		// Edge brightness encodes the number of merged inter-community edges
+		float weight = sqrtf((float)me->weight / (float)agg->max_meta_weight);
+		int ends[2] = {me->from, me->to};
+		for (int k = 0; k < 2; k++) {
+			EdgeVertex *ev = &evs[e * 2 + k];
+			glm_vec3_scale(agg->centroids[ends[k]], r->layoutScale, ev->pos);
+			glm_vec3_copy(agg->colors[ends[k]], ev->color);
+			ev->size = weight;
+			ev->normalized_pos = (float)k;
+		}
+	}
+	createBuffer(r->device, r->physicalDevice, sizeof(EdgeVertex) * r->aggregateEdgeVertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->aggregateEdgeBuffer, &r->aggregateEdgeBufferMemory);
+	updateBuffer(r->device, r->aggregateEdgeBufferMemory, sizeof(EdgeVertex) * r->aggregateEdgeVertexCount, evs);
+	free(evs);
+}
+
 void renderer_update_graph(Renderer *r, GraphData *graph)
 {
 	vkDeviceWaitIdle(r->device);
+	// A running GPU layout is ahead of the graph; rebuild from its positions
+	renderer_force_read_back(r, graph);
 	r->nodeCount = graph->node_count;
 	r->edgeCount = graph->edge_count;
 	if (r->instanceBuffer != VK_NULL_HANDLE) {
@@ -28,35 +133,19 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 			vkFreeMemory(r->device, r->labelInstanceBufferMemory, NULL);
 			r->labelInstanceBuffer = VK_NULL_HANDLE;
 		}
-		if (r->sphereVertexBuffer != VK_NULL_HANDLE) {
-			vkDestroyBuffer(r->device, r->sphereVertexBuffer, NULL);
-			vkFreeMemory(r->device, r->sphereVertexBufferMemory, NULL);
-			r->sphereVertexBuffer = VK_NULL_HANDLE;
-		}
-		if (r->sphereIndexBuffer != VK_NULL_HANDLE) {
-			vkDestroyBuffer(r->device, r->sphereIndexBuffer, NULL);
-			vkFreeMemory(r->device, r->sphereIndexBufferMemory, NULL);
-			r->sphereIndexBuffer = VK_NULL_HANDLE;
-		}
-		if (r->sphereIndexCounts) {
-			free(r->sphereIndexCounts);
-			r->sphereIndexCounts = NULL;
-		}
-		if (r->sphereIndexOffsets) {
-			free(r->sphereIndexOffsets);
-			r->sphereIndexOffsets = NULL;
-		}
 	}
 
-	r->numSpheres = 0;
-
-	createBuffer(r->device, r->physicalDevice, sizeof(Node) * r->nodeCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->instanceBuffer, &r->instanceBufferMemory);
+	// Also a storage buffer so the density overview can splat straight from it
+	createBuffer(r->device, r->physicalDevice, sizeof(Node) * r->nodeCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->instanceBuffer, &r->instanceBufferMemory);
+	renderer_density_bind_nodes(r);
 
 	int segments = (r->currentRoutingMode == ROUTING_MODE_STRAIGHT) ? 1 : 15;
 	r->edgeVertexCount = graph->edge_count * segments * 2;
-	createBuffer(r->device, r->physicalDevice, sizeof(EdgeVertex) * r->edgeVertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->edgeVertexBuffer, &r->edgeVertexBufferMemory);
+	// Storage too, so the GPU layout can move straight edges in place
+	createBuffer(r->device, r->physicalDevice, sizeof(EdgeVertex) * r->edgeVertexCount, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->edgeVertexBuffer, &r->edgeVertexBufferMemory);
 
 	Node *sorted = malloc(sizeof(Node) * graph->node_count);
+	r->nodeInstanceSlots = realloc(r->nodeInstanceSlots, sizeof(uint32_t) * (graph->node_count + 1));
 	uint32_t currentOffset = 0;
 	for (int t = 0; t < PLATONIC_COUNT; t++) {
 		r->platonicDrawCalls[t].firstInstance = currentOffset;
@@ -76,6 +165,7 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 				pt = PLATONIC_ICOSAHEDRON;
 			if (pt == (PlatonicType)t) {
 				sorted[currentOffset + count] = graph->nodes[i];
+				r->nodeInstanceSlots[i] = currentOffset + count;
 				glm_vec3_scale(sorted[currentOffset + count].position, r->layoutScale, sorted[currentOffset + count].position);
 				if (sorted[currentOffset + count].size < 0.1f)
 					sorted[currentOffset + count].size = 0.1f;
@@ -88,6 +178,20 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 	updateBuffer(r->device, r->instanceBufferMemory, sizeof(Node) * graph->node_count, sorted);
 	EdgeVertex *evs = malloc(sizeof(EdgeVertex) * r->edgeVertexCount);
 	uint32_t idx = 0;
+
+	// Emit edges grouped by hashed LOD bucket so a bucket prefix is a uniform random subset
+	uint32_t *edgeOrder = malloc(sizeof(uint32_t) * (graph->edge_count + 1));
+	uint8_t *edgeBucket = malloc(graph->edge_count + 1);
+	uint32_t bucketStart[EDGE_LOD_BUCKETS + 1] = {0};
+	for (uint32_t i = 0; i < graph->edge_count; i++) {
+		edgeBucket[i] = edge_lod_bucket(&graph->edges[i]);
+		bucketStart[edgeBucket[i] + 1]++;
+	}
+	for (int b = 0; b < EDGE_LOD_BUCKETS; b++)
+		bucketStart[b + 1] += bucketStart[b];
+	for (uint32_t i = 0; i < graph->edge_count; i++)
+		edgeOrder[bucketStart[edgeBucket[i]]++] = i;
+	uint32_t nextBucket = 0;
 	// Dispatch edge routing compute shader if needed
 	CompEdge *cEdges = NULL;
 	if (r->currentRoutingMode != ROUTING_MODE_STRAIGHT) {
@@ -96,7 +200,10 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 	}
 
 	if (cEdges) {
-		for (uint32_t i = 0; i < graph->edge_count; i++) {
+		for (uint32_t k = 0; k < graph->edge_count; k++) {
+			uint32_t i = edgeOrder[k];
+			while (nextBucket <= edgeBucket[i])
+				r->edgeLodVertexOffsets[nextBucket++] = idx;
 			// CLAMP PATH LENGTH to prevent Heap Buffer Overflows!
 			int pLen = cEdges[i].pathLength;
 			if (pLen < 0)
@@ -159,7 +266,13 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 		}
 		free(cEdges);
 	} else {
-		for (uint32_t i = 0; i < graph->edge_count; i++) {
+		r->edgeVertexNodes = realloc(r->edgeVertexNodes, sizeof(uint32_t) * (r->edgeVertexCount + 1));
+		for (uint32_t k = 0; k < graph->edge_count; k++) {
+			uint32_t i = edgeOrder[k];
+			while (nextBucket <= edgeBucket[i])
+				r->edgeLodVertexOffsets[nextBucket++] = idx;
+			r->edgeVertexNodes[idx] = graph->edges[i].from;
+			r->edgeVertexNodes[idx + 1] = graph->edges[i].to;
 			vec3 p1, p2;
 			glm_vec3_scale(graph->nodes[graph->edges[i].from].position, r->layoutScale, p1);
 			glm_vec3_scale(graph->nodes[graph->edges[i].to].position, r->layoutScale, p2);
@@ -185,12 +298,19 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 	}
 
 	r->edgeVertexCount = idx;
+	r->forceEdgeVertexCount = r->currentRoutingMode == ROUTING_MODE_STRAIGHT ? idx : 0;
+	while (nextBucket <= EDGE_LOD_BUCKETS)
+		r->edgeLodVertexOffsets[nextBucket++] = idx;
+	free(edgeOrder);
+	free(edgeBucket);
 
 	// PREVENT 0-byte memory maps which crash Vulkan
 	if (r->edgeVertexCount > 0) {
 		updateBuffer(r->device, r->edgeVertexBufferMemory, sizeof(EdgeVertex) * r->edgeVertexCount, evs);
 	}
 	free(evs);
+	renderer_edge_lod_invalidate(r);
+	renderer_force_bind_geometry(r);
 
 	uint32_t tc = 0;
 	for (uint32_t i = 0; i < r->nodeCount; i++)
@@ -241,6 +361,51 @@ void renderer_update_graph(Renderer *r, GraphData *graph)
 		r->labelInstanceBuffer = VK_NULL_HANDLE;
 	}
 	free(sorted);
+
+	renderer_update_aggregate(r, graph);
+}
+
+static int compare_sphere_radius(const void *a, const void *b)
+{
+	float ra = ((const SphereInstance *)a)->radius;
+	float rb = ((const SphereInstance *)b)->radius;
+	return (ra > rb) - (ra < rb);
+}
+
+void renderer_update_spheres(Renderer *r, const vec3 center, const float *radii, uint32_t count)
+{
+	r->numSpheres = 0;
+	if (count == 0 || !radii)
+		return;
+
+	// Frames in flight may still read the instance buffer
+	vkDeviceWaitIdle(r->device);
+
+	// The instance buffer only grows; the shared icosphere mesh is never rebuilt
+	if (count > r->sphereInstanceCapacity) {
+		if (r->sphereInstanceBuffer != VK_NULL_HANDLE) {
+			vkDestroyBuffer(r->device, r->sphereInstanceBuffer, NULL);
+			vkFreeMemory(r->device, r->sphereInstanceBufferMemory, NULL);
+		}
+		createBuffer(r->device, r->physicalDevice, sizeof(SphereInstance) * count, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &r->sphereInstanceBuffer, &r->sphereInstanceBufferMemory);
+		r->sphereInstances = realloc(r->sphereInstances, sizeof(SphereInstance) * count);
+		r->sphereInstanceCapacity = count;
+	}
+
+	float alpha = 0.2f / (float)count; // Scale transparency with the number of shells
+	if (alpha < 0.02f)
+		alpha = 0.02f;
+
+	for (uint32_t s = 0; s < count; s++) {
+		glm_vec3_copy((float *)center, r->sphereInstances[s].center);
+		r->sphereInstances[s].radius = radii[s];
+		r->sphereInstances[s].alpha = alpha;
+	}
+	// Sorted by radius so LOD selection yields contiguous instance ranges
+	qsort(r->sphereInstances, count, sizeof(SphereInstance), compare_sphere_radius);
+
+	updateBuffer(r->device, r->sphereInstanceBufferMemory, sizeof(SphereInstance) * count, r->sphereInstances);
+	r->numSpheres = count;
 }
 
 void renderer_update_numeric_widget(Renderer *r, NumericInputWidget *widget, Camera *cam)
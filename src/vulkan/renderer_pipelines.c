@@ -56,9 +56,9 @@ int renderer_create_pipelines(Renderer *r)
 	create_shader_module(r->device, SPHERE_VERT_SHADER_PATH, &svMod);
 	create_shader_module(r->device, SPHERE_FRAG_SHADER_PATH, &sfMod);
 	VkPipelineShaderStageCreateInfo sstages[] = {{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_VERTEX_BIT, svMod, "main", NULL}, {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_FRAGMENT_BIT, sfMod, "main", NULL}};
-	VkVertexInputBindingDescription sb[] = {{0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX}};
-	VkVertexInputAttributeDescription sa[] = {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}, {1, 0, VK_FORMAT_R32G32B32_SFLOAT, 12}, {2, 0, VK_FORMAT_R32G32_SFLOAT, 24}};
-	VkPipelineVertexInputStateCreateInfo svi = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, .vertexBindingDescriptionCount = 1, .pVertexBindingDescriptions = sb, .vertexAttributeDescriptionCount = 3, .pVertexAttributeDescriptions = sa};
+	VkVertexInputBindingDescription sb[] = {{0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX}, {1, sizeof(SphereInstance), VK_VERTEX_INPUT_RATE_INSTANCE}};
+	VkVertexInputAttributeDescription sa[] = {{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0}, {1, 0, VK_FORMAT_R32G32B32_SFLOAT, 12}, {2, 0, VK_FORMAT_R32G32_SFLOAT, 24}, {3, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetof(SphereInstance, center)}, {4, 1, VK_FORMAT_R32_SFLOAT, offsetof(SphereInstance, radius)}, {5, 1, VK_FORMAT_R32_SFLOAT, offsetof(SphereInstance, alpha)}};
+	VkPipelineVertexInputStateCreateInfo svi = {.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, .vertexBindingDescriptionCount = 2, .pVertexBindingDescriptions = sb, .vertexAttributeDescriptionCount = 6, .pVertexAttributeDescriptions = sa};
 
 	// Transparent blending
 	VkPipelineColorBlendAttachmentState colB_trans = {.colorWriteMask = 0xF, .blendEnable = VK_TRUE, .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA, .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA, .colorBlendOp = VK_BLEND_OP_ADD, .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE, .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO, .alphaBlendOp = VK_BLEND_OP_ADD};
@@ -83,6 +83,15 @@ int renderer_create_pipelines(Renderer *r)
 	VkGraphicsPipelineCreateInfo epInfo = {.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, .stageCount = 2, .pStages = estages, .pVertexInputState = &evi, .pInputAssemblyState = &eia, .pViewportState = &vpS, .pRasterizationState = &ras, .pMultisampleState = &mul, .pColorBlendState = &colS, .layout = r->pipelineLayout, .renderPass = r->renderPass};
 	vkCreateGraphicsPipelines(r->device, VK_NULL_HANDLE, 1, &epInfo, NULL, &r->edgePipeline);
 
+	// Edge LOD accumulation: alpha accumulates as well, so the offscreen image holds premultiplied
+	// color (its render pass is compatible with the main one, same format and sample count)
+	VkPipelineColorBlendAttachmentState accumB = colB;
+	accumB.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	VkPipelineColorBlendStateCreateInfo accumS = {.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, .attachmentCount = 1, .pAttachments = &accumB};
+	VkGraphicsPipelineCreateInfo eapInfo = epInfo;
+	eapInfo.pColorBlendState = &accumS;
+	vkCreateGraphicsPipelines(r->device, VK_NULL_HANDLE, 1, &eapInfo, NULL, &r->edgeAccumPipeline);
+
 	VkPipelineInputAssemblyStateCreateInfo lias = {.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP};
 	VkPipelineShaderStageCreateInfo lstages[] = {{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_VERTEX_BIT, lVMod, "main", NULL}, {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, NULL, 0, VK_SHADER_STAGE_FRAGMENT_BIT, lfMod, "main", NULL}};
 	VkVertexInputBindingDescription lb[] = {{0, sizeof(LabelVertex), VK_VERTEX_INPUT_RATE_VERTEX}, {1, sizeof(LabelInstance), VK_VERTEX_INPUT_RATE_INSTANCE}};